@@ -0,0 +1,105 @@
+#!/usr/bin/python3
+
+'''
+  Compares google-benchmark JSON output of ISAP benchmark suite against a
+  previously stored baseline file, flagging benchmarks which got slower than
+  allowed threshold. Exits with non-zero status when some regression is found,
+  so that it can be used in CI.
+
+  Generate JSON output using `make benchmark_json` and store a baseline using
+  `make benchmark_baseline`, then compare using `make benchmark_compare`.
+
+  Author: Anjan Roy <hello@itzmeanjan.in>
+
+  Project: https://github.com/itzmeanjan/isap
+'''
+
+import argparse
+import json
+import sys
+from typing import Dict
+
+# Multiplier for converting each time unit to nanoseconds
+TIME_UNITS: Dict[str, float] = {'ns': 1., 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+
+def load(path: str, metric: str) -> Dict[str, float]:
+    """
+    Loads google-benchmark JSON output, returning mapping from benchmark name to
+    its measured time ( in nanoseconds ). When benchmarks were run with
+    repetitions, median aggregate is used, otherwise iterations of same
+    benchmark are averaged.
+    """
+    with open(path, 'r') as fd:
+        doc = json.load(fd)
+
+    medians: Dict[str, float] = {}
+    sums: Dict[str, float] = {}
+    cnts: Dict[str, int] = {}
+
+    for bench in doc['benchmarks']:
+        if 'error_occurred' in bench and bench['error_occurred']:
+            continue
+
+        name = bench.get('run_name', bench['name'])
+        val = bench[metric] * TIME_UNITS[bench.get('time_unit', 'ns')]
+
+        if bench.get('run_type', 'iteration') == 'aggregate':
+            if bench.get('aggregate_name') == 'median':
+                medians[name] = val
+            continue
+
+        sums[name] = sums.get(name, 0.) + val
+        cnts[name] = cnts.get(name, 0) + 1
+
+    res = {name: sums[name] / cnts[name] for name in sums}
+    res.update(medians)
+    return res
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(
+        description='Flags ISAP benchmark regressions against a stored baseline')
+    parser.add_argument('baseline', help='baseline google-benchmark JSON file')
+    parser.add_argument('current', help='current google-benchmark JSON file')
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help='tolerated relative slowdown ( default 0.05 i.e. 5%% )')
+    parser.add_argument('--metric', choices=['cpu_time', 'real_time'],
+                        default='cpu_time', help='compared time measurement')
+    args = parser.parse_args()
+
+    base = load(args.baseline, args.metric)
+    curr = load(args.current, args.metric)
+
+    regressions = 0
+    improvements = 0
+
+    print(f"{'Benchmark':<56} {'Baseline (ns)':>15} {'Current (ns)':>15} {'Change':>9}")
+    for name in sorted(curr.keys() & base.keys()):
+        change = (curr[name] - base[name]) / base[name]
+
+        if change > args.threshold:
+            verdict = 'REGRESSED'
+            regressions += 1
+        elif change < -args.threshold:
+            verdict = 'improved'
+            improvements += 1
+        else:
+            continue
+
+        print(f'{name:<56} {base[name]:>15.1f} {curr[name]:>15.1f} {change:>+9.2%} {verdict}')
+
+    for name in sorted(base.keys() - curr.keys()):
+        print(f'{name:<56} missing from current run')
+    for name in sorted(curr.keys() - base.keys()):
+        print(f'{name:<56} missing from baseline')
+
+    print(f'\n{regressions} regression(s), {improvements} improvement(s), '
+          f'out of {len(curr.keys() & base.keys())} compared benchmark(s), '
+          f'with {args.threshold:.0%} threshold')
+
+    return 1 if regressions > 0 else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
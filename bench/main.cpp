@@ -1,80 +1,525 @@
 #include "bench/bench_isap.hpp"
+#include <string>
+#include <vector>
 
-// registering Ascon permutation for benchmark
+// registering Ascon permutation for benchmark, for each # -of rounds used by
+// ISAP-A-128{A}, with default unrolling & with one round per loop iteration
 BENCHMARK(isap_bench::ascon_permutation<1>);
 BENCHMARK(isap_bench::ascon_permutation<6>);
 BENCHMARK(isap_bench::ascon_permutation<12>);
+BENCHMARK(isap_bench::ascon_permutation<6, 1>);
+BENCHMARK(isap_bench::ascon_permutation<12, 1>);
 
-// registering Keccak-p[400] permutation for benchmark
+// registering Ascon permutation on bit-interleaved state for benchmark, for
+// each # -of rounds used by ISAP-A-128{A}
+BENCHMARK(isap_bench::ascon_permutation_bi<1>);
+BENCHMARK(isap_bench::ascon_permutation_bi<6>);
+BENCHMARK(isap_bench::ascon_permutation_bi<12>);
+
+// registering Ascon permutation on two states at once for benchmark, for each
+// # -of rounds used by ISAP-A-128{A}
+BENCHMARK(isap_bench::ascon_permutation_x2<1>);
+BENCHMARK(isap_bench::ascon_permutation_x2<6>);
+BENCHMARK(isap_bench::ascon_permutation_x2<12>);
+
+#if ISAP_ASCON_ASM
+// registering Ascon permutation, written in x86-64 assembly, for benchmark,
+// for each # -of rounds used by ISAP-A-128{A}, both baseline & BMI2 variants
+BENCHMARK(isap_bench::ascon_permutation_asm<1, false>);
+BENCHMARK(isap_bench::ascon_permutation_asm<6, false>);
+BENCHMARK(isap_bench::ascon_permutation_asm<12, false>);
+BENCHMARK(isap_bench::ascon_permutation_asm<1, true>);
+BENCHMARK(isap_bench::ascon_permutation_asm<6, true>);
+BENCHMARK(isap_bench::ascon_permutation_asm<12, true>);
+#endif
+
+// registering Keccak-p[400] permutation for benchmark, for each # -of rounds
+// used by ISAP-K-128{A}, with default unrolling & with one round per loop
+// iteration
 BENCHMARK(isap_bench::keccak_permutation<1>);
 BENCHMARK(isap_bench::keccak_permutation<8>);
 BENCHMARK(isap_bench::keccak_permutation<12>);
 BENCHMARK(isap_bench::keccak_permutation<16>);
 BENCHMARK(isap_bench::keccak_permutation<20>);
+BENCHMARK(isap_bench::keccak_permutation<8, 1>);
+BENCHMARK(isap_bench::keccak_permutation<12, 1>);
+BENCHMARK(isap_bench::keccak_permutation<16, 1>);
+BENCHMARK(isap_bench::keccak_permutation<20, 1>);
+
+// registering both backends of Keccak-p[400] permutation for benchmark, for
+// each # -of rounds used by ISAP-K-128{A}, reference one followed by wide one
+BENCHMARK(isap_bench::keccak_permutation_backend<8, false>);
+BENCHMARK(isap_bench::keccak_permutation_backend<8, true>);
+BENCHMARK(isap_bench::keccak_permutation_backend<12, false>);
+BENCHMARK(isap_bench::keccak_permutation_backend<12, true>);
+BENCHMARK(isap_bench::keccak_permutation_backend<16, false>);
+BENCHMARK(isap_bench::keccak_permutation_backend<16, true>);
+BENCHMARK(isap_bench::keccak_permutation_backend<20, false>);
+BENCHMARK(isap_bench::keccak_permutation_backend<20, true>);
+
+// registering Keccak-p[400] permutation on eight states at once for benchmark,
+// for each # -of rounds used by ISAP-K-128{A}
+BENCHMARK(isap_bench::keccak_permutation_x8<1>);
+BENCHMARK(isap_bench::keccak_permutation_x8<8>);
+BENCHMARK(isap_bench::keccak_permutation_x8<12>);
+BENCHMARK(isap_bench::keccak_permutation_x8<16>);
+BENCHMARK(isap_bench::keccak_permutation_x8<20>);
+
+// Associated data lengths ( in bytes ), used for benchmarking AEAD routines
+const std::vector<int64_t> DATA_LENS{ 0, 16, 256, 4096 };
+
+// Plain/ cipher text lengths ( in bytes ), used for benchmarking AEAD routines.
+//
+// Short messages ( i.e. <= 18 -bytes, which is rate of ISAP-K-128{A} ) are
+// dominated by rekeying cost, while longer ones show bulk throughput.
+const std::vector<int64_t> MSG_LENS{
+  0,       1,        8,         16,        18,        64,
+  256,     1 << 10,  4 << 10,   16 << 10,  64 << 10,  256 << 10,
+  1 << 20, 4 << 20,  16 << 20
+};
+
+// Message lengths ( in bytes ), used for benchmarking individual phases of
+// AEAD routines, as each phase's cost is linear in input length
+const std::vector<int64_t> PHASE_MSG_LENS{
+  0,       1,        8,         16,        18,        64,
+  256,     1 << 10,  4 << 10,   16 << 10,  64 << 10
+};
+
+// Message length, chunk lengths & # -of threads ( in that order ), used for
+// benchmarking chunked encryption
+const std::vector<int64_t> CHUNKED_MSG_LENS{ 16 << 20 };
+const std::vector<int64_t> CHUNK_LENS{ 16 << 10, 64 << 10, 1 << 20 };
+const std::vector<int64_t> THREAD_CNTS{ 1, 2, 4, 8, 16 };
+
+// Byte range lengths, read out of archive of 16 MiB message
+const std::vector<int64_t> RANGE_LENS{ 64, 4 << 10, 256 << 10 };
+
+// # -of buffers in ring of streaming I/O pipeline
+const std::vector<int64_t> PIPELINE_BUFS{ 3, 8 };
+
+// Payload lengths ( in bytes ) of records, used for benchmarking record layer
+// over UDP loopback
+const std::vector<int64_t> RECORD_LENS{ 64, 256, 512, 1024, 1500 };
+
+// Message length & # -of nonces reserved at once ( in that order ), used for
+// benchmarking encryption with nonces handed out by lock-free sequencer
+const std::vector<int64_t> NONCE_MSG_LENS{ 64 };
+const std::vector<int64_t> NONCE_BLOCKS{ 1, 64, 1 << 16 };
+
+// # -of tenants & capacity of key context cache ( in that order ), used for
+// benchmarking multi-tenant encryption
+const std::vector<int64_t> TENANT_CNTS{ 10000, 50000 };
+const std::vector<int64_t> KEY_CACHE_CAPS{ 4096, 65536 };
+
+// # -of tenants, whose key contexts are kept in memory mapped store
+const std::vector<int64_t> KEY_STORE_CNTS{ 100000 };
+
+// Message length & length of each update, followed by checkpoint ( in that
+// order ), used for benchmarking resumable encryption
+const std::vector<int64_t> RESUMABLE_MSG_LENS{ 1 << 20 };
+const std::vector<int64_t> RESUMABLE_UPDATE_LENS{ 4 << 10, 64 << 10, 1 << 20 };
+
+// Bulk message length, slice length ( 0 => not sliced ) & # -of worker threads
+// ( in that order ), used for benchmarking priority-aware scheduler under mixed
+// load
+const std::vector<int64_t> SCHED_BULK_LENS{ 4 << 20 };
+const std::vector<int64_t> SCHED_SLICE_LENS{ 0, 4 << 10, 16 << 10, 64 << 10 };
+const std::vector<int64_t> SCHED_THREAD_CNTS{ 1, 2 };
+
+// Record lengths & # -of slots in ring ( in that order ), used for benchmarking
+// stage-pipelined encryption of record streams
+const std::vector<int64_t> STREAM_RECORD_LENS{ 256 };
+const std::vector<int64_t> STREAM_SLOTS{ 16, 64 };
+
+// # -of recipients & plain text lengths ( in that order ), used for
+// benchmarking fan-out encryption, where 1, 3 & 9 leave lanes of last group
+// unused
+const std::vector<int64_t> FANOUT_RECIPIENTS{ 1, 3, 8, 9, 64, 256 };
+const std::vector<int64_t> FANOUT_MSG_LENS{ 64, 1024, 16 << 10 };
+
+// Registers encrypt/ decrypt routines of ISAP instance ( chosen by template
+// parameters ) for benchmark, over cartesian product of associated data & plain
+// text lengths, along with verify-only routine, while authenticate-only routine
+// is registered over associated data lengths
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+register_aead(const std::string& name)
+{
+  using namespace isap_bench;
+
+  const std::string enc = "isap_bench::" + name + "_aead_encrypt";
+  const std::string dec = "isap_bench::" + name + "_aead_decrypt";
+  const std::string auth = "isap_bench::" + name + "_aead_authenticate";
+  const std::string ver = "isap_bench::" + name + "_aead_verify";
+
+  benchmark::RegisterBenchmark(enc.c_str(), aead_encrypt<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ DATA_LENS, MSG_LENS });
+  benchmark::RegisterBenchmark(dec.c_str(), aead_decrypt<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ DATA_LENS, MSG_LENS });
+  benchmark::RegisterBenchmark(auth.c_str(),
+                               aead_authenticate<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ DATA_LENS });
+  benchmark::RegisterBenchmark(ver.c_str(), aead_verify<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ DATA_LENS, MSG_LENS });
+}
+
+// Registers individual phases ( i.e. encryption/ authentication rekeying, key
+// stream squeezing, suffix-MAC absorption & finalization ) of ISAP instance (
+// chosen by template parameters ) for benchmark
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+register_phases(const std::string& name)
+{
+  using namespace isap_bench;
+  using isap_common::rk_flag_t;
+
+  const std::string rk_enc = "isap_bench::" + name + "_rekeying_enc";
+  const std::string rk_mac = "isap_bench::" + name + "_rekeying_mac";
+  const std::string ks = "isap_bench::" + name + "_enc_keystream";
+  const std::string absorb = "isap_bench::" + name + "_mac_absorb";
+  const std::string fin = "isap_bench::" + name + "_mac_finalize";
+
+  benchmark::RegisterBenchmark(
+    rk_enc.c_str(), phase_rekeying<p, rk_flag_t::ENC, s_b, s_k, s_e, s_h>);
+  benchmark::RegisterBenchmark(
+    rk_mac.c_str(), phase_rekeying<p, rk_flag_t::MAC, s_b, s_k, s_e, s_h>);
+  benchmark::RegisterBenchmark(ks.c_str(),
+                               phase_enc_keystream<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ PHASE_MSG_LENS });
+  benchmark::RegisterBenchmark(absorb.c_str(),
+                               phase_mac_absorb<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ DATA_LENS, PHASE_MSG_LENS });
+  benchmark::RegisterBenchmark(fin.c_str(),
+                               phase_mac_finalize<p, s_b, s_k, s_e, s_h>);
+}
+
+// Registers chunked encryption of ISAP instance ( chosen by template parameters
+// ) for benchmark, over cartesian product of chunk lengths & # -of threads,
+// along with random-access reads of byte ranges out of archive & streaming I/O
+// pipeline
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+register_chunked(const std::string& name)
+{
+  using namespace isap_bench;
+
+  const std::string enc = "isap_bench::" + name + "_chunked_encrypt";
+  const std::string rng = "isap_bench::" + name + "_archive_read_range";
+  const std::string pipe = "isap_bench::" + name + "_pipeline_encrypt";
+
+  benchmark::RegisterBenchmark(enc.c_str(),
+                               chunked_encrypt<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ CHUNKED_MSG_LENS, CHUNK_LENS, THREAD_CNTS })
+    ->UseRealTime();
+  benchmark::RegisterBenchmark(rng.c_str(),
+                               archive_read_range<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ CHUNKED_MSG_LENS, CHUNK_LENS, RANGE_LENS });
+  benchmark::RegisterBenchmark(pipe.c_str(),
+                               pipeline_encrypt<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ CHUNKED_MSG_LENS, CHUNK_LENS, PIPELINE_BUFS })
+    ->UseRealTime();
+}
+
+// Registers zero-copy record layer of ISAP instance ( chosen by template
+// parameters ) for benchmark, over UDP loopback
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+register_record(const std::string& name)
+{
+  using namespace isap_bench;
+
+  const std::string rec = "isap_bench::" + name + "_record_udp_loopback";
+
+  benchmark::RegisterBenchmark(rec.c_str(),
+                               record_udp_loopback<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ RECORD_LENS });
+}
+
+// Registers encryption of ISAP instance ( chosen by template parameters ) for
+// benchmark, with nonces handed out by lock-free sequencer & by mutex guarded
+// counter, over varying # -of threads
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+register_nonce(const std::string& name)
+{
+  using namespace isap_bench;
+
+  const std::string seq = "isap_bench::" + name + "_nonce_sequencer_encrypt";
+  const std::string mtx = "isap_bench::" + name + "_nonce_mutex_encrypt";
 
-// registering ISAP-A-128A encrypt/ decrypt routines for benchmark
-BENCHMARK(isap_bench::isap_a_128a_aead_encrypt)->Args({ 32, 64 });
-BENCHMARK(isap_bench::isap_a_128a_aead_decrypt)->Args({ 32, 64 });
-BENCHMARK(isap_bench::isap_a_128a_aead_encrypt)->Args({ 32, 128 });
-BENCHMARK(isap_bench::isap_a_128a_aead_decrypt)->Args({ 32, 128 });
-BENCHMARK(isap_bench::isap_a_128a_aead_encrypt)->Args({ 32, 256 });
-BENCHMARK(isap_bench::isap_a_128a_aead_decrypt)->Args({ 32, 256 });
-BENCHMARK(isap_bench::isap_a_128a_aead_encrypt)->Args({ 32, 512 });
-BENCHMARK(isap_bench::isap_a_128a_aead_decrypt)->Args({ 32, 512 });
-BENCHMARK(isap_bench::isap_a_128a_aead_encrypt)->Args({ 32, 1024 });
-BENCHMARK(isap_bench::isap_a_128a_aead_decrypt)->Args({ 32, 1024 });
-BENCHMARK(isap_bench::isap_a_128a_aead_encrypt)->Args({ 32, 2048 });
-BENCHMARK(isap_bench::isap_a_128a_aead_decrypt)->Args({ 32, 2048 });
-BENCHMARK(isap_bench::isap_a_128a_aead_encrypt)->Args({ 32, 4096 });
-BENCHMARK(isap_bench::isap_a_128a_aead_decrypt)->Args({ 32, 4096 });
-
-// registering ISAP-A-128 encrypt/ decrypt routines for benchmark
-BENCHMARK(isap_bench::isap_a_128_aead_encrypt)->Args({ 32, 64 });
-BENCHMARK(isap_bench::isap_a_128_aead_decrypt)->Args({ 32, 64 });
-BENCHMARK(isap_bench::isap_a_128_aead_encrypt)->Args({ 32, 128 });
-BENCHMARK(isap_bench::isap_a_128_aead_decrypt)->Args({ 32, 128 });
-BENCHMARK(isap_bench::isap_a_128_aead_encrypt)->Args({ 32, 256 });
-BENCHMARK(isap_bench::isap_a_128_aead_decrypt)->Args({ 32, 256 });
-BENCHMARK(isap_bench::isap_a_128_aead_encrypt)->Args({ 32, 512 });
-BENCHMARK(isap_bench::isap_a_128_aead_decrypt)->Args({ 32, 512 });
-BENCHMARK(isap_bench::isap_a_128_aead_encrypt)->Args({ 32, 1024 });
-BENCHMARK(isap_bench::isap_a_128_aead_decrypt)->Args({ 32, 1024 });
-BENCHMARK(isap_bench::isap_a_128_aead_encrypt)->Args({ 32, 2048 });
-BENCHMARK(isap_bench::isap_a_128_aead_decrypt)->Args({ 32, 2048 });
-BENCHMARK(isap_bench::isap_a_128_aead_encrypt)->Args({ 32, 4096 });
-BENCHMARK(isap_bench::isap_a_128_aead_decrypt)->Args({ 32, 4096 });
-
-// registering ISAP-K-128A encrypt/ decrypt routines for benchmark
-BENCHMARK(isap_bench::isap_k_128a_aead_encrypt)->Args({ 32, 64 });
-BENCHMARK(isap_bench::isap_k_128a_aead_decrypt)->Args({ 32, 64 });
-BENCHMARK(isap_bench::isap_k_128a_aead_encrypt)->Args({ 32, 128 });
-BENCHMARK(isap_bench::isap_k_128a_aead_decrypt)->Args({ 32, 128 });
-BENCHMARK(isap_bench::isap_k_128a_aead_encrypt)->Args({ 32, 256 });
-BENCHMARK(isap_bench::isap_k_128a_aead_decrypt)->Args({ 32, 256 });
-BENCHMARK(isap_bench::isap_k_128a_aead_encrypt)->Args({ 32, 512 });
-BENCHMARK(isap_bench::isap_k_128a_aead_decrypt)->Args({ 32, 512 });
-BENCHMARK(isap_bench::isap_k_128a_aead_encrypt)->Args({ 32, 1024 });
-BENCHMARK(isap_bench::isap_k_128a_aead_decrypt)->Args({ 32, 1024 });
-BENCHMARK(isap_bench::isap_k_128a_aead_encrypt)->Args({ 32, 2048 });
-BENCHMARK(isap_bench::isap_k_128a_aead_decrypt)->Args({ 32, 2048 });
-BENCHMARK(isap_bench::isap_k_128a_aead_encrypt)->Args({ 32, 4096 });
-BENCHMARK(isap_bench::isap_k_128a_aead_decrypt)->Args({ 32, 4096 });
-
-// registering ISAP-K-128 encrypt/ decrypt routines for benchmark
-BENCHMARK(isap_bench::isap_k_128_aead_encrypt)->Args({ 32, 64 });
-BENCHMARK(isap_bench::isap_k_128_aead_decrypt)->Args({ 32, 64 });
-BENCHMARK(isap_bench::isap_k_128_aead_encrypt)->Args({ 32, 128 });
-BENCHMARK(isap_bench::isap_k_128_aead_decrypt)->Args({ 32, 128 });
-BENCHMARK(isap_bench::isap_k_128_aead_encrypt)->Args({ 32, 256 });
-BENCHMARK(isap_bench::isap_k_128_aead_decrypt)->Args({ 32, 256 });
-BENCHMARK(isap_bench::isap_k_128_aead_encrypt)->Args({ 32, 512 });
-BENCHMARK(isap_bench::isap_k_128_aead_decrypt)->Args({ 32, 512 });
-BENCHMARK(isap_bench::isap_k_128_aead_encrypt)->Args({ 32, 1024 });
-BENCHMARK(isap_bench::isap_k_128_aead_decrypt)->Args({ 32, 1024 });
-BENCHMARK(isap_bench::isap_k_128_aead_encrypt)->Args({ 32, 2048 });
-BENCHMARK(isap_bench::isap_k_128_aead_decrypt)->Args({ 32, 2048 });
-BENCHMARK(isap_bench::isap_k_128_aead_encrypt)->Args({ 32, 4096 });
-BENCHMARK(isap_bench::isap_k_128_aead_decrypt)->Args({ 32, 4096 });
+  for (const int64_t t : THREAD_CNTS) {
+    benchmark::RegisterBenchmark(seq.c_str(),
+                                 nonce_sequencer_encrypt<p, s_b, s_k, s_e, s_h>)
+      ->ArgsProduct({ NONCE_MSG_LENS, NONCE_BLOCKS })
+      ->Threads(static_cast<int>(t))
+      ->UseRealTime();
+    benchmark::RegisterBenchmark(mtx.c_str(),
+                                 nonce_mutex_encrypt<p, s_b, s_k, s_e, s_h>)
+      ->ArgsProduct({ NONCE_MSG_LENS })
+      ->Threads(static_cast<int>(t))
+      ->UseRealTime();
+  }
+}
+
+// Registers multi-tenant encryption of ISAP instance ( chosen by template
+// parameters ) for benchmark, with key contexts looked up in lock-free cache,
+// in mutex guarded map & derived for each message, over varying # -of threads
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+register_key_cache(const std::string& name)
+{
+  using namespace isap_bench;
+
+  const std::string cache = "isap_bench::" + name + "_key_cache_encrypt";
+  const std::string mtx = "isap_bench::" + name + "_key_mutex_map_encrypt";
+  const std::string drv = "isap_bench::" + name + "_key_derive_encrypt";
+
+  for (const int64_t t : THREAD_CNTS) {
+    benchmark::RegisterBenchmark(cache.c_str(),
+                                 key_cache_encrypt<p, s_b, s_k, s_e, s_h>)
+      ->ArgsProduct({ TENANT_CNTS, KEY_CACHE_CAPS })
+      ->Threads(static_cast<int>(t))
+      ->UseRealTime();
+    benchmark::RegisterBenchmark(mtx.c_str(),
+                                 key_mutex_map_encrypt<p, s_b, s_k, s_e, s_h>)
+      ->ArgsProduct({ TENANT_CNTS })
+      ->Threads(static_cast<int>(t))
+      ->UseRealTime();
+    benchmark::RegisterBenchmark(drv.c_str(),
+                                 key_derive_encrypt<p, s_b, s_k, s_e, s_h>)
+      ->ArgsProduct({ TENANT_CNTS })
+      ->Threads(static_cast<int>(t))
+      ->UseRealTime();
+  }
+}
+
+// Registers time-to-first-encrypt of ISAP instance ( chosen by template
+// parameters ) for benchmark, with key contexts kept in memory mapped store &
+// rebuilt from secret keys, along with integrity check of whole store
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+register_key_store(const std::string& name)
+{
+  using namespace isap_bench;
+
+  const std::string store = "isap_bench::" + name + "_key_store_first_encrypt";
+  const std::string rbld = "isap_bench::" + name + "_key_rebuild_first_encrypt";
+  const std::string vrfy = "isap_bench::" + name + "_key_store_verify_all";
+
+  benchmark::RegisterBenchmark(store.c_str(),
+                               key_store_first_encrypt<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ KEY_STORE_CNTS })
+    ->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark(rbld.c_str(),
+                               key_rebuild_first_encrypt<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ KEY_STORE_CNTS })
+    ->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark(vrfy.c_str(),
+                               key_store_verify_all<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ KEY_STORE_CNTS })
+    ->Unit(benchmark::kMicrosecond);
+}
+
+// Registers resumable encryption of ISAP instance ( chosen by template
+// parameters ) for benchmark, checkpointing after each update
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+register_resumable(const std::string& name)
+{
+  using namespace isap_bench;
+
+  const std::string enc = "isap_bench::" + name + "_resumable_encrypt";
+
+  benchmark::RegisterBenchmark(enc.c_str(),
+                               resumable_encrypt<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ RESUMABLE_MSG_LENS, RESUMABLE_UPDATE_LENS });
+}
+
+// Registers priority-aware scheduler of ISAP instance ( chosen by template
+// parameters ) for benchmark, measuring queueing delay of latency-critical
+// messages, without & with bulk load
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+register_scheduler(const std::string& name)
+{
+  using namespace isap_bench;
+
+  const std::string mix = "isap_bench::" + name + "_scheduler_mixed_load";
+
+  benchmark::RegisterBenchmark(mix.c_str(),
+                               scheduler_mixed_load<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ { 0 }, { 0 }, SCHED_THREAD_CNTS })
+    ->ArgsProduct({ SCHED_BULK_LENS, SCHED_SLICE_LENS, SCHED_THREAD_CNTS })
+    ->UseRealTime();
+}
+
+// Registers encryption of record streams of ISAP instance ( chosen by template
+// parameters ) for benchmark, on single thread, over a pool of threads & over
+// stage-pipelined threads
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+register_stream(const std::string& name)
+{
+  using namespace isap_bench;
+
+  const std::string one = "isap_bench::" + name + "_stream_single_thread";
+  const std::string pool = "isap_bench::" + name + "_stream_pool";
+  const std::string stg = "isap_bench::" + name + "_stream_stage_pipeline";
+
+  benchmark::RegisterBenchmark(one.c_str(),
+                               stream_single_thread<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ STREAM_RECORD_LENS });
+  benchmark::RegisterBenchmark(pool.c_str(), stream_pool<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ STREAM_RECORD_LENS, THREAD_CNTS })
+    ->UseRealTime();
+  benchmark::RegisterBenchmark(stg.c_str(),
+                               stream_stage_pipeline<p, s_b, s_k, s_e, s_h>)
+    ->ArgsProduct({ STREAM_RECORD_LENS, STREAM_SLOTS })
+    ->UseRealTime();
+}
+
+// Registers fan-out encryption of ISAP instance ( chosen by template parameters
+// ) for benchmark, along with a loop of single encryptions, as baseline
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+register_fanout(const std::string& name)
+{
+  using namespace isap_bench;
+
+  const std::string fan = "isap_bench::" + name + "_fanout_encrypt";
+  const std::string loop = "isap_bench::" + name + "_fanout_loop_encrypt";
+
+  benchmark::RegisterBenchmark(fan.c_str(),
+                               fanout_encrypt<p, s_b, s_k, s_e, s_h, true>)
+    ->ArgsProduct({ FANOUT_RECIPIENTS, FANOUT_MSG_LENS });
+  benchmark::RegisterBenchmark(loop.c_str(),
+                               fanout_encrypt<p, s_b, s_k, s_e, s_h, false>)
+    ->ArgsProduct({ FANOUT_RECIPIENTS, FANOUT_MSG_LENS });
+}
 
 // main function to drive execution of benchmark
-BENCHMARK_MAIN();
+int
+main(int argc, char** argv)
+{
+  using isap_common::perm_t;
+
+  // registering ISAP-{A,K}-128{A} encrypt/ decrypt routines for benchmark
+  register_aead<perm_t::ASCON, 1, 12, 6, 12>("isap_a_128a");
+  register_aead<perm_t::ASCON, 12, 12, 12, 12>("isap_a_128");
+  register_aead<perm_t::KECCAK, 1, 8, 8, 16>("isap_k_128a");
+  register_aead<perm_t::KECCAK, 12, 12, 12, 20>("isap_k_128");
+
+  // registering individual phases of ISAP-{A,K}-128{A} for benchmark
+  register_phases<perm_t::ASCON, 1, 12, 6, 12>("isap_a_128a");
+  register_phases<perm_t::ASCON, 12, 12, 12, 12>("isap_a_128");
+  register_phases<perm_t::KECCAK, 1, 8, 8, 16>("isap_k_128a");
+  register_phases<perm_t::KECCAK, 12, 12, 12, 20>("isap_k_128");
+
+  // registering chunked encryption of ISAP-{A,K}-128{A} for benchmark
+  register_chunked<perm_t::ASCON, 1, 12, 6, 12>("isap_a_128a");
+  register_chunked<perm_t::ASCON, 12, 12, 12, 12>("isap_a_128");
+  register_chunked<perm_t::KECCAK, 1, 8, 8, 16>("isap_k_128a");
+  register_chunked<perm_t::KECCAK, 12, 12, 12, 20>("isap_k_128");
+
+  // registering record layer of ISAP-{A,K}-128{A} for benchmark
+  register_record<perm_t::ASCON, 1, 12, 6, 12>("isap_a_128a");
+  register_record<perm_t::ASCON, 12, 12, 12, 12>("isap_a_128");
+  register_record<perm_t::KECCAK, 1, 8, 8, 16>("isap_k_128a");
+  register_record<perm_t::KECCAK, 12, 12, 12, 20>("isap_k_128");
+
+  // registering encryption with automatic nonces, of ISAP-{A,K}-128{A}
+  register_nonce<perm_t::ASCON, 1, 12, 6, 12>("isap_a_128a");
+  register_nonce<perm_t::ASCON, 12, 12, 12, 12>("isap_a_128");
+  register_nonce<perm_t::KECCAK, 1, 8, 8, 16>("isap_k_128a");
+  register_nonce<perm_t::KECCAK, 12, 12, 12, 20>("isap_k_128");
+
+  // registering multi-tenant encryption of ISAP-{A,K}-128{A}
+  register_key_cache<perm_t::ASCON, 1, 12, 6, 12>("isap_a_128a");
+  register_key_cache<perm_t::ASCON, 12, 12, 12, 12>("isap_a_128");
+  register_key_cache<perm_t::KECCAK, 1, 8, 8, 16>("isap_k_128a");
+  register_key_cache<perm_t::KECCAK, 12, 12, 12, 20>("isap_k_128");
+
+  // registering time-to-first-encrypt of ISAP-{A,K}-128{A}
+  register_key_store<perm_t::ASCON, 1, 12, 6, 12>("isap_a_128a");
+  register_key_store<perm_t::ASCON, 12, 12, 12, 12>("isap_a_128");
+  register_key_store<perm_t::KECCAK, 1, 8, 8, 16>("isap_k_128a");
+  register_key_store<perm_t::KECCAK, 12, 12, 12, 20>("isap_k_128");
+
+  // registering resumable encryption of ISAP-{A,K}-128{A}
+  register_resumable<perm_t::ASCON, 1, 12, 6, 12>("isap_a_128a");
+  register_resumable<perm_t::ASCON, 12, 12, 12, 12>("isap_a_128");
+  register_resumable<perm_t::KECCAK, 1, 8, 8, 16>("isap_k_128a");
+  register_resumable<perm_t::KECCAK, 12, 12, 12, 20>("isap_k_128");
+
+  // registering priority-aware scheduler of ISAP-{A,K}-128{A} for benchmark
+  register_scheduler<perm_t::ASCON, 1, 12, 6, 12>("isap_a_128a");
+  register_scheduler<perm_t::ASCON, 12, 12, 12, 12>("isap_a_128");
+  register_scheduler<perm_t::KECCAK, 1, 8, 8, 16>("isap_k_128a");
+  register_scheduler<perm_t::KECCAK, 12, 12, 12, 20>("isap_k_128");
+
+  // registering record stream encryption of ISAP-{A,K}-128{A} for benchmark
+  register_stream<perm_t::ASCON, 1, 12, 6, 12>("isap_a_128a");
+  register_stream<perm_t::ASCON, 12, 12, 12, 12>("isap_a_128");
+  register_stream<perm_t::KECCAK, 1, 8, 8, 16>("isap_k_128a");
+  register_stream<perm_t::KECCAK, 12, 12, 12, 20>("isap_k_128");
+
+  // registering fan-out encryption of ISAP-{A,K}-128{A} for benchmark
+  register_fanout<perm_t::ASCON, 1, 12, 6, 12>("isap_a_128a");
+  register_fanout<perm_t::ASCON, 12, 12, 12, 12>("isap_a_128");
+  register_fanout<perm_t::KECCAK, 1, 8, 8, 16>("isap_k_128a");
+  register_fanout<perm_t::KECCAK, 12, 12, 12, 20>("isap_k_128");
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  return 0;
+}
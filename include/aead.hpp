@@ -1,5 +1,6 @@
 #pragma once
 #include "common.hpp"
+#include "instrument.hpp"
 
 // ISAP authenticated encryption with associated data ( AEAD )
 namespace isap {
@@ -14,7 +15,10 @@ namespace isap {
 // https://csrc.nist.gov/CSRC/media/Projects/lightweight-cryptography/documents/finalist-round/updated-spec-doc/isap-spec-final.pdf
 //
 // Encryption algorithm follows generic pseudocode described in Algorithm 1, in
-// above linked specification
+// above linked specification.
+//
+// Note, plain text & cipher text may be same buffer ( i.e. encryption can be
+// performed in-place ), but they must not partially overlap.
 template<const isap_common::perm_t p,
          const size_t s_b,
          const size_t s_k,
@@ -25,15 +29,56 @@ encrypt(const uint8_t* const __restrict key,
         const uint8_t* const __restrict nonce,
         const uint8_t* const __restrict data,
         const size_t dlen,
-        const uint8_t* const __restrict msg,
-        uint8_t* const __restrict cipher,
+        const uint8_t* const msg,
+        uint8_t* const cipher,
         const size_t mlen,
         uint8_t* const __restrict tag)
 {
   using namespace isap_common;
 
+  using timer_t = isap_instr::latency_timer_t<isap_instr::op_t::ENCRYPT>;
+  [[maybe_unused]] const timer_t timer{};
+  [[maybe_unused]] constexpr uint32_t vid = variant_id<p, s_b, s_k, s_e, s_h>();
+
+  ISAP_PROBE3(encrypt_entry, vid, dlen, mlen);
+
   enc<p, s_b, s_k, s_e, s_h>(key, nonce, msg, cipher, mlen);
   mac<p, s_b, s_k, s_e, s_h>(key, nonce, data, dlen, cipher, mlen, tag);
+
+  ISAP_PROBE3(encrypt_return, vid, dlen, mlen);
+}
+
+// Same as above, but takes precomputed key context ( see
+// `isap_common::key_context_t` ) in place of 16 -bytes secret key, saving two
+// permutation calls per message, when many messages are encrypted under same
+// secret key
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static void
+encrypt(const isap_common::key_context_t<p, s_b, s_k, s_e, s_h>& ctx,
+        const uint8_t* const __restrict nonce,
+        const uint8_t* const __restrict data,
+        const size_t dlen,
+        const uint8_t* const msg,
+        uint8_t* const cipher,
+        const size_t mlen,
+        uint8_t* const __restrict tag)
+{
+  using namespace isap_common;
+
+  using timer_t = isap_instr::latency_timer_t<isap_instr::op_t::ENCRYPT>;
+  [[maybe_unused]] const timer_t timer{};
+  [[maybe_unused]] constexpr uint32_t vid = variant_id<p, s_b, s_k, s_e, s_h>();
+
+  ISAP_PROBE3(encrypt_entry, vid, dlen, mlen);
+
+  enc<p, s_b, s_k, s_e, s_h>(ctx, nonce, msg, cipher, mlen);
+  mac<p, s_b, s_k, s_e, s_h>(ctx, nonce, data, dlen, cipher, mlen, tag);
+
+  ISAP_PROBE3(encrypt_return, vid, dlen, mlen);
 }
 
 // Given 16 -bytes secret key, 16 -bytes public message nonce, 16 -bytes
@@ -50,7 +95,10 @@ encrypt(const uint8_t* const __restrict key,
 // above linked specification.
 //
 // Note, before consuming decrypted bytes, ensure that boolean verification flag
-// holds truth value.
+// holds truth value. Cipher text & plain text may be same buffer ( i.e.
+// decryption can be performed in-place ), but they must not partially overlap.
+// As cipher text is authenticated before being decrypted, on verification
+// failure, buffer still holds cipher text.
 template<const isap_common::perm_t p,
          const size_t s_b,
          const size_t s_k,
@@ -62,26 +110,305 @@ decrypt(const uint8_t* const __restrict key,
         const uint8_t* const __restrict tag,
         const uint8_t* const __restrict data,
         const size_t dlen,
-        const uint8_t* const __restrict cipher,
-        uint8_t* const __restrict msg,
+        const uint8_t* const cipher,
+        uint8_t* const msg,
         const size_t mlen)
 {
   using namespace isap_common;
+
+  using timer_t = isap_instr::latency_timer_t<isap_instr::op_t::DECRYPT>;
+  [[maybe_unused]] const timer_t timer{};
+  [[maybe_unused]] constexpr uint32_t vid = variant_id<p, s_b, s_k, s_e, s_h>();
   uint8_t tag_[16];
 
+  ISAP_PROBE3(decrypt_entry, vid, dlen, mlen);
+
   mac<p, s_b, s_k, s_e, s_h>(key, nonce, data, dlen, cipher, mlen, tag_);
 
-  bool flg = false;
-  for (size_t i = 0; i < 16; i++) {
-    flg |= static_cast<bool>(tag[i] ^ tag_[i]);
-  }
+  const bool flg = !tag_equal(tag, tag_);
 
   if (flg) {
+    ISAP_PROBE3(verify_fail, vid, dlen, mlen);
+    ISAP_PROBE4(decrypt_return, vid, dlen, mlen, !flg);
     return !flg;
   }
 
   enc<p, s_b, s_k, s_e, s_h>(key, nonce, cipher, msg, mlen);
+
+  ISAP_PROBE4(decrypt_return, vid, dlen, mlen, !flg);
   return !flg;
 }
 
+// Same as above, but takes precomputed key context ( see
+// `isap_common::key_context_t` ) in place of 16 -bytes secret key
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static bool
+decrypt(const isap_common::key_context_t<p, s_b, s_k, s_e, s_h>& ctx,
+        const uint8_t* const __restrict nonce,
+        const uint8_t* const __restrict tag,
+        const uint8_t* const __restrict data,
+        const size_t dlen,
+        const uint8_t* const cipher,
+        uint8_t* const msg,
+        const size_t mlen)
+{
+  using namespace isap_common;
+
+  using timer_t = isap_instr::latency_timer_t<isap_instr::op_t::DECRYPT>;
+  [[maybe_unused]] const timer_t timer{};
+  [[maybe_unused]] constexpr uint32_t vid = variant_id<p, s_b, s_k, s_e, s_h>();
+  uint8_t tag_[16];
+
+  ISAP_PROBE3(decrypt_entry, vid, dlen, mlen);
+
+  mac<p, s_b, s_k, s_e, s_h>(ctx, nonce, data, dlen, cipher, mlen, tag_);
+
+  const bool flg = !tag_equal(tag, tag_);
+
+  if (flg) {
+    ISAP_PROBE3(verify_fail, vid, dlen, mlen);
+    ISAP_PROBE4(decrypt_return, vid, dlen, mlen, !flg);
+    return !flg;
+  }
+
+  enc<p, s_b, s_k, s_e, s_h>(ctx, nonce, cipher, msg, mlen);
+
+  ISAP_PROBE4(decrypt_return, vid, dlen, mlen, !flg);
+  return !flg;
+}
+
+// Given 16 -bytes secret key, 16 -bytes public message nonce & N ( >=0 ) -bytes
+// associated data, this routine computes 16 -bytes authentication tag, without
+// any message to encrypt, using any of four ISAP algorithms, chosen by template
+// parameters.
+//
+// Only suffix-MAC sponge is run, so that encryption rekeying is skipped. Tag is
+// same as what `encrypt` computes for empty plain text, so it can be checked
+// using either `verify` or `decrypt` ( with empty cipher text ). It's timed &
+// traced as an encryption of empty plain text.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static void
+authenticate(const uint8_t* const __restrict key,
+             const uint8_t* const __restrict nonce,
+             const uint8_t* const __restrict data,
+             const size_t dlen,
+             uint8_t* const __restrict tag)
+{
+  using namespace isap_common;
+
+  using timer_t = isap_instr::latency_timer_t<isap_instr::op_t::ENCRYPT>;
+  [[maybe_unused]] const timer_t timer{};
+  [[maybe_unused]] constexpr uint32_t vid = variant_id<p, s_b, s_k, s_e, s_h>();
+
+  ISAP_PROBE3(encrypt_entry, vid, dlen, 0);
+
+  mac<p, s_b, s_k, s_e, s_h>(key, nonce, data, dlen, nullptr, 0, tag);
+
+  ISAP_PROBE3(encrypt_return, vid, dlen, 0);
+}
+
+// Same as above, but takes precomputed key context ( see
+// `isap_common::key_context_t` ) in place of 16 -bytes secret key
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static void
+authenticate(const isap_common::key_context_t<p, s_b, s_k, s_e, s_h>& ctx,
+             const uint8_t* const __restrict nonce,
+             const uint8_t* const __restrict data,
+             const size_t dlen,
+             uint8_t* const __restrict tag)
+{
+  using namespace isap_common;
+
+  using timer_t = isap_instr::latency_timer_t<isap_instr::op_t::ENCRYPT>;
+  [[maybe_unused]] const timer_t timer{};
+  [[maybe_unused]] constexpr uint32_t vid = variant_id<p, s_b, s_k, s_e, s_h>();
+
+  ISAP_PROBE3(encrypt_entry, vid, dlen, 0);
+
+  mac<p, s_b, s_k, s_e, s_h>(ctx, nonce, data, dlen, nullptr, 0, tag);
+
+  ISAP_PROBE3(encrypt_return, vid, dlen, 0);
+}
+
+// Given 16 -bytes secret key, 16 -bytes public message nonce, 16 -bytes
+// authentication tag, N ( >=0 ) -bytes associated data & M ( >=0 ) -bytes
+// cipher text, this routine checks tag, returning boolean truth value only when
+// it's valid, without decrypting cipher text. Tag is compared in constant-time.
+//
+// Only suffix-MAC sponge is run, so that neither encryption rekeying nor key
+// stream squeezing is needed, while no buffer for plain text is needed either.
+// It's timed & traced as a decryption.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static bool
+verify(const uint8_t* const __restrict key,
+       const uint8_t* const __restrict nonce,
+       const uint8_t* const __restrict tag,
+       const uint8_t* const __restrict data,
+       const size_t dlen,
+       const uint8_t* const __restrict cipher,
+       const size_t clen)
+{
+  using namespace isap_common;
+
+  using timer_t = isap_instr::latency_timer_t<isap_instr::op_t::DECRYPT>;
+  [[maybe_unused]] const timer_t timer{};
+  [[maybe_unused]] constexpr uint32_t vid = variant_id<p, s_b, s_k, s_e, s_h>();
+  uint8_t tag_[16];
+
+  ISAP_PROBE3(decrypt_entry, vid, dlen, clen);
+
+  mac<p, s_b, s_k, s_e, s_h>(key, nonce, data, dlen, cipher, clen, tag_);
+
+  const bool flg = tag_equal(tag, tag_);
+  if (!flg) {
+    ISAP_PROBE3(verify_fail, vid, dlen, clen);
+  }
+
+  ISAP_PROBE4(decrypt_return, vid, dlen, clen, flg);
+  return flg;
+}
+
+// Same as above, but takes precomputed key context ( see
+// `isap_common::key_context_t` ) in place of 16 -bytes secret key
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static bool
+verify(const isap_common::key_context_t<p, s_b, s_k, s_e, s_h>& ctx,
+       const uint8_t* const __restrict nonce,
+       const uint8_t* const __restrict tag,
+       const uint8_t* const __restrict data,
+       const size_t dlen,
+       const uint8_t* const __restrict cipher,
+       const size_t clen)
+{
+  using namespace isap_common;
+
+  using timer_t = isap_instr::latency_timer_t<isap_instr::op_t::DECRYPT>;
+  [[maybe_unused]] const timer_t timer{};
+  [[maybe_unused]] constexpr uint32_t vid = variant_id<p, s_b, s_k, s_e, s_h>();
+  uint8_t tag_[16];
+
+  ISAP_PROBE3(decrypt_entry, vid, dlen, clen);
+
+  mac<p, s_b, s_k, s_e, s_h>(ctx, nonce, data, dlen, cipher, clen, tag_);
+
+  const bool flg = tag_equal(tag, tag_);
+  if (!flg) {
+    ISAP_PROBE3(verify_fail, vid, dlen, clen);
+  }
+
+  ISAP_PROBE4(decrypt_return, vid, dlen, clen, flg);
+  return flg;
+}
+
+// Given 16 -bytes secret key, 16 -bytes public message nonce, 16 -bytes
+// authentication tag & N ( >=0 ) -bytes associated data, this routine checks
+// tag computed by `authenticate`, returning boolean truth value only when it's
+// valid. It's same as above, with empty cipher text.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static bool
+verify(const uint8_t* const __restrict key,
+       const uint8_t* const __restrict nonce,
+       const uint8_t* const __restrict tag,
+       const uint8_t* const __restrict data,
+       const size_t dlen)
+{
+  return verify<p, s_b, s_k, s_e, s_h>(key, nonce, tag, data, dlen, nullptr, 0);
+}
+
+// Same as above, but takes precomputed key context ( see
+// `isap_common::key_context_t` ) in place of 16 -bytes secret key
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static bool
+verify(const isap_common::key_context_t<p, s_b, s_k, s_e, s_h>& ctx,
+       const uint8_t* const __restrict nonce,
+       const uint8_t* const __restrict tag,
+       const uint8_t* const __restrict data,
+       const size_t dlen)
+{
+  return verify<p, s_b, s_k, s_e, s_h>(ctx, nonce, tag, data, dlen, nullptr, 0);
+}
+
+// Given 16 -bytes secret key & K ( >=0 ) -many messages, all authenticated
+// under that key, this routine checks tag of each message, without decrypting
+// any of them, writing K boolean verification flags to `flags` & returning #
+// -of messages, which are found to be valid. Messages are laid out flat, so
+// that
+//
+// - i -th nonce is at `nonces[16 * i]`, i -th tag is at `tags[16 * i]`
+// - i -th associated data is next `dlens[i]` -bytes of `data`, starting right
+//   after ( i - 1 ) -th one, same goes for cipher text & `clens[i]`
+//
+// Key context is computed only once for whole batch, while each message is
+// checked using `verify`.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static size_t
+verify_batch(const uint8_t* const __restrict key,
+             const uint8_t* const __restrict nonces,
+             const uint8_t* const __restrict tags,
+             const uint8_t* const __restrict data,
+             const size_t* const __restrict dlens,
+             const uint8_t* const __restrict cipher,
+             const size_t* const __restrict clens,
+             const size_t cnt,
+             bool* const __restrict flags)
+{
+  using namespace isap_common;
+
+  const key_context_t<p, s_b, s_k, s_e, s_h> ctx{ key };
+
+  size_t valid = 0;
+  size_t doff = 0;
+  size_t coff = 0;
+
+  for (size_t i = 0; i < cnt; i++) {
+    const size_t off = i * knt_len;
+
+    flags[i] = verify<p, s_b, s_k, s_e, s_h>(ctx,
+                                             nonces + off,
+                                             tags + off,
+                                             data + doff,
+                                             dlens[i],
+                                             cipher + coff,
+                                             clens[i]);
+    valid += flags[i];
+
+    doff += dlens[i];
+    coff += clens[i];
+  }
+
+  return valid;
+}
+
 }
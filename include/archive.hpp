@@ -0,0 +1,375 @@
+#pragma once
+#include "aead.hpp"
+#include "chunked.hpp"
+#include "common.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// Random-access archive format, built on top of ISAP AEAD, where message is
+// split into chunks, each of which is encrypted independently, while offsets &
+// authentication tags of all chunks are kept in an authenticated footer index.
+// It allows one to decrypt any byte range of message, by authenticating &
+// decrypting only those chunks which cover that range.
+//
+// Archive is laid out as
+//
+// header ( 32 -bytes ) || cipher_0 || ... || cipher_{n-1} || index || trailer
+//
+// where header is same as that of chunked encryption format ( see
+// include/chunked.hpp ), but with different magic bytes, index holds n entries
+// of form
+//
+// plain text offset ( 8 -bytes ) || chunk length ( 4 -bytes ) || tag ( 16
+// -bytes )
+//
+// and trailer is
+//
+// footer tag ( 16 -bytes ) || n ( 8 -bytes ) || magic ( 8 -bytes )
+//
+// All integers are little-endian. Chunk i is encrypted using nonce derived as
+// in chunked encryption format & associated data = header || ( i as 64 -bit
+// integer ). Footer tag authenticates header, index & n ( as associated data of
+// empty message ), using file nonce with most significant bit of first byte
+// flipped, which never collides with any chunk nonce. As chunk tags are part of
+// index, any modification, reordering or truncation of chunks is detected.
+namespace isap_archive {
+
+// Magic bytes, identifying archive format ( version 1 ), in header
+constexpr uint8_t MAGIC[]{ 'I', 'S', 'A', 'P', 'A', 'R', 'C', '1' };
+
+// Magic bytes, identifying archive format ( version 1 ), in trailer
+constexpr uint8_t IDX_MAGIC[]{ 'I', 'S', 'A', 'P', 'I', 'D', 'X', '1' };
+
+// Byte length of header
+constexpr size_t HDR_LEN = isap_chunked::HDR_LEN;
+
+// Byte length of authentication tag
+constexpr size_t TAG_LEN = isap_chunked::TAG_LEN;
+
+// Byte length of each index entry
+constexpr size_t ENTRY_LEN = 8 + 4 + TAG_LEN;
+
+// Byte length of trailer
+constexpr size_t TRAILER_LEN = TAG_LEN + 8 + sizeof(IDX_MAGIC);
+
+// Byte length of associated data, used for authenticating each chunk
+constexpr size_t AD_LEN = HDR_LEN + 8;
+
+// Parsed index entry of a chunk
+struct entry_t
+{
+  uint64_t offset; // offset of chunk in plain text
+  uint32_t len;    // byte length of chunk
+  const uint8_t* tag;
+};
+
+// Given message length & chunk length ( both in bytes ), this routine computes
+// byte length of archive
+static inline constexpr size_t
+archive_len(const size_t mlen, const size_t clen)
+{
+  const size_t cnt = isap_chunked::chunk_count(mlen, clen);
+  return HDR_LEN + mlen + cnt * ENTRY_LEN + TRAILER_LEN;
+}
+
+// Writes N -bytes little-endian integer
+static inline void
+store_le(uint8_t* const bytes, const uint64_t v, const size_t n)
+{
+  for (size_t i = 0; i < n; i++) {
+    bytes[i] = static_cast<uint8_t>(v >> (i << 3));
+  }
+}
+
+// Reads N -bytes little-endian integer
+static inline uint64_t
+load_le(const uint8_t* const bytes, const size_t n)
+{
+  uint64_t v = 0;
+  for (size_t i = 0; i < n; i++) {
+    v |= static_cast<uint64_t>(bytes[i]) << (i << 3);
+  }
+  return v;
+}
+
+// Serializes header, using archive magic bytes
+static inline void
+encode_header(const isap_chunked::header_t& hdr, uint8_t* const bytes)
+{
+  isap_chunked::encode_header(hdr, bytes);
+  std::memcpy(bytes, MAGIC, sizeof(MAGIC));
+}
+
+// Parses header, returning boolean truth value only when well-formed
+static inline bool
+decode_header(const uint8_t* const bytes, isap_chunked::header_t& hdr)
+{
+  uint8_t tmp[HDR_LEN];
+
+  if (std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0) {
+    return false;
+  }
+
+  std::memcpy(tmp, bytes, HDR_LEN);
+  std::memcpy(tmp, isap_chunked::MAGIC, sizeof(isap_chunked::MAGIC));
+  return isap_chunked::decode_header(tmp, hdr);
+}
+
+// Given 16 -bytes file nonce, this routine derives 16 -bytes nonce, used for
+// authenticating footer index
+static inline void
+footer_nonce(const uint8_t* const __restrict nonce,
+             uint8_t* const __restrict fn)
+{
+  std::memcpy(fn, nonce, isap_common::knt_len);
+  fn[0] ^= 0x80;
+}
+
+// Given serialized header & chunk index, this routine prepares 40 -bytes
+// associated data of that chunk
+static inline void
+chunk_ad(const uint8_t* const __restrict hdr,
+         const uint64_t idx,
+         uint8_t* const __restrict ad)
+{
+  std::memcpy(ad, hdr, HDR_LEN);
+  store_le(ad + HDR_LEN, idx, 8);
+}
+
+// Given 16 -bytes secret key, 16 -bytes file nonce, chunk length ( > 0 ) & M (
+// >=0 ) -bytes message, this routine computes `archive_len(M, chunk length)`
+// -bytes archive, using ISAP instance chosen by template parameters,
+// encrypting chunks in parallel over given # -of threads ( 0 => all available
+// cores ).
+//
+// Note, same file nonce must never be reused under same secret key.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static inline void
+encrypt(const uint8_t* const __restrict key,
+        const uint8_t* const __restrict nonce,
+        const uint32_t clen,
+        const uint8_t* const __restrict msg,
+        const size_t mlen,
+        uint8_t* const __restrict out,
+        const size_t nthreads = 0)
+{
+  isap_chunked::header_t hdr{};
+  hdr.variant = isap_common::variant_id<p, s_b, s_k, s_e, s_h>();
+  hdr.chunk_len = clen;
+  std::memcpy(hdr.nonce, nonce, sizeof(hdr.nonce));
+
+  isap_archive::encode_header(hdr, out);
+
+  const size_t cnt = isap_chunked::chunk_count(mlen, clen);
+  uint8_t* const idx = out + HDR_LEN + mlen;
+
+  isap_chunked::parallel_for(cnt, nthreads, [&](const size_t i) {
+    const size_t moff = i * clen;
+    const size_t len = std::min<size_t>(mlen - moff, clen);
+
+    uint8_t cnonce[isap_common::knt_len];
+    uint8_t ad[AD_LEN];
+
+    isap_chunked::chunk_nonce(nonce, i, cnonce);
+    chunk_ad(out, i, ad);
+
+    uint8_t* const ent = idx + i * ENTRY_LEN;
+    store_le(ent, moff, 8);
+    store_le(ent + 8, len, 4);
+
+    const uint8_t* const txt = msg + moff;
+    uint8_t* const enc = out + HDR_LEN + moff;
+
+    isap::encrypt<p, s_b, s_k, s_e, s_h>(
+      key, cnonce, ad, sizeof(ad), txt, enc, len, ent + 12);
+  });
+
+  uint8_t* const trl = idx + cnt * ENTRY_LEN;
+  store_le(trl + TAG_LEN, cnt, 8);
+  std::memcpy(trl + TAG_LEN + 8, IDX_MAGIC, sizeof(IDX_MAGIC));
+
+  uint8_t fnonce[isap_common::knt_len];
+  footer_nonce(nonce, fnonce);
+
+  // footer tag authenticates header || index || n, which aren't contiguous in
+  // archive, so associated data is assembled separately
+  std::vector<uint8_t> fad(HDR_LEN + cnt * ENTRY_LEN + 8);
+  std::memcpy(fad.data(), out, HDR_LEN);
+  std::memcpy(fad.data() + HDR_LEN, idx, cnt * ENTRY_LEN);
+  store_le(fad.data() + HDR_LEN + cnt * ENTRY_LEN, cnt, 8);
+
+  uint8_t empty[2]{};
+  isap::encrypt<p, s_b, s_k, s_e, s_h>(
+    key, fnonce, fad.data(), fad.size(), empty, empty + 1, 0, trl);
+}
+
+// Random-access reader of archive, produced by ISAP instance chosen by template
+// parameters. Once footer index is authenticated ( see `open` ), any byte range
+// of message can be decrypted ( see `read_range` ), by authenticating &
+// decrypting only those chunks, which cover that range.
+//
+// Note, reader doesn't own memory backing archive, which must outlive reader.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+struct reader_t
+{
+  uint8_t key[isap_common::knt_len];
+  isap_chunked::header_t hdr;
+  const uint8_t* arc = nullptr;
+  std::vector<entry_t> index;
+  uint64_t mlen = 0;
+
+  // Given 16 -bytes secret key & N -bytes archive, this routine authenticates
+  // header & footer index, returning boolean truth value only when archive is
+  // well-formed, it was produced by same ISAP instance & footer tag verifies.
+  // It costs a single suffix-MAC over index, independent of message length.
+  bool open(const uint8_t* const __restrict k,
+            const uint8_t* const __restrict in,
+            const size_t ilen)
+  {
+    index.clear();
+    arc = nullptr;
+
+    if (ilen < HDR_LEN + TRAILER_LEN) {
+      return false;
+    }
+    if (!isap_archive::decode_header(in, hdr)) {
+      return false;
+    }
+    if (hdr.variant != isap_common::variant_id<p, s_b, s_k, s_e, s_h>()) {
+      return false;
+    }
+
+    const uint8_t* const trl = in + ilen - TRAILER_LEN;
+    if (std::memcmp(trl + TAG_LEN + 8, IDX_MAGIC, sizeof(IDX_MAGIC)) != 0) {
+      return false;
+    }
+
+    const uint64_t cnt = load_le(trl + TAG_LEN, 8);
+    if (cnt == 0 || cnt > (ilen - HDR_LEN - TRAILER_LEN) / ENTRY_LEN) {
+      return false;
+    }
+
+    const uint8_t* const idx = trl - cnt * ENTRY_LEN;
+    const size_t total = static_cast<size_t>(idx - (in + HDR_LEN));
+
+    std::vector<uint8_t> fad(HDR_LEN + cnt * ENTRY_LEN + 8);
+    std::memcpy(fad.data(), in, HDR_LEN);
+    std::memcpy(fad.data() + HDR_LEN, idx, cnt * ENTRY_LEN);
+    store_le(fad.data() + HDR_LEN + cnt * ENTRY_LEN, cnt, 8);
+
+    uint8_t fnonce[isap_common::knt_len];
+    footer_nonce(hdr.nonce, fnonce);
+
+    uint8_t empty[2]{};
+    const bool flg = isap::decrypt<p, s_b, s_k, s_e, s_h>(
+      k, fnonce, trl, fad.data(), fad.size(), empty, empty + 1, 0);
+    if (!flg) {
+      return false;
+    }
+
+    // index is authenticated, still ensure that chunks are contiguous
+    index.resize(cnt);
+
+    uint64_t off = 0;
+    for (size_t i = 0; i < cnt; i++) {
+      const uint8_t* const ent = idx + i * ENTRY_LEN;
+
+      index[i].offset = load_le(ent, 8);
+      index[i].len = static_cast<uint32_t>(load_le(ent + 8, 4));
+      index[i].tag = ent + 12;
+
+      if (index[i].offset != off) {
+        index.clear();
+        return false;
+      }
+      off += index[i].len;
+    }
+
+    if (off != total) {
+      index.clear();
+      return false;
+    }
+
+    std::memcpy(key, k, sizeof(key));
+    arc = in;
+    mlen = total;
+    return true;
+  }
+
+  // Given byte offset & length of a range of message, this routine decrypts
+  // that range, authenticating & decrypting only those chunks which cover it.
+  // Returned boolean flag holds truth value only when range lies within message
+  // & all covering chunks are authenticated.
+  //
+  // Note, if verification fails, output bytes are zeroed, so that unverified
+  // bytes are never released.
+  bool read_range(const uint64_t off,
+                  const size_t len,
+                  uint8_t* const out) const
+  {
+    if (arc == nullptr || off > mlen || len > mlen - off) {
+      return false;
+    }
+    if (len == 0) {
+      return true;
+    }
+
+    // first chunk, whose range ends after requested offset
+    auto it = std::upper_bound(
+      index.begin(), index.end(), off, [](const uint64_t o, const entry_t& e) {
+        return o < e.offset + e.len;
+      });
+
+    std::vector<uint8_t> buf;
+    size_t done = 0;
+
+    while (done < len) {
+      const size_t i = static_cast<size_t>(it - index.begin());
+      const entry_t& e = *it;
+
+      uint8_t cnonce[isap_common::knt_len];
+      uint8_t ad[AD_LEN];
+
+      isap_chunked::chunk_nonce(hdr.nonce, i, cnonce);
+      chunk_ad(arc, i, ad);
+
+      const size_t skip = static_cast<size_t>(off + done - e.offset);
+      const size_t take = std::min<size_t>(e.len - skip, len - done);
+
+      // decrypt fully covered chunks in place, otherwise through scratch
+      const bool whole = skip == 0 && take == e.len;
+      if (!whole) {
+        buf.resize(e.len);
+      }
+      uint8_t* const dst = whole ? out + done : buf.data();
+
+      const uint8_t* const enc = arc + HDR_LEN + e.offset;
+      const bool flg = isap::decrypt<p, s_b, s_k, s_e, s_h>(
+        key, cnonce, e.tag, ad, sizeof(ad), enc, dst, e.len);
+      if (!flg) {
+        std::memset(out, 0, len);
+        return false;
+      }
+
+      if (!whole) {
+        std::memcpy(out + done, buf.data() + skip, take);
+      }
+
+      done += take;
+      ++it;
+    }
+
+    return true;
+  }
+};
+
+}
@@ -1,7 +1,56 @@
 #pragma once
+#include "instrument.hpp"
 #include <bit>
 #include <cstddef>
 #include <cstdint>
+#include <utility>
+
+// Permutations ( see include/ascon.hpp & include/keccak.hpp ) are emitted as
+// straight-line code, with every round constant baked in as an immediate,
+// when this is 0 ( default ). Otherwise, rounds are emitted in a loop, each of
+// whose iterations runs these many rounds, trading speed for code size.
+#if !defined ISAP_PERM_UNROLL
+#define ISAP_PERM_UNROLL 0
+#endif
+
+// Ascon-p state is kept bit-interleaved ( see `permute_bi` ), when this is 1,
+// which is default on targets with 32 -bit pointers, where 64 -bit rotations
+// are compiled into multi-instruction sequences. Otherwise, state is kept as
+// 64 -bit words.
+#if !defined ISAP_ASCON_BI
+#if UINTPTR_MAX == UINT32_MAX
+#define ISAP_ASCON_BI 1
+#else
+#define ISAP_ASCON_BI 0
+#endif
+#endif
+
+// Ascon-p permutation is run by hand-written x86-64 assembly ( see
+// asm/ascon_x86_64.S ), when this is 1, choosing between its baseline & BMI2
+// variants at runtime. Its object file must be linked in, which is done by
+// building with `make ... ASCON_ASM=1`. Default is 0.
+#if !defined ISAP_ASCON_ASM
+#define ISAP_ASCON_ASM 0
+#endif
+
+#if ISAP_ASCON_ASM && (ISAP_ASCON_BI || !defined __x86_64__)
+#error "ISAP_ASCON_ASM needs x86-64 target, with ISAP_ASCON_BI unset"
+#endif
+
+// Permutations ( see include/ascon.hpp & include/keccak.hpp ) use AArch64
+// NEON backends, when this is 1 i.e. multi-state Ascon-p, permuting two states
+// at once, along with single-state & multi-state Keccak-p[400]. Default is 0.
+#if !defined ISAP_NEON
+#define ISAP_NEON 0
+#endif
+
+#if ISAP_NEON && (ISAP_ASCON_BI || !defined __aarch64__ || !defined __ARM_NEON)
+#error "ISAP_NEON needs AArch64 target with NEON, with ISAP_ASCON_BI unset"
+#endif
+
+#if ISAP_NEON
+#include <arm_neon.h>
+#endif
 
 // Ascon-p Permutation, copied from my previous work
 // https://github.com/itzmeanjan/ascon/blob/58a1a1e/include/permutation.hpp
@@ -30,18 +79,22 @@ p_c(uint64_t* const state, const size_t c_idx)
 // Substitution layer i.e. 5 -bit S-box S(x) applied on Ascon state; taken from
 // figure 5 in Ascon specification
 // https://csrc.nist.gov/CSRC/media/Projects/lightweight-cryptography/documents/finalist-round/updated-spec-doc/ascon-spec-final.pdf
+//
+// S-box is bitsliced, so that it's applied same way on 64 -bit words & on
+// 32 -bit halves of bit-interleaved words.
+template<typename T>
 static inline constexpr void
-p_s(uint64_t* const state)
+p_s(T* const state)
 {
   state[0] ^= state[4];
   state[4] ^= state[3];
   state[2] ^= state[1];
 
-  const uint64_t t0 = state[1] & ~state[0];
-  const uint64_t t1 = state[2] & ~state[1];
-  const uint64_t t2 = state[3] & ~state[2];
-  const uint64_t t3 = state[4] & ~state[3];
-  const uint64_t t4 = state[0] & ~state[4];
+  const T t0 = state[1] & ~state[0];
+  const T t1 = state[2] & ~state[1];
+  const T t2 = state[3] & ~state[2];
+  const T t3 = state[4] & ~state[3];
+  const T t4 = state[0] & ~state[4];
 
   state[0] ^= t1;
   state[1] ^= t2;
@@ -69,20 +122,524 @@ p_l(uint64_t* const state)
   state[4] ^= rotr(state[4], 7) ^ rotr(state[4], 41);
 }
 
+// Single round of Ascon permutation, where round constant is passed as value
+static inline constexpr void
+round(uint64_t* const state, const uint64_t rc)
+{
+  state[2] ^= rc;
+  p_s(state);
+  p_l(state);
+}
+
+// Single round of Ascon permutation, indexed by round, so that its constant is
+// an immediate operand
+template<const size_t R>
+static inline constexpr void
+round(uint64_t* const state)
+  requires(R < MAX_ROUNDS)
+{
+  round(state, RC[R]);
+}
+
+// Applies rounds BEG + I, for each I in index sequence, as straight-line code
+template<const size_t BEG, size_t... I>
+static inline constexpr void
+rounds(uint64_t* const state, std::index_sequence<I...>)
+{
+  (round<BEG + I>(state), ...);
+}
+
 // Ascon permutation; taken from appendix A of ISAP specification
 // https://csrc.nist.gov/CSRC/media/Projects/lightweight-cryptography/documents/finalist-round/updated-spec-doc/isap-spec-final.pdf
-template<const size_t ROUNDS>
+//
+// State is kept in local variables, while rounds are fully unrolled, unless
+// UNROLL is non-zero & less than ROUNDS, in which case UNROLL -many rounds are
+// run in each loop iteration.
+template<const size_t ROUNDS, const size_t UNROLL = ISAP_PERM_UNROLL>
 static inline constexpr void
 permute(uint64_t* const state)
   requires(ROUNDS <= MAX_ROUNDS)
 {
   constexpr size_t beg = MAX_ROUNDS - ROUNDS;
 
-  for (size_t i = beg; i < MAX_ROUNDS; i++) {
-    p_c(state, i);
-    p_s(state);
-    p_l(state);
+  isap_instr::permute<isap_instr::perm_t::ASCON>(ROUNDS);
+
+  uint64_t s[5]{ state[0], state[1], state[2], state[3], state[4] };
+
+  if constexpr (UNROLL == 0 || UNROLL >= ROUNDS) {
+    rounds<beg>(s, std::make_index_sequence<ROUNDS>{});
+  } else {
+    constexpr size_t rem = ROUNDS % UNROLL;
+
+    // leftover rounds first, so that loop runs over whole blocks
+    if constexpr (rem > 0) {
+      rounds<beg>(s, std::make_index_sequence<rem>{});
+    }
+
+    for (size_t i = beg + rem; i < MAX_ROUNDS; i += UNROLL) {
+#if defined __clang__
+#pragma clang loop unroll(full)
+#elif defined __GNUG__
+#pragma GCC unroll 16
+#endif
+      for (size_t j = 0; j < UNROLL; j++) {
+        round(s, RC[i + j]);
+      }
+    }
+  }
+
+  state[0] = s[0];
+  state[1] = s[1];
+  state[2] = s[2];
+  state[3] = s[3];
+  state[4] = s[4];
+}
+
+#if ISAP_ASCON_ASM
+
+// Ascon-p permutation, written in x86-64 assembly, applying last N ( <= 12 )
+// rounds on state; see asm/ascon_x86_64.S
+extern "C"
+{
+  void isap_ascon_permute_x86_64(uint64_t* const state, const size_t rounds);
+  void isap_ascon_permute_x86_64_bmi2(uint64_t* const state,
+                                      const size_t rounds);
+}
+
+using permute_asm_t = void (*)(uint64_t* const, const size_t);
+
+// Picks BMI2 variant of assembly permutation, when CPU supports both BMI1 &
+// BMI2, otherwise baseline one
+static inline permute_asm_t
+select_permute_asm()
+{
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2")) {
+    return isap_ascon_permute_x86_64_bmi2;
+  }
+  return isap_ascon_permute_x86_64;
+}
+
+// Ascon permutation, same as `permute`, but run by assembly implementation,
+// which is selected on first call
+template<const size_t ROUNDS>
+static inline void
+permute_asm(uint64_t* const state)
+  requires(ROUNDS <= MAX_ROUNDS)
+{
+  static const permute_asm_t fn = select_permute_asm();
+
+  isap_instr::permute<isap_instr::perm_t::ASCON>(ROUNDS);
+  fn(state, ROUNDS);
+}
+
+#endif
+
+#if ISAP_NEON
+
+// Rightwards circular rotation of both 64 -bit lanes of vector by R -bits,
+// using a shift & a shift-right-and-insert
+template<const size_t R>
+static inline uint64x2_t
+rotr_x2(const uint64x2_t x)
+  requires((R > 0) && (R < 64))
+{
+  return vsriq_n_u64(vshlq_n_u64(x, 64 - R), x, R);
+}
+
+// x ^= rotr(x, R0) ^ rotr(x, R1), on both lanes of vector
+template<const size_t R0, const size_t R1>
+static inline uint64x2_t
+sigma_x2(const uint64x2_t x)
+{
+  return x ^ rotr_x2<R0>(x) ^ rotr_x2<R1>(x);
+}
+
+// Single round of Ascon permutation, on two states at once, where i -th word
+// of both states is held in i -th vector
+static inline void
+round_x2(uint64x2_t* const state, const uint64_t rc)
+{
+  state[2] ^= vdupq_n_u64(rc);
+  p_s(state);
+
+  state[0] = sigma_x2<19, 28>(state[0]);
+  state[1] = sigma_x2<61, 39>(state[1]);
+  state[2] = sigma_x2<1, 6>(state[2]);
+  state[3] = sigma_x2<10, 17>(state[3]);
+  state[4] = sigma_x2<7, 41>(state[4]);
+}
+
+// Applies rounds BEG + I, on two states at once, for each I in index sequence,
+// as straight-line code
+template<const size_t BEG, size_t... I>
+static inline void
+rounds_x2(uint64x2_t* const state, std::index_sequence<I...>)
+{
+  (round_x2(state, RC[BEG + I]), ...);
+}
+
+// Ascon permutation, same as `permute`, but on two states at once, using NEON,
+// where w[i][j] is i -th word of j -th state
+template<const size_t ROUNDS, const size_t UNROLL = ISAP_PERM_UNROLL>
+static inline void
+permute_x2(uint64_t (*const w)[2])
+  requires(ROUNDS <= MAX_ROUNDS)
+{
+  constexpr size_t beg = MAX_ROUNDS - ROUNDS;
+
+  // counted once per state
+  isap_instr::permute<isap_instr::perm_t::ASCON>(ROUNDS);
+  isap_instr::permute<isap_instr::perm_t::ASCON>(ROUNDS);
+
+  uint64x2_t s[5];
+  for (size_t i = 0; i < 5; i++) {
+    s[i] = vld1q_u64(w[i]);
+  }
+
+  if constexpr (UNROLL == 0 || UNROLL >= ROUNDS) {
+    rounds_x2<beg>(s, std::make_index_sequence<ROUNDS>{});
+  } else {
+    constexpr size_t rem = ROUNDS % UNROLL;
+
+    // leftover rounds first, so that loop runs over whole blocks
+    if constexpr (rem > 0) {
+      rounds_x2<beg>(s, std::make_index_sequence<rem>{});
+    }
+
+    for (size_t i = beg + rem; i < MAX_ROUNDS; i += UNROLL) {
+#if defined __clang__
+#pragma clang loop unroll(full)
+#elif defined __GNUG__
+#pragma GCC unroll 16
+#endif
+      for (size_t j = 0; j < UNROLL; j++) {
+        round_x2(s, RC[i + j]);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < 5; i++) {
+    vst1q_u64(w[i], s[i]);
+  }
+}
+
+#endif
+
+// Swaps bits of word, selected by mask, with bits lying `shift` -bits to their
+// left
+template<const uint64_t mask, const size_t shift>
+static inline constexpr uint64_t
+delta_swap(const uint64_t x)
+{
+  const uint64_t t = (x ^ (x >> shift)) & mask;
+  return x ^ t ^ (t << shift);
+}
+
+// Given a 64 -bit word, this routine bit-interleaves it i.e. its even bits are
+// gathered in lower 32 -bits, while odd bits are gathered in upper 32 -bits
+static inline constexpr uint64_t
+interleave(uint64_t x)
+{
+  x = delta_swap<0x2222222222222222ul, 1>(x);
+  x = delta_swap<0x0c0c0c0c0c0c0c0cul, 2>(x);
+  x = delta_swap<0x00f000f000f000f0ul, 4>(x);
+  x = delta_swap<0x0000ff000000ff00ul, 8>(x);
+  x = delta_swap<0x00000000ffff0000ul, 16>(x);
+  return x;
+}
+
+// Inverse of `interleave`, undoing its delta swaps in reverse order
+static inline constexpr uint64_t
+deinterleave(uint64_t x)
+{
+  x = delta_swap<0x00000000ffff0000ul, 16>(x);
+  x = delta_swap<0x0000ff000000ff00ul, 8>(x);
+  x = delta_swap<0x00f000f000f000f0ul, 4>(x);
+  x = delta_swap<0x0c0c0c0c0c0c0c0cul, 2>(x);
+  x = delta_swap<0x2222222222222222ul, 1>(x);
+  return x;
+}
+
+// Rightwards circular rotation of bit-interleaved word ( e, o ) by R -bits,
+// which is done using two 32 -bit rotations. For odd R, even & odd halves trade
+// places.
+template<const size_t R>
+static inline constexpr void
+rotr_bi(const uint32_t e, const uint32_t o, uint32_t& re, uint32_t& ro)
+{
+  if constexpr (R % 2 == 0) {
+    re = std::rotr(e, R / 2);
+    ro = std::rotr(o, R / 2);
+  } else {
+    re = std::rotr(o, (R - 1) / 2);
+    ro = std::rotr(e, (R + 1) / 2);
+  }
+}
+
+// x ^= rotr(x, R0) ^ rotr(x, R1), for bit-interleaved word x = ( e, o )
+template<const size_t R0, const size_t R1>
+static inline constexpr void
+sigma_bi(uint32_t& e, uint32_t& o)
+{
+  uint32_t e0, o0, e1, o1;
+  rotr_bi<R0>(e, o, e0, o0);
+  rotr_bi<R1>(e, o, e1, o1);
+
+  e ^= e0 ^ e1;
+  o ^= o0 ^ o1;
+}
+
+// Single round of Ascon permutation, on bit-interleaved state, whose even &
+// odd halves are passed separately, along with bit-interleaved round constant
+static inline constexpr void
+round_bi(uint32_t* const e, uint32_t* const o, const uint64_t rc)
+{
+  e[2] ^= static_cast<uint32_t>(rc);
+  o[2] ^= static_cast<uint32_t>(rc >> 32);
+
+  p_s(e);
+  p_s(o);
+
+  sigma_bi<19, 28>(e[0], o[0]);
+  sigma_bi<61, 39>(e[1], o[1]);
+  sigma_bi<1, 6>(e[2], o[2]);
+  sigma_bi<10, 17>(e[3], o[3]);
+  sigma_bi<7, 41>(e[4], o[4]);
+}
+
+// Single round of Ascon permutation, on bit-interleaved state, indexed by
+// round, so that its bit-interleaved constant is an immediate operand
+template<const size_t R>
+static inline constexpr void
+round_bi(uint32_t* const e, uint32_t* const o)
+  requires(R < MAX_ROUNDS)
+{
+  constexpr uint64_t rc = interleave(RC[R]);
+  round_bi(e, o, rc);
+}
+
+// Applies rounds BEG + I, on bit-interleaved state, for each I in index
+// sequence, as straight-line code
+template<const size_t BEG, size_t... I>
+static inline constexpr void
+rounds_bi(uint32_t* const e, uint32_t* const o, std::index_sequence<I...>)
+{
+  (round_bi<BEG + I>(e, o), ...);
+}
+
+// Ascon permutation, same as `permute`, but on bit-interleaved state ( see
+// `interleave` ), where each 64 -bit word is worked on as two 32 -bit halves,
+// so that each 64 -bit rotation becomes two 32 -bit rotations. It's meant for
+// 32 -bit targets, where state is kept bit-interleaved all along & converted
+// only when bytes enter or leave sponge ( see `state` ).
+template<const size_t ROUNDS, const size_t UNROLL = ISAP_PERM_UNROLL>
+static inline constexpr void
+permute_bi(uint64_t* const state)
+  requires(ROUNDS <= MAX_ROUNDS)
+{
+  constexpr size_t beg = MAX_ROUNDS - ROUNDS;
+
+  isap_instr::permute<isap_instr::perm_t::ASCON>(ROUNDS);
+
+  uint32_t e[5], o[5];
+  for (size_t i = 0; i < 5; i++) {
+    e[i] = static_cast<uint32_t>(state[i]);
+    o[i] = static_cast<uint32_t>(state[i] >> 32);
+  }
+
+  if constexpr (UNROLL == 0 || UNROLL >= ROUNDS) {
+    rounds_bi<beg>(e, o, std::make_index_sequence<ROUNDS>{});
+  } else {
+    constexpr size_t rem = ROUNDS % UNROLL;
+
+    // leftover rounds first, so that loop runs over whole blocks
+    if constexpr (rem > 0) {
+      rounds_bi<beg>(e, o, std::make_index_sequence<rem>{});
+    }
+
+    for (size_t i = beg + rem; i < MAX_ROUNDS; i += UNROLL) {
+#if defined __clang__
+#pragma clang loop unroll(full)
+#elif defined __GNUG__
+#pragma GCC unroll 16
+#endif
+      for (size_t j = 0; j < UNROLL; j++) {
+        round_bi(e, o, interleave(RC[i + j]));
+      }
+    }
+  }
+
+  for (size_t i = 0; i < 5; i++) {
+    state[i] = (static_cast<uint64_t>(o[i]) << 32) | e[i];
   }
 }
 
+// Ascon-p permutation state, held by value, so that once inlined, compiler can
+// keep its five words in registers, across sponge operations. Bytes are
+// converted to/ from words using shifts ( instead of copying through memory ),
+// interpreting each 64 -bit word in big-endian byte order.
+//
+// When `ISAP_ASCON_BI` is set, words are kept bit-interleaved, which is
+// converted to/ from, only when bytes enter or leave state. Note, most
+// significant bit of a word stays in place, when bit-interleaved.
+struct state
+{
+  uint64_t w[5];
+
+  // Words, as kept in state i.e. possibly bit-interleaved
+  inline constexpr uint64_t& operator[](const size_t i) { return w[i]; }
+  inline constexpr uint64_t operator[](const size_t i) const { return w[i]; }
+
+  // Converts big-endian word to representation kept in state
+  static inline constexpr uint64_t pack(const uint64_t v)
+  {
+    if constexpr (ISAP_ASCON_BI) {
+      return interleave(v);
+    } else {
+      return v;
+    }
+  }
+
+  // Converts word, as kept in state, to big-endian word
+  static inline constexpr uint64_t unpack(const uint64_t v)
+  {
+    if constexpr (ISAP_ASCON_BI) {
+      return deinterleave(v);
+    } else {
+      return v;
+    }
+  }
+
+  // Given N ( <= 8 ) -bytes, this routine returns them as most significant
+  // bytes of a big-endian word, whose remaining bytes are zeroed
+  static inline constexpr uint64_t load(const uint8_t* const bytes,
+                                        const size_t len)
+  {
+    uint64_t v = 0;
+    for (size_t i = 0; i < len; i++) {
+      v |= static_cast<uint64_t>(bytes[i]) << ((7 - i) << 3);
+    }
+    return v;
+  }
+
+  // Given a big-endian word, this routine writes its N ( <= 8 ) most
+  // significant bytes
+  static inline constexpr void store(const uint64_t v,
+                                     uint8_t* const bytes,
+                                     const size_t len)
+  {
+    for (size_t i = 0; i < len; i++) {
+      bytes[i] = static_cast<uint8_t>(v >> ((7 - i) << 3));
+    }
+  }
+
+  // Overwrites N -bytes of state, starting at given byte offset, where both
+  // offset & N must be multiple of 8
+  inline constexpr void set_bytes(const uint8_t* const bytes,
+                                  const size_t off,
+                                  const size_t len)
+  {
+    for (size_t i = 0; i < len; i += 8) {
+      w[(off + i) >> 3] = pack(load(bytes + i, 8));
+    }
+  }
+
+  // XORs N ( <= 40 ) -bytes into leading bytes of state
+  inline constexpr void xor_bytes(const uint8_t* const bytes, const size_t len)
+  {
+    for (size_t i = 0; i < len; i += 8) {
+      w[i >> 3] ^= pack(load(bytes + i, len - i < 8 ? len - i : 8));
+    }
+  }
+
+  // XORs a single byte into state, at given byte offset
+  inline constexpr void xor_byte(const size_t off, const uint8_t b)
+  {
+    w[off >> 3] ^= pack(static_cast<uint64_t>(b) << ((7 - (off & 7)) << 3));
+  }
+
+  // Writes N ( <= 40 ) leading bytes of state
+  inline constexpr void extract_bytes(uint8_t* const bytes,
+                                      const size_t len) const
+  {
+    for (size_t i = 0; i < len; i += 8) {
+      store(unpack(w[i >> 3]), bytes + i, len - i < 8 ? len - i : 8);
+    }
+  }
+
+  // Writes N ( <= 40 ) leading bytes of state, XOR-ed with N -bytes input,
+  // where input & output may be same buffer
+  inline constexpr void xor_extract(const uint8_t* const in,
+                                    uint8_t* const out,
+                                    const size_t len) const
+  {
+    for (size_t i = 0; i < len; i += 8) {
+      const size_t n = len - i < 8 ? len - i : 8;
+      store(load(in + i, n) ^ unpack(w[i >> 3]), out + i, n);
+    }
+  }
+
+  // Applies ROUNDS -many rounds of Ascon permutation on state
+  template<const size_t ROUNDS, const size_t UNROLL = ISAP_PERM_UNROLL>
+  inline constexpr void permute()
+    requires(ROUNDS <= MAX_ROUNDS)
+  {
+    if constexpr (ISAP_ASCON_BI) {
+      ascon::permute_bi<ROUNDS, UNROLL>(w);
+    } else {
+#if ISAP_ASCON_ASM
+      ascon::permute_asm<ROUNDS>(w);
+#else
+      ascon::permute<ROUNDS, UNROLL>(w);
+#endif
+    }
+  }
+};
+
+// Two Ascon-p permutation states, word-sliced i.e. w[i][j] is i -th word of
+// j -th state ( as kept in `state` ), so that both can be permuted at once,
+// using multi-state backend, when `ISAP_NEON` is set. Otherwise, each state is
+// permuted on its own.
+struct state_x2
+{
+  static constexpr size_t LANES = 2;
+
+  alignas(16) uint64_t w[5][LANES];
+
+  // Writes state into j -th lane
+  inline constexpr void insert(const size_t j, const state& s)
+  {
+    for (size_t i = 0; i < 5; i++) {
+      w[i][j] = s[i];
+    }
+  }
+
+  // Reads state out of j -th lane
+  inline constexpr state extract(const size_t j) const
+  {
+    state s;
+    for (size_t i = 0; i < 5; i++) {
+      s[i] = w[i][j];
+    }
+    return s;
+  }
+
+  // Applies ROUNDS -many rounds of Ascon permutation on both states
+  template<const size_t ROUNDS, const size_t UNROLL = ISAP_PERM_UNROLL>
+  inline void permute()
+    requires(ROUNDS <= MAX_ROUNDS)
+  {
+#if ISAP_NEON
+    ascon::permute_x2<ROUNDS, UNROLL>(w);
+#else
+    for (size_t j = 0; j < LANES; j++) {
+      state s = extract(j);
+      s.permute<ROUNDS, UNROLL>();
+      insert(j, s);
+    }
+#endif
+  }
+};
+
 }
@@ -0,0 +1,293 @@
+#pragma once
+#include "aead.hpp"
+#include "cost_model.hpp"
+#include "perf_events.hpp"
+#include "utils.hpp"
+#include <benchmark/benchmark.h>
+#include <cassert>
+#include <cstring>
+
+// Benchmark ISAP Authenticated Encryption with Associated Data
+namespace isap_bench {
+
+// Benchmarks encrypt routine of ISAP instance ( chosen by template parameters,
+// see table 2.2 of ISAP specification ) on CPU based systems, where first
+// argument denotes associated data length & second one denotes plain text
+// length, both in bytes
+//
+// See
+// https://csrc.nist.gov/CSRC/media/Projects/lightweight-cryptography/documents/finalist-round/updated-spec-doc/isap-spec-final.pdf
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+aead_encrypt(benchmark::State& state)
+{
+  const size_t dlen = static_cast<size_t>(state.range(0));
+  const size_t mlen = static_cast<size_t>(state.range(1));
+
+  uint8_t* key = static_cast<uint8_t*>(std::malloc(16));
+  uint8_t* nonce = static_cast<uint8_t*>(std::malloc(16));
+  uint8_t* tag = static_cast<uint8_t*>(std::malloc(16));
+  uint8_t* data = static_cast<uint8_t*>(std::malloc(dlen));
+  uint8_t* txt = static_cast<uint8_t*>(std::malloc(mlen));
+  uint8_t* enc = static_cast<uint8_t*>(std::malloc(mlen));
+  uint8_t* dec = static_cast<uint8_t*>(std::malloc(mlen));
+
+  isap_utils::random_data<uint8_t>(key, 16);
+  isap_utils::random_data<uint8_t>(nonce, 16);
+  isap_utils::random_data<uint8_t>(data, dlen);
+  isap_utils::random_data<uint8_t>(txt, mlen);
+
+  std::memset(tag, 0, 16);
+  std::memset(enc, 0, mlen);
+  std::memset(dec, 0, mlen);
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    isap::encrypt<p, s_b, s_k, s_e, s_h>(
+      key, nonce, data, dlen, txt, enc, mlen, tag);
+
+    benchmark::DoNotOptimize(enc);
+    benchmark::DoNotOptimize(tag);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  // --- test correctness ---
+  bool f0 = false;
+  f0 = isap::decrypt<p, s_b, s_k, s_e, s_h>(
+    key, nonce, tag, data, dlen, enc, dec, mlen);
+
+  assert(f0);
+
+  bool f1 = false;
+  for (size_t i = 0; i < mlen; i++) {
+    f1 |= txt[i] ^ dec[i];
+  }
+
+  assert(!f1);
+  // --- test correctness ---
+
+  const size_t per_itr = mlen + dlen;
+  state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
+  report_rounds(state, aead_rounds<p, s_b, s_k, s_e, s_h>(dlen, mlen));
+
+  std::free(key);
+  std::free(nonce);
+  std::free(tag);
+  std::free(data);
+  std::free(txt);
+  std::free(enc);
+  std::free(dec);
+}
+
+// Benchmarks decrypt routine of ISAP instance ( chosen by template parameters,
+// see table 2.2 of ISAP specification ) on CPU based systems, where first
+// argument denotes associated data length & second one denotes cipher text
+// length, both in bytes
+//
+// See
+// https://csrc.nist.gov/CSRC/media/Projects/lightweight-cryptography/documents/finalist-round/updated-spec-doc/isap-spec-final.pdf
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+aead_decrypt(benchmark::State& state)
+{
+  const size_t dlen = static_cast<size_t>(state.range(0));
+  const size_t mlen = static_cast<size_t>(state.range(1));
+
+  uint8_t* key = static_cast<uint8_t*>(std::malloc(16));
+  uint8_t* nonce = static_cast<uint8_t*>(std::malloc(16));
+  uint8_t* tag = static_cast<uint8_t*>(std::malloc(16));
+  uint8_t* data = static_cast<uint8_t*>(std::malloc(dlen));
+  uint8_t* txt = static_cast<uint8_t*>(std::malloc(mlen));
+  uint8_t* enc = static_cast<uint8_t*>(std::malloc(mlen));
+  uint8_t* dec = static_cast<uint8_t*>(std::malloc(mlen));
+
+  isap_utils::random_data<uint8_t>(key, 16);
+  isap_utils::random_data<uint8_t>(nonce, 16);
+  isap_utils::random_data<uint8_t>(data, dlen);
+  isap_utils::random_data<uint8_t>(txt, mlen);
+
+  std::memset(tag, 0, 16);
+  std::memset(enc, 0, mlen);
+  std::memset(dec, 0, mlen);
+
+  isap::encrypt<p, s_b, s_k, s_e, s_h>(
+    key, nonce, data, dlen, txt, enc, mlen, tag);
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    bool f = false;
+    f = isap::decrypt<p, s_b, s_k, s_e, s_h>(
+      key, nonce, tag, data, dlen, enc, dec, mlen);
+
+    benchmark::DoNotOptimize(f);
+    benchmark::DoNotOptimize(dec);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  // --- test correctness ---
+  bool f = false;
+  for (size_t i = 0; i < mlen; i++) {
+    f |= txt[i] ^ dec[i];
+  }
+
+  assert(!f);
+  // --- test correctness ---
+
+  const size_t per_itr = mlen + dlen;
+  state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
+  report_rounds(state, aead_rounds<p, s_b, s_k, s_e, s_h>(dlen, mlen));
+
+  std::free(key);
+  std::free(nonce);
+  std::free(tag);
+  std::free(data);
+  std::free(txt);
+  std::free(enc);
+  std::free(dec);
+}
+
+// Benchmarks authenticate-only routine of ISAP instance ( chosen by template
+// parameters ), where only argument denotes associated data length in bytes
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+aead_authenticate(benchmark::State& state)
+{
+  const size_t dlen = static_cast<size_t>(state.range(0));
+
+  uint8_t* key = static_cast<uint8_t*>(std::malloc(16));
+  uint8_t* nonce = static_cast<uint8_t*>(std::malloc(16));
+  uint8_t* tag = static_cast<uint8_t*>(std::malloc(16));
+  uint8_t* data = static_cast<uint8_t*>(std::malloc(dlen));
+
+  isap_utils::random_data<uint8_t>(key, 16);
+  isap_utils::random_data<uint8_t>(nonce, 16);
+  isap_utils::random_data<uint8_t>(data, dlen);
+
+  std::memset(tag, 0, 16);
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    isap::authenticate<p, s_b, s_k, s_e, s_h>(key, nonce, data, dlen, tag);
+
+    benchmark::DoNotOptimize(tag);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  // --- test correctness ---
+  uint8_t tag_[16];
+  isap::encrypt<p, s_b, s_k, s_e, s_h>(
+    key, nonce, data, dlen, nullptr, nullptr, 0, tag_);
+
+  assert(std::memcmp(tag, tag_, 16) == 0);
+  // --- test correctness ---
+
+  state.SetBytesProcessed(static_cast<int64_t>(dlen * state.iterations()));
+  events.report(state, dlen);
+  report_rounds(state, mac_rounds<p, s_b, s_k, s_h>(dlen, 0));
+
+  std::free(key);
+  std::free(nonce);
+  std::free(tag);
+  std::free(data);
+}
+
+// Benchmarks verify-only routine of ISAP instance ( chosen by template
+// parameters ), which checks tag without decrypting cipher text, where first
+// argument denotes associated data length & second one denotes cipher text
+// length, both in bytes
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+aead_verify(benchmark::State& state)
+{
+  const size_t dlen = static_cast<size_t>(state.range(0));
+  const size_t clen = static_cast<size_t>(state.range(1));
+
+  uint8_t* key = static_cast<uint8_t*>(std::malloc(16));
+  uint8_t* nonce = static_cast<uint8_t*>(std::malloc(16));
+  uint8_t* tag = static_cast<uint8_t*>(std::malloc(16));
+  uint8_t* data = static_cast<uint8_t*>(std::malloc(dlen));
+  uint8_t* txt = static_cast<uint8_t*>(std::malloc(clen));
+  uint8_t* enc = static_cast<uint8_t*>(std::malloc(clen));
+
+  isap_utils::random_data<uint8_t>(key, 16);
+  isap_utils::random_data<uint8_t>(nonce, 16);
+  isap_utils::random_data<uint8_t>(data, dlen);
+  isap_utils::random_data<uint8_t>(txt, clen);
+
+  isap::encrypt<p, s_b, s_k, s_e, s_h>(
+    key, nonce, data, dlen, txt, enc, clen, tag);
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    bool f = false;
+    f = isap::verify<p, s_b, s_k, s_e, s_h>(
+      key, nonce, tag, data, dlen, enc, clen);
+
+    benchmark::DoNotOptimize(f);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  // --- test correctness ---
+  bool f0 = false;
+  f0 = isap::verify<p, s_b, s_k, s_e, s_h>(
+    key, nonce, tag, data, dlen, enc, clen);
+
+  assert(f0);
+
+  tag[0] ^= 1;
+
+  bool f1 = true;
+  f1 = isap::verify<p, s_b, s_k, s_e, s_h>(
+    key, nonce, tag, data, dlen, enc, clen);
+
+  assert(!f1);
+  // --- test correctness ---
+
+  const size_t per_itr = clen + dlen;
+  state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
+  report_rounds(state, mac_rounds<p, s_b, s_k, s_h>(dlen, clen));
+
+  std::free(key);
+  std::free(nonce);
+  std::free(tag);
+  std::free(data);
+  std::free(txt);
+  std::free(enc);
+}
+
+}
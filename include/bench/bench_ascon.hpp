@@ -1,28 +1,167 @@
 #pragma once
 #include "ascon.hpp"
+#include "perf_events.hpp"
 #include "utils.hpp"
+#include <algorithm>
 #include <benchmark/benchmark.h>
+#include <cassert>
 
 // Benchmark ISAP Authenticated Encryption with Associated Data
 namespace isap_bench {
 
 // Benchmarks Ascon permutation on CPU based systems, for specified # -of rounds
-template<const size_t ROUNDS>
+// & # -of rounds per loop iteration ( 0 => fully unrolled, see
+// `ISAP_PERM_UNROLL` )
+template<const size_t ROUNDS, const size_t UNROLL = ISAP_PERM_UNROLL>
 static void
 ascon_permutation(benchmark::State& state)
 {
   uint64_t pstate[5];
   isap_utils::random_data<uint64_t>(pstate, 5);
 
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    ascon::permute<ROUNDS, UNROLL>(pstate);
+
+    benchmark::DoNotOptimize(pstate);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  constexpr size_t per_itr = sizeof(pstate);
+  state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
+}
+
+// Benchmarks Ascon permutation on bit-interleaved state ( see `permute_bi` ),
+// for specified # -of rounds, no matter whether it's selected using
+// `ISAP_ASCON_BI`, so that it can be compared against `ascon_permutation`.
+// Result is checked against permutation on 64 -bit words, on random states.
+template<const size_t ROUNDS>
+static void
+ascon_permutation_bi(benchmark::State& state)
+{
+  uint64_t pstate[5];
+  isap_utils::random_data<uint64_t>(pstate, 5);
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    ascon::permute_bi<ROUNDS>(pstate);
+
+    benchmark::DoNotOptimize(pstate);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  // --- test correctness ---
+  for (size_t i = 0; i < 64; i++) {
+    uint64_t st0[5], st1[5];
+    isap_utils::random_data<uint64_t>(st0, 5);
+
+    for (size_t j = 0; j < 5; j++) {
+      st1[j] = ascon::interleave(st0[j]);
+      assert(ascon::deinterleave(st1[j]) == st0[j]);
+    }
+
+    ascon::permute<ROUNDS>(st0);
+    ascon::permute_bi<ROUNDS>(st1);
+
+    for (size_t j = 0; j < 5; j++) {
+      assert(ascon::deinterleave(st1[j]) == st0[j]);
+    }
+  }
+  // --- test correctness ---
+
+  constexpr size_t per_itr = sizeof(pstate);
+  state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
+}
+
+#if ISAP_ASCON_ASM
+
+// Benchmarks Ascon permutation, written in x86-64 assembly ( see
+// asm/ascon_x86_64.S ), for specified # -of rounds, using either its baseline
+// or BMI2 variant, no matter which one is selected at runtime. Result is
+// checked against C++ implementation, on random states.
+template<const size_t ROUNDS, const bool bmi2>
+static void
+ascon_permutation_asm(benchmark::State& state)
+{
+  if (bmi2 && !(__builtin_cpu_supports("bmi") &&
+                __builtin_cpu_supports("bmi2"))) {
+    state.SkipWithError("CPU doesn't support BMI1 & BMI2");
+    return;
+  }
+
+  const ascon::permute_asm_t fn = bmi2 ? ascon::isap_ascon_permute_x86_64_bmi2
+                                       : ascon::isap_ascon_permute_x86_64;
+
+  uint64_t pstate[5];
+  isap_utils::random_data<uint64_t>(pstate, 5);
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    fn(pstate, ROUNDS);
+
+    benchmark::DoNotOptimize(pstate);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  // --- test correctness ---
+  for (size_t i = 0; i < 256; i++) {
+    uint64_t st0[5], st1[5];
+    isap_utils::random_data<uint64_t>(st0, 5);
+    std::copy(st0, st0 + 5, st1);
+
+    ascon::permute<ROUNDS>(st0);
+    fn(st1, ROUNDS);
+
+    assert(std::equal(st0, st0 + 5, st1));
+  }
+  // --- test correctness ---
+
+  constexpr size_t per_itr = sizeof(pstate);
+  state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
+}
+
+#endif
+
+// Benchmarks Ascon permutation on two states at once ( see `state_x2` ), for
+// specified # -of rounds, where bytes processed count both states, so that
+// throughput can be compared against `ascon_permutation`.
+template<const size_t ROUNDS>
+static void
+ascon_permutation_x2(benchmark::State& state)
+{
+  ascon::state_x2 pstate;
+  isap_utils::random_data<uint64_t>(&pstate.w[0][0], 5 * pstate.LANES);
+
+  perf_events events;
+  events.start();
+
   for (auto _ : state) {
-    ascon::permute<ROUNDS>(pstate);
+    pstate.permute<ROUNDS>();
 
     benchmark::DoNotOptimize(pstate);
     benchmark::ClobberMemory();
   }
 
+  events.stop();
+
   constexpr size_t per_itr = sizeof(pstate);
   state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
 }
 
 }
@@ -0,0 +1,146 @@
+#pragma once
+#include "archive.hpp"
+#include "chunked.hpp"
+#include "cost_model.hpp"
+#include "perf_events.hpp"
+#include "utils.hpp"
+#include <benchmark/benchmark.h>
+#include <cassert>
+#include <cstring>
+
+// Benchmark ISAP Authenticated Encryption with Associated Data
+namespace isap_bench {
+
+// Benchmarks chunked encryption ( see include/chunked.hpp ) of ISAP instance (
+// chosen by template parameters ) on CPU based systems, where first argument
+// denotes message length, second one denotes chunk length, both in bytes &
+// third one denotes # -of threads chunks are spread over.
+//
+// Ideally throughput should scale linearly with # -of threads, as long as there
+// are enough chunks to keep all threads busy.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+chunked_encrypt(benchmark::State& state)
+{
+  using namespace isap_chunked;
+
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const uint32_t clen = static_cast<uint32_t>(state.range(1));
+  const size_t nthreads = static_cast<size_t>(state.range(2));
+  const size_t elen = encrypted_len(mlen, clen);
+
+  uint8_t key[16];
+  uint8_t nonce[16];
+  uint8_t* txt = static_cast<uint8_t*>(std::malloc(mlen));
+  uint8_t* enc = static_cast<uint8_t*>(std::malloc(elen));
+  uint8_t* dec = static_cast<uint8_t*>(std::malloc(mlen));
+
+  isap_utils::random_data<uint8_t>(key, sizeof(key));
+  isap_utils::random_data<uint8_t>(nonce, sizeof(nonce));
+  isap_utils::random_data<uint8_t>(txt, mlen);
+
+  for (auto _ : state) {
+    encrypt<p, s_b, s_k, s_e, s_h>(key, nonce, clen, txt, mlen, enc, nthreads);
+
+    benchmark::DoNotOptimize(enc);
+    benchmark::ClobberMemory();
+  }
+
+  // --- test correctness ---
+  bool f0 = false;
+  f0 = decrypt<p, s_b, s_k, s_e, s_h>(key, enc, elen, dec, nthreads);
+
+  assert(f0);
+
+  bool f1 = false;
+  for (size_t i = 0; i < mlen; i++) {
+    f1 |= txt[i] ^ dec[i];
+  }
+
+  assert(!f1);
+  // --- test correctness ---
+
+  state.SetBytesProcessed(static_cast<int64_t>(mlen * state.iterations()));
+  state.counters["chunks"] = static_cast<double>(chunk_count(mlen, clen));
+
+  std::free(txt);
+  std::free(enc);
+  std::free(dec);
+}
+
+// Benchmarks random-access read of a byte range out of archive ( see
+// include/archive.hpp ), produced by ISAP instance ( chosen by template
+// parameters ), on CPU based systems, where first argument denotes message
+// length, second one denotes chunk length & third one denotes length of byte
+// range, all in bytes. Each iteration authenticates footer index & decrypts
+// range, starting at middle of message.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+archive_read_range(benchmark::State& state)
+{
+  using namespace isap_archive;
+
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const uint32_t clen = static_cast<uint32_t>(state.range(1));
+  const size_t rlen = static_cast<size_t>(state.range(2));
+  const size_t alen = archive_len(mlen, clen);
+  const size_t roff = (mlen - rlen) / 2;
+
+  uint8_t key[16];
+  uint8_t nonce[16];
+  uint8_t* txt = static_cast<uint8_t*>(std::malloc(mlen));
+  uint8_t* arc = static_cast<uint8_t*>(std::malloc(alen));
+  uint8_t* dec = static_cast<uint8_t*>(std::malloc(rlen));
+
+  isap_utils::random_data<uint8_t>(key, sizeof(key));
+  isap_utils::random_data<uint8_t>(nonce, sizeof(nonce));
+  isap_utils::random_data<uint8_t>(txt, mlen);
+
+  encrypt<p, s_b, s_k, s_e, s_h>(key, nonce, clen, txt, mlen, arc);
+
+  bool flg = true;
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    reader_t<p, s_b, s_k, s_e, s_h> reader;
+
+    flg &= reader.open(key, arc, alen);
+    flg &= reader.read_range(roff, rlen, dec);
+
+    benchmark::DoNotOptimize(flg);
+    benchmark::DoNotOptimize(dec);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  // --- test correctness ---
+  assert(flg);
+
+  bool f1 = false;
+  for (size_t i = 0; i < rlen; i++) {
+    f1 |= txt[roff + i] ^ dec[i];
+  }
+
+  assert(!f1);
+  // --- test correctness ---
+
+  state.SetBytesProcessed(static_cast<int64_t>(rlen * state.iterations()));
+  events.report(state, rlen);
+
+  std::free(txt);
+  std::free(arc);
+  std::free(dec);
+}
+
+}
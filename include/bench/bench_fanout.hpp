@@ -0,0 +1,109 @@
+#pragma once
+#include "aead.hpp"
+#include "fanout.hpp"
+#include "perf_events.hpp"
+#include "utils.hpp"
+#include <benchmark/benchmark.h>
+#include <cassert>
+#include <cstring>
+#include <vector>
+
+// Benchmark ISAP Authenticated Encryption with Associated Data
+namespace isap_bench {
+
+// Byte length of associated data, used for benchmarking fan-out encryption
+constexpr size_t FANOUT_DATA_LEN = 16;
+
+// Benchmarks fan-out encryption of ISAP instance ( chosen by template
+// parameters ) i.e. encrypting single plain text under many recipients' keys &
+// nonces, either using `isap_fanout::encrypt` or calling `isap::encrypt` for
+// each recipient, one after another, where both only differ when built with
+// `ISAP_NEON`. First argument denotes # -of recipients, while second one
+// denotes plain text length in bytes.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h,
+         const bool fanout>
+static void
+fanout_encrypt(benchmark::State& state)
+{
+  const size_t cnt = static_cast<size_t>(state.range(0));
+  const size_t mlen = static_cast<size_t>(state.range(1));
+  const size_t dlen = FANOUT_DATA_LEN;
+
+  std::vector<uint8_t> keys(cnt * 16);
+  std::vector<uint8_t> nonces(cnt * 16);
+  std::vector<uint8_t> data(dlen);
+  std::vector<uint8_t> txt(mlen);
+  std::vector<uint8_t> enc(cnt * mlen);
+  std::vector<uint8_t> tags(cnt * 16);
+
+  isap_utils::random_data<uint8_t>(keys.data(), keys.size());
+  isap_utils::random_data<uint8_t>(nonces.data(), nonces.size());
+  isap_utils::random_data<uint8_t>(data.data(), dlen);
+  isap_utils::random_data<uint8_t>(txt.data(), mlen);
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    if constexpr (fanout) {
+      isap_fanout::encrypt<p, s_b, s_k, s_e, s_h>(keys.data(),
+                                                  nonces.data(),
+                                                  cnt,
+                                                  data.data(),
+                                                  dlen,
+                                                  txt.data(),
+                                                  mlen,
+                                                  enc.data(),
+                                                  tags.data());
+    } else {
+      for (size_t i = 0; i < cnt; i++) {
+        isap::encrypt<p, s_b, s_k, s_e, s_h>(keys.data() + i * 16,
+                                             nonces.data() + i * 16,
+                                             data.data(),
+                                             dlen,
+                                             txt.data(),
+                                             enc.data() + i * mlen,
+                                             mlen,
+                                             tags.data() + i * 16);
+      }
+    }
+
+    benchmark::DoNotOptimize(enc.data());
+    benchmark::DoNotOptimize(tags.data());
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  // --- test correctness ---
+  std::vector<uint8_t> dec(mlen);
+  bool f = true;
+
+  for (size_t i = 0; i < cnt; i++) {
+    f &= isap::decrypt<p, s_b, s_k, s_e, s_h>(keys.data() + i * 16,
+                                              nonces.data() + i * 16,
+                                              tags.data() + i * 16,
+                                              data.data(),
+                                              dlen,
+                                              enc.data() + i * mlen,
+                                              dec.data(),
+                                              mlen);
+    f &= dec == txt;
+  }
+
+  assert(f);
+  // --- test correctness ---
+
+  const size_t per_itr = cnt * (mlen + dlen);
+  state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
+
+  state.counters["recipients/s"] = benchmark::Counter(
+    static_cast<double>(cnt * state.iterations()), benchmark::Counter::kIsRate);
+}
+
+}
@@ -1,8 +1,16 @@
 #pragma once
 
+#include "bench_aead.hpp"
 #include "bench_ascon.hpp"
-#include "bench_isap_a_128.hpp"
-#include "bench_isap_a_128a.hpp"
-#include "bench_isap_k_128.hpp"
-#include "bench_isap_k_128a.hpp"
+#include "bench_chunked.hpp"
+#include "bench_fanout.hpp"
 #include "bench_keccak.hpp"
+#include "bench_key_cache.hpp"
+#include "bench_key_store.hpp"
+#include "bench_nonce.hpp"
+#include "bench_phases.hpp"
+#include "bench_pipeline.hpp"
+#include "bench_record.hpp"
+#include "bench_resumable.hpp"
+#include "bench_scheduler.hpp"
+#include "bench_stage_pipeline.hpp"
@@ -1,29 +1,112 @@
 #pragma once
 #include "keccak.hpp"
+#include "perf_events.hpp"
 #include "utils.hpp"
 #include <benchmark/benchmark.h>
+#include <cassert>
+#include <cstring>
 
 // Benchmark ISAP Authenticated Encryption with Associated Data
 namespace isap_bench {
 
 // Benchmarks Keccak-p[400] permutation on CPU based systems, for specified #
-// -of rounds
-template<const size_t ROUNDS>
+// -of rounds & # -of rounds per loop iteration ( 0 => fully unrolled, see
+// `ISAP_PERM_UNROLL` )
+template<const size_t ROUNDS, const size_t UNROLL = ISAP_PERM_UNROLL>
 static void
 keccak_permutation(benchmark::State& state)
 {
   uint16_t pstate[25];
   isap_utils::random_data<uint16_t>(pstate, 25);
 
+  perf_events events;
+  events.start();
+
   for (auto _ : state) {
-    keccak::permute<ROUNDS>(pstate);
+    keccak::permute<ROUNDS, UNROLL>(pstate);
 
     benchmark::DoNotOptimize(pstate);
     benchmark::ClobberMemory();
   }
 
+  events.stop();
+
+  constexpr size_t per_itr = sizeof(pstate);
+  state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
+}
+
+// Benchmarks Keccak-p[400] permutation on CPU based systems, for specified #
+// -of rounds, using either reference, lane by lane backend ( see `permute_ref`
+// ) or wide, in-place one ( see `permute_wide` ), no matter which one is
+// selected using `ISAP_KECCAK_WIDE`, so that both can be compared. Wide backend
+// is checked against reference one, on random states.
+template<const size_t ROUNDS, const bool wide>
+static void
+keccak_permutation_backend(benchmark::State& state)
+{
+  uint16_t pstate[25];
+  isap_utils::random_data<uint16_t>(pstate, 25);
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    if constexpr (wide) {
+      keccak::permute_wide<ROUNDS>(pstate);
+    } else {
+      keccak::permute_ref<ROUNDS>(pstate);
+    }
+
+    benchmark::DoNotOptimize(pstate);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  // --- test correctness ---
+  for (size_t i = 0; i < 64; i++) {
+    uint16_t st0[25], st1[25];
+    isap_utils::random_data<uint16_t>(st0, 25);
+    std::memcpy(st1, st0, sizeof(st0));
+
+    keccak::permute_ref<ROUNDS>(st0);
+    keccak::permute_wide<ROUNDS>(st1);
+
+    assert(std::memcmp(st0, st1, sizeof(st0)) == 0);
+  }
+  // --- test correctness ---
+
+  constexpr size_t per_itr = sizeof(pstate);
+  state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
+}
+
+// Benchmarks Keccak-p[400] permutation on eight states at once ( see
+// `state400_x8` ), for specified # -of rounds, where bytes processed count all
+// states, so that throughput can be compared against `keccak_permutation`.
+template<const size_t ROUNDS>
+static void
+keccak_permutation_x8(benchmark::State& state)
+{
+  keccak::state400_x8 pstate;
+  isap_utils::random_data<uint16_t>(&pstate.w[0][0], 25 * pstate.LANES);
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    pstate.permute<ROUNDS>();
+
+    benchmark::DoNotOptimize(pstate);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
   constexpr size_t per_itr = sizeof(pstate);
   state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
 }
 
 }
@@ -0,0 +1,244 @@
+#pragma once
+#include "aead.hpp"
+#include "key_cache.hpp"
+#include <benchmark/benchmark.h>
+#include <cassert>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+// Benchmark ISAP Authenticated Encryption with Associated Data
+namespace isap_bench {
+
+// Deterministically derives 16 -bytes secret key of tenant, standing in for a
+// key store, during benchmarks
+static inline bool
+tenant_key(const uint64_t tenant, uint8_t* const key)
+{
+  const uint64_t w0 = isap_key_cache::mix(tenant);
+  const uint64_t w1 = isap_key_cache::mix(w0 ^ tenant);
+
+  std::memcpy(key, &w0, 8);
+  std::memcpy(key + 8, &w1, 8);
+  return true;
+}
+
+// Picks tenants uniformly at random, out of N -many, using xorshift64 seeded
+// per thread
+struct tenant_picker_t
+{
+  uint64_t s;
+  const uint64_t n;
+
+  tenant_picker_t(const uint64_t seed, const uint64_t cnt)
+    : s(isap_key_cache::mix(seed + 1))
+    , n(cnt)
+  {}
+
+  inline uint64_t next()
+  {
+    s ^= s << 13;
+    s ^= s >> 7;
+    s ^= s << 17;
+    return s % n;
+  }
+};
+
+// Returns key context cache of given capacity, shared by all threads of a
+// benchmark run. Looked up before timed loop, so it doesn't skew measurements.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static inline isap_key_cache::cache_t<p, s_b, s_k, s_e, s_h>&
+shared_key_cache(const size_t capacity)
+{
+  using cache_t = isap_key_cache::cache_t<p, s_b, s_k, s_e, s_h>;
+
+  static std::mutex lock;
+  static std::map<size_t, std::unique_ptr<cache_t>> caches;
+
+  std::lock_guard<std::mutex> guard(lock);
+  auto& c = caches[capacity];
+  if (!c) {
+    c = std::make_unique<cache_t>(capacity);
+  }
+  return *c;
+}
+
+// Benchmarks encryption of 64 -bytes message of ISAP instance ( chosen by
+// template parameters ), under secret key of a randomly chosen tenant, whose
+// key context is looked up in cache shared by all benchmark threads. First
+// argument denotes # -of tenants, while second one denotes cache capacity.
+// Cache is warmed up, before timed loop.
+//
+// Reports hit rate of cache along with median & 99th percentile ( sampled )
+// lookup latency, in nanoseconds.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+key_cache_encrypt(benchmark::State& state)
+{
+  using ctx_t = isap_common::key_context_t<p, s_b, s_k, s_e, s_h>;
+
+  const uint64_t tenants = static_cast<uint64_t>(state.range(0));
+  const size_t capacity = static_cast<size_t>(state.range(1));
+
+  auto& cache = shared_key_cache<p, s_b, s_k, s_e, s_h>(capacity);
+
+  // warm up cache, so that measured hit rate is close to steady state one
+  if (state.thread_index() == 0) {
+    ctx_t ctx;
+    for (uint64_t t = 0; t < tenants; t++) {
+      cache.get(t, ctx, tenant_key);
+    }
+    cache.reset_stats();
+  }
+
+  tenant_picker_t picker(static_cast<uint64_t>(state.thread_index()), tenants);
+
+  uint8_t nonce[16]{};
+  uint8_t data[32]{};
+  uint8_t txt[64]{};
+  uint8_t enc[64];
+  uint8_t tag[16];
+
+  uint64_t tenant = 0;
+  bool ok = true;
+
+  for (auto _ : state) {
+    tenant = picker.next();
+
+    ctx_t ctx;
+    ok &= cache.get(tenant, ctx, tenant_key);
+
+    isap::encrypt<p, s_b, s_k, s_e, s_h>(
+      ctx, nonce, data, sizeof(data), txt, enc, sizeof(txt), tag);
+
+    benchmark::DoNotOptimize(enc);
+    benchmark::DoNotOptimize(tag);
+    benchmark::ClobberMemory();
+  }
+
+  // --- test correctness ---
+  assert(ok);
+
+  uint8_t key[16];
+  uint8_t dec[64];
+  tenant_key(tenant, key);
+
+  bool f0 = false;
+  f0 = isap::decrypt<p, s_b, s_k, s_e, s_h>(
+    key, nonce, tag, data, sizeof(data), enc, dec, sizeof(dec));
+
+  assert(f0);
+  assert(std::memcmp(txt, dec, sizeof(txt)) == 0);
+  // --- test correctness ---
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+
+  if (state.thread_index() == 0) {
+    const isap_key_cache::stats_t st = cache.stats();
+
+    state.counters["hit_rate"] = st.hit_rate();
+    state.counters["p50_ns"] = static_cast<double>(st.latency_quantile(.5));
+    state.counters["p99_ns"] = static_cast<double>(st.latency_quantile(.99));
+  }
+}
+
+// Benchmarks encryption of 64 -bytes message of ISAP instance ( chosen by
+// template parameters ), under secret key of a randomly chosen tenant, whose
+// key context is looked up in a mutex guarded hash map ( holding all tenants ),
+// shared by all benchmark threads, for comparing against lock-free cache. First
+// argument denotes # -of tenants.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+key_mutex_map_encrypt(benchmark::State& state)
+{
+  using ctx_t = isap_common::key_context_t<p, s_b, s_k, s_e, s_h>;
+
+  static std::mutex lock;
+  static std::unordered_map<uint64_t, ctx_t> ctxs;
+
+  const uint64_t tenants = static_cast<uint64_t>(state.range(0));
+  tenant_picker_t picker(static_cast<uint64_t>(state.thread_index()), tenants);
+
+  uint8_t nonce[16]{};
+  uint8_t data[32]{};
+  uint8_t txt[64]{};
+  uint8_t enc[64];
+  uint8_t tag[16];
+
+  for (auto _ : state) {
+    const uint64_t tenant = picker.next();
+
+    ctx_t ctx;
+    {
+      std::lock_guard<std::mutex> guard(lock);
+
+      auto it = ctxs.find(tenant);
+      if (it == ctxs.end()) {
+        uint8_t key[16];
+        tenant_key(tenant, key);
+        it = ctxs.emplace(tenant, ctx_t{ key }).first;
+      }
+      ctx = it->second;
+    }
+
+    isap::encrypt<p, s_b, s_k, s_e, s_h>(
+      ctx, nonce, data, sizeof(data), txt, enc, sizeof(txt), tag);
+
+    benchmark::DoNotOptimize(enc);
+    benchmark::DoNotOptimize(tag);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// Benchmarks encryption of 64 -bytes message of ISAP instance ( chosen by
+// template parameters ), under secret key of a randomly chosen tenant, where
+// key state is derived from secret key for each message i.e. without any cache.
+// First argument denotes # -of tenants.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+key_derive_encrypt(benchmark::State& state)
+{
+  const uint64_t tenants = static_cast<uint64_t>(state.range(0));
+  tenant_picker_t picker(static_cast<uint64_t>(state.thread_index()), tenants);
+
+  uint8_t nonce[16]{};
+  uint8_t data[32]{};
+  uint8_t txt[64]{};
+  uint8_t enc[64];
+  uint8_t tag[16];
+
+  for (auto _ : state) {
+    uint8_t key[16];
+    tenant_key(picker.next(), key);
+
+    isap::encrypt<p, s_b, s_k, s_e, s_h>(
+      key, nonce, data, sizeof(data), txt, enc, sizeof(txt), tag);
+
+    benchmark::DoNotOptimize(enc);
+    benchmark::DoNotOptimize(tag);
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+}
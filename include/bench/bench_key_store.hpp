@@ -0,0 +1,230 @@
+#pragma once
+#include "aead.hpp"
+#include "key_store.hpp"
+#include "perf_events.hpp"
+#include "utils.hpp"
+#include <benchmark/benchmark.h>
+#include <cassert>
+#include <unordered_map>
+
+// Benchmark ISAP Authenticated Encryption with Associated Data
+namespace isap_bench {
+
+// Key context store, used during benchmarks, which lives on tmpfs
+constexpr const char* KEY_STORE_PATH = "/dev/shm/isap_bench_key_store.bin";
+
+// Generates N random tenant identifiers & 16 -bytes secret keys
+static inline void
+random_tenants(const size_t n,
+               std::vector<uint64_t>& tenants,
+               std::vector<uint8_t>& keys)
+{
+  tenants.resize(n);
+  keys.resize(n * isap_common::knt_len);
+
+  isap_utils::random_data<uint64_t>(tenants.data(), n);
+  isap_utils::random_data<uint8_t>(keys.data(), keys.size());
+
+  // tenant identifiers must be distinct
+  for (size_t i = 0; i < n; i++) {
+    tenants[i] = (tenants[i] & ~uint64_t{ 0xfffff }) | i;
+  }
+}
+
+// Benchmarks time-to-first-encrypt of a restarting service, which holds key
+// contexts of N tenants in memory mapped store ( see include/key_store.hpp ) of
+// ISAP instance ( chosen by template parameters ), where first argument denotes
+// # -of tenants. Each iteration opens store, looks up a random tenant &
+// encrypts 64 -bytes message under its key context, before closing store.
+//
+// Note, store lives on tmpfs, so it's always in page cache.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+key_store_first_encrypt(benchmark::State& state)
+{
+  using store_t = isap_key_store::store_t<p, s_b, s_k, s_e, s_h>;
+
+  const size_t n = static_cast<size_t>(state.range(0));
+
+  std::vector<uint64_t> tenants;
+  std::vector<uint8_t> keys;
+  random_tenants(n, tenants, keys);
+
+  if (!store_t::write(KEY_STORE_PATH, tenants.data(), keys.data(), n)) {
+    state.SkipWithError("can't write key context store on /dev/shm");
+    return;
+  }
+
+  uint8_t nonce[16]{};
+  uint8_t data[32]{};
+  uint8_t txt[64]{};
+  uint8_t enc[64];
+  uint8_t tag[16];
+
+  size_t idx = 0;
+  bool ok = true;
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    idx = (idx * 6364136223846793005ul + 1442695040888963407ul) % n;
+
+    store_t store;
+    ok &= store.open(KEY_STORE_PATH);
+
+    const auto* const ctx = store.find(tenants[idx]);
+    ok &= ctx != nullptr;
+
+    if (ctx != nullptr) {
+      isap::encrypt<p, s_b, s_k, s_e, s_h>(
+        *ctx, nonce, data, sizeof(data), txt, enc, sizeof(txt), tag);
+    }
+
+    benchmark::DoNotOptimize(enc);
+    benchmark::DoNotOptimize(tag);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  // --- test correctness ---
+  assert(ok);
+
+  {
+    store_t store;
+    ok &= store.open(KEY_STORE_PATH);
+    ok &= store.size() == n;
+    ok &= store.verify_all();
+  }
+  assert(ok);
+
+  uint8_t dec[64];
+  bool f0 = false;
+  f0 = isap::decrypt<p, s_b, s_k, s_e, s_h>(keys.data() + idx * 16,
+                                            nonce,
+                                            tag,
+                                            data,
+                                            sizeof(data),
+                                            enc,
+                                            dec,
+                                            sizeof(dec));
+
+  assert(f0);
+  assert(std::memcmp(txt, dec, sizeof(txt)) == 0);
+  // --- test correctness ---
+
+  events.report(state, sizeof(txt));
+  std::remove(KEY_STORE_PATH);
+}
+
+// Benchmarks time-to-first-encrypt of a restarting service, which rebuilds key
+// contexts of all N tenants ( into a hash map ) before serving traffic, using
+// ISAP instance ( chosen by template parameters ), where first argument denotes
+// # -of tenants, for comparing against memory mapped store.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+key_rebuild_first_encrypt(benchmark::State& state)
+{
+  using ctx_t = isap_common::key_context_t<p, s_b, s_k, s_e, s_h>;
+
+  const size_t n = static_cast<size_t>(state.range(0));
+
+  std::vector<uint64_t> tenants;
+  std::vector<uint8_t> keys;
+  random_tenants(n, tenants, keys);
+
+  uint8_t nonce[16]{};
+  uint8_t data[32]{};
+  uint8_t txt[64]{};
+  uint8_t enc[64];
+  uint8_t tag[16];
+
+  size_t idx = 0;
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    idx = (idx * 6364136223846793005ul + 1442695040888963407ul) % n;
+
+    std::unordered_map<uint64_t, ctx_t> ctxs;
+    ctxs.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+      ctxs.emplace(tenants[i], ctx_t{ keys.data() + i * 16 });
+    }
+
+    isap::encrypt<p, s_b, s_k, s_e, s_h>(ctxs.at(tenants[idx]),
+                                         nonce,
+                                         data,
+                                         sizeof(data),
+                                         txt,
+                                         enc,
+                                         sizeof(txt),
+                                         tag);
+
+    benchmark::DoNotOptimize(enc);
+    benchmark::DoNotOptimize(tag);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+  events.report(state, sizeof(txt));
+}
+
+// Benchmarks checking integrity of every entry of memory mapped key context
+// store ( see include/key_store.hpp ) of ISAP instance ( chosen by template
+// parameters ), where first argument denotes # -of tenants
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+key_store_verify_all(benchmark::State& state)
+{
+  using store_t = isap_key_store::store_t<p, s_b, s_k, s_e, s_h>;
+
+  const size_t n = static_cast<size_t>(state.range(0));
+
+  std::vector<uint64_t> tenants;
+  std::vector<uint8_t> keys;
+  random_tenants(n, tenants, keys);
+
+  store_t store;
+  if (!store_t::write(KEY_STORE_PATH, tenants.data(), keys.data(), n) ||
+      !store.open(KEY_STORE_PATH)) {
+    state.SkipWithError("can't write key context store on /dev/shm");
+    return;
+  }
+
+  bool ok = true;
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    ok &= store.verify_all();
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  // --- test correctness ---
+  assert(ok);
+  // --- test correctness ---
+
+  state.SetBytesProcessed(static_cast<int64_t>(store.len * state.iterations()));
+  events.report(state, store.len);
+  std::remove(KEY_STORE_PATH);
+}
+
+}
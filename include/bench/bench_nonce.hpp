@@ -0,0 +1,152 @@
+#pragma once
+#include "aead.hpp"
+#include "nonce.hpp"
+#include "utils.hpp"
+#include <benchmark/benchmark.h>
+#include <cassert>
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Benchmark ISAP Authenticated Encryption with Associated Data
+namespace isap_bench {
+
+// Returns sequencer with given block length, shared by all threads of a
+// benchmark run. Looked up before timed loop, so it doesn't skew measurements.
+static inline isap_nonce::sequencer_t&
+shared_sequencer(const uint64_t block)
+{
+  static std::mutex lock;
+  static std::map<uint64_t, std::unique_ptr<isap_nonce::sequencer_t>> seqs;
+
+  std::lock_guard<std::mutex> guard(lock);
+  auto& seq = seqs[block];
+  if (!seq) {
+    seq = std::make_unique<isap_nonce::sequencer_t>(block);
+  }
+  return *seq;
+}
+
+// Benchmarks encryption of ISAP instance ( chosen by template parameters ),
+// where nonces are handed out by lock-free sequencer ( see include/nonce.hpp ),
+// shared by all benchmark threads. First argument denotes message length in
+// bytes, while second one denotes # -of nonces a thread reserves at once.
+//
+// With block length of 1, each encryption bumps shared atomic counter, while
+// with large enough blocks, cost of contention should be amortized to nearly
+// zero, so that throughput scales with # -of threads.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+nonce_sequencer_encrypt(benchmark::State& state)
+{
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const uint64_t block = static_cast<uint64_t>(state.range(1));
+
+  isap_nonce::sequencer_t& seq = shared_sequencer(block);
+
+  uint8_t key[16];
+  uint8_t nonce[16];
+  uint8_t data[32];
+  uint8_t tag[16];
+  std::vector<uint8_t> txt(mlen);
+  std::vector<uint8_t> enc(mlen);
+  std::vector<uint8_t> dec(mlen);
+
+  std::memset(key, 0x5a, sizeof(key));
+  isap_utils::random_data<uint8_t>(data, sizeof(data));
+  isap_utils::random_data<uint8_t>(txt.data(), mlen);
+
+  bool ok = true;
+  for (auto _ : state) {
+    ok &= isap_nonce::encrypt_auto_nonce<p, s_b, s_k, s_e, s_h>(
+      seq, key, data, sizeof(data), txt.data(), enc.data(), mlen, tag, nonce);
+
+    benchmark::DoNotOptimize(enc.data());
+    benchmark::DoNotOptimize(tag);
+    benchmark::ClobberMemory();
+  }
+
+  // --- test correctness ---
+  assert(ok);
+
+  bool f0 = false;
+  f0 = isap::decrypt<p, s_b, s_k, s_e, s_h>(
+    key, nonce, tag, data, sizeof(data), enc.data(), dec.data(), mlen);
+
+  assert(f0);
+  assert(txt == dec);
+  // --- test correctness ---
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  state.SetBytesProcessed(static_cast<int64_t>(mlen * state.iterations()));
+}
+
+// Benchmarks encryption of ISAP instance ( chosen by template parameters ),
+// where nonces are derived from a counter, shared by all benchmark threads &
+// guarded by a mutex, for comparing against lock-free sequencer. First argument
+// denotes message length in bytes.
+//
+// Note, mutex is held only while bumping counter, not during encryption.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+nonce_mutex_encrypt(benchmark::State& state)
+{
+  static std::mutex lock;
+  static uint64_t ctr = 0;
+
+  const size_t mlen = static_cast<size_t>(state.range(0));
+
+  uint8_t key[16];
+  uint8_t nonce[16];
+  uint8_t data[32];
+  uint8_t tag[16];
+  std::vector<uint8_t> txt(mlen);
+  std::vector<uint8_t> enc(mlen);
+  std::vector<uint8_t> dec(mlen);
+
+  std::memset(key, 0x5a, sizeof(key));
+  std::memset(nonce, 0, sizeof(nonce));
+  isap_utils::random_data<uint8_t>(data, sizeof(data));
+  isap_utils::random_data<uint8_t>(txt.data(), mlen);
+
+  for (auto _ : state) {
+    uint64_t c;
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      c = ctr++;
+    }
+
+    for (size_t i = 0; i < 8; i++) {
+      nonce[8 + i] = static_cast<uint8_t>(c >> ((7 - i) << 3));
+    }
+
+    isap::encrypt<p, s_b, s_k, s_e, s_h>(
+      key, nonce, data, sizeof(data), txt.data(), enc.data(), mlen, tag);
+
+    benchmark::DoNotOptimize(enc.data());
+    benchmark::DoNotOptimize(tag);
+    benchmark::ClobberMemory();
+  }
+
+  // --- test correctness ---
+  bool f0 = false;
+  f0 = isap::decrypt<p, s_b, s_k, s_e, s_h>(
+    key, nonce, tag, data, sizeof(data), enc.data(), dec.data(), mlen);
+
+  assert(f0);
+  assert(txt == dec);
+  // --- test correctness ---
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  state.SetBytesProcessed(static_cast<int64_t>(mlen * state.iterations()));
+}
+
+}
@@ -0,0 +1,203 @@
+#pragma once
+#include "common.hpp"
+#include "cost_model.hpp"
+#include "perf_events.hpp"
+#include "utils.hpp"
+#include <benchmark/benchmark.h>
+#include <cstring>
+
+// Benchmark ISAP Authenticated Encryption with Associated Data
+namespace isap_bench {
+
+// Benchmarks `rekeying` phase of ISAP instance ( chosen by template parameters
+// ), deriving either encryption or authentication session key, on CPU based
+// systems
+template<const isap_common::perm_t p,
+         const isap_common::rk_flag_t f,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+phase_rekeying(benchmark::State& state)
+{
+  using namespace isap_common;
+
+  constexpr size_t slen = PERM_STATE_LEN[static_cast<uint32_t>(p)];
+
+  uint8_t key[knt_len];
+  uint8_t y[knt_len];
+  uint8_t skey[slen - knt_len];
+
+  isap_utils::random_data<uint8_t>(key, sizeof(key));
+  isap_utils::random_data<uint8_t>(y, sizeof(y));
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    rekeying<p, f, s_b, s_k, s_e, s_h>(key, y, skey);
+
+    benchmark::DoNotOptimize(skey);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  constexpr size_t per_itr = sizeof(y);
+  state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
+  report_rounds(state, rekeying_rounds<s_b, s_k>());
+}
+
+// Benchmarks key stream squeezing phase of encryption sponge of ISAP instance (
+// chosen by template parameters ), excluding `rekeying`, on CPU based systems,
+// where first argument denotes message length in bytes
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+phase_enc_keystream(benchmark::State& state)
+{
+  using namespace isap_common;
+
+  const size_t mlen = static_cast<size_t>(state.range(0));
+
+  uint8_t key[knt_len];
+  uint8_t nonce[knt_len];
+  state_t<p> init;
+  state_t<p> pstate;
+
+  uint8_t* txt = static_cast<uint8_t*>(std::malloc(mlen));
+  uint8_t* enc = static_cast<uint8_t*>(std::malloc(mlen));
+
+  isap_utils::random_data<uint8_t>(key, sizeof(key));
+  isap_utils::random_data<uint8_t>(nonce, sizeof(nonce));
+  isap_utils::random_data<uint8_t>(txt, mlen);
+
+  enc_init<p, s_b, s_k, s_e, s_h>(key, nonce, init);
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    pstate = init;
+    enc_squeeze<p, s_b, s_k, s_e, s_h>(pstate, txt, enc, mlen);
+
+    benchmark::DoNotOptimize(pstate);
+    benchmark::DoNotOptimize(enc);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  const size_t per_itr = mlen;
+  state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
+  report_rounds(state, keystream_rounds<p, s_e>(mlen));
+
+  std::free(txt);
+  std::free(enc);
+}
+
+// Benchmarks associated data & cipher text absorption phase of suffix-MAC
+// sponge of ISAP instance ( chosen by template parameters ), excluding
+// initialization & finalization, on CPU based systems, where first argument
+// denotes associated data length & second one denotes cipher text length, both
+// in bytes
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+phase_mac_absorb(benchmark::State& state)
+{
+  using namespace isap_common;
+
+  const size_t dlen = static_cast<size_t>(state.range(0));
+  const size_t clen = static_cast<size_t>(state.range(1));
+
+  uint8_t nonce[knt_len];
+  state_t<p> init;
+  state_t<p> pstate;
+
+  uint8_t* data = static_cast<uint8_t*>(std::malloc(dlen));
+  uint8_t* enc = static_cast<uint8_t*>(std::malloc(clen));
+
+  isap_utils::random_data<uint8_t>(nonce, sizeof(nonce));
+  isap_utils::random_data<uint8_t>(data, dlen);
+  isap_utils::random_data<uint8_t>(enc, clen);
+
+  mac_init<p, s_b, s_k, s_e, s_h>(nonce, init);
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    pstate = init;
+    mac_absorb<p, s_b, s_k, s_e, s_h>(pstate, data, dlen);
+    mac_domain_separate<p, s_b, s_k, s_e, s_h>(pstate);
+    mac_absorb<p, s_b, s_k, s_e, s_h>(pstate, enc, clen);
+
+    benchmark::DoNotOptimize(pstate);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  const size_t per_itr = dlen + clen;
+  state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
+  report_rounds(state, mac_absorb_rounds<p, s_h>(dlen, clen));
+
+  std::free(data);
+  std::free(enc);
+}
+
+// Benchmarks finalization phase of suffix-MAC sponge of ISAP instance ( chosen
+// by template parameters ) i.e. authentication `rekeying` followed by final
+// tag permutation, on CPU based systems
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+phase_mac_finalize(benchmark::State& state)
+{
+  using namespace isap_common;
+
+  uint8_t key[knt_len];
+  uint8_t nonce[knt_len];
+  uint8_t tag[knt_len];
+  state_t<p> init;
+  state_t<p> pstate;
+
+  isap_utils::random_data<uint8_t>(key, sizeof(key));
+  isap_utils::random_data<uint8_t>(nonce, sizeof(nonce));
+
+  mac_init<p, s_b, s_k, s_e, s_h>(nonce, init);
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    pstate = init;
+    mac_finalize<p, s_b, s_k, s_e, s_h>(key, pstate, tag);
+
+    benchmark::DoNotOptimize(tag);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  constexpr size_t per_itr = sizeof(tag);
+  state.SetBytesProcessed(static_cast<int64_t>(per_itr * state.iterations()));
+  events.report(state, per_itr);
+  report_rounds(state, rekeying_rounds<s_b, s_k>() + s_h);
+}
+
+}
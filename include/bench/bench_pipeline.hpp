@@ -0,0 +1,147 @@
+#pragma once
+#include "pipeline.hpp"
+#include "utils.hpp"
+#include <benchmark/benchmark.h>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+
+// Benchmark ISAP Authenticated Encryption with Associated Data
+namespace isap_bench {
+
+// Name templates ( see mkstemp(3) ) of input & output files of streaming
+// pipeline benchmark, which live on tmpfs, so that I/O stages are never
+// bottleneck, while concurrently running benchmarks never share files
+constexpr const char* PIPELINE_IN = "/dev/shm/isap_bench_pipeline_in.XXXXXX";
+constexpr const char* PIPELINE_OUT = "/dev/shm/isap_bench_pipeline_out.XXXXXX";
+
+// Benchmarks streaming I/O pipeline ( see include/pipeline.hpp ), encrypting a
+// file on tmpfs using ISAP instance ( chosen by template parameters ), where
+// first argument denotes file length, second one denotes chunk length, both in
+// bytes & third one denotes # -of buffers in ring.
+//
+// Along with end-to-end throughput, throughput of each stage ( when busy ) &
+// fraction of wall clock time it was busy are reported. Crypto stage should be
+// the only one being busy ~100% of time.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+pipeline_encrypt(benchmark::State& state)
+{
+  using namespace isap_pipeline;
+
+  const size_t flen = static_cast<size_t>(state.range(0));
+  const uint32_t clen = static_cast<uint32_t>(state.range(1));
+  const size_t nbufs = static_cast<size_t>(state.range(2));
+
+  uint8_t key[16];
+  uint8_t nonce[16];
+
+  isap_utils::random_data<uint8_t>(key, sizeof(key));
+  isap_utils::random_data<uint8_t>(nonce, sizeof(nonce));
+
+  std::string in_path = PIPELINE_IN;
+  std::string out_path = PIPELINE_OUT;
+
+  {
+    std::vector<uint8_t> txt(flen);
+    isap_utils::random_data<uint8_t>(txt.data(), flen);
+
+    const int tfd = mkstemp(in_path.data());
+    if (tfd < 0) {
+      state.SkipWithError("can't create input file on /dev/shm");
+      return;
+    }
+
+    FILE* const fd = fdopen(tfd, "wb");
+    if (fd == nullptr) {
+      close(tfd);
+      std::remove(in_path.c_str());
+      state.SkipWithError("can't create input file on /dev/shm");
+      return;
+    }
+
+    const bool wrote = std::fwrite(txt.data(), 1, flen, fd) == flen;
+    if (std::fclose(fd) != 0 || !wrote) {
+      std::remove(in_path.c_str());
+      state.SkipWithError("can't write input file on /dev/shm");
+      return;
+    }
+  }
+
+  {
+    const int tfd = mkstemp(out_path.data());
+    if (tfd < 0) {
+      std::remove(in_path.c_str());
+      state.SkipWithError("can't create output file on /dev/shm");
+      return;
+    }
+    close(tfd);
+  }
+
+  stats_t st, sum;
+  bool ok = true;
+
+  for (auto _ : state) {
+    const int ifd = open(in_path.c_str(), O_RDONLY);
+    const int ofd = open(out_path.c_str(), O_WRONLY | O_TRUNC);
+
+    if (ifd < 0 || ofd < 0) {
+      if (ifd >= 0) {
+        close(ifd);
+      }
+      if (ofd >= 0) {
+        close(ofd);
+      }
+
+      state.SkipWithError("can't open input/ output file on /dev/shm");
+      break;
+    }
+
+    ok &= encrypt_fd<p, s_b, s_k, s_e, s_h>(
+      key, nonce, clen, ifd, ofd, nbufs, st);
+
+    close(ifd);
+    close(ofd);
+
+    for (auto [dst, src] : { std::pair{ &sum.read, &st.read },
+                             std::pair{ &sum.crypto, &st.crypto },
+                             std::pair{ &sum.write, &st.write } }) {
+      dst->bytes += src->bytes;
+      dst->busy_ns += src->busy_ns;
+      dst->wait_ns += src->wait_ns;
+    }
+    sum.wall_ns += st.wall_ns;
+  }
+
+  if (state.error_occurred()) {
+    std::remove(in_path.c_str());
+    std::remove(out_path.c_str());
+    return;
+  }
+
+  // --- test correctness ---
+  assert(ok);
+  assert(st.read.bytes == flen);
+  assert(st.crypto.bytes == flen);
+  // --- test correctness ---
+
+  state.SetBytesProcessed(static_cast<int64_t>(flen * state.iterations()));
+  state.counters["read_MB/s"] = sum.read.throughput() / 1e6;
+  state.counters["crypto_MB/s"] = sum.crypto.throughput() / 1e6;
+  state.counters["write_MB/s"] = sum.write.throughput() / 1e6;
+  state.counters["read_busy"] = sum.read.utilization(sum.wall_ns);
+  state.counters["crypto_busy"] = sum.crypto.utilization(sum.wall_ns);
+  state.counters["write_busy"] = sum.write.utilization(sum.wall_ns);
+
+  std::remove(in_path.c_str());
+  std::remove(out_path.c_str());
+}
+
+}
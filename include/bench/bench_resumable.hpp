@@ -0,0 +1,89 @@
+#pragma once
+#include "aead.hpp"
+#include "perf_events.hpp"
+#include "resumable.hpp"
+#include "utils.hpp"
+#include <benchmark/benchmark.h>
+#include <cassert>
+
+// Benchmark ISAP Authenticated Encryption with Associated Data
+namespace isap_bench {
+
+// Benchmarks resumable encryption ( see include/resumable.hpp ) of ISAP
+// instance ( chosen by template parameters ), where first argument denotes
+// message length & second one denotes length of each update, both in bytes.
+// After each update, mid-stream state is exported as checkpoint blob &
+// encryption is resumed from it, as a preempted worker would do, so that
+// checkpointing overhead can be compared against one-shot encryption.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+resumable_encrypt(benchmark::State& state)
+{
+  using encryptor_t = isap_resumable::encryptor_t<p, s_b, s_k, s_e, s_h>;
+
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const size_t ulen = static_cast<size_t>(state.range(1));
+
+  uint8_t key[16];
+  uint8_t nonce[16];
+  uint8_t data[32];
+  uint8_t tag[16];
+  uint8_t blob[encryptor_t::BLOB_LEN];
+  std::vector<uint8_t> txt(mlen);
+  std::vector<uint8_t> enc(mlen);
+  std::vector<uint8_t> dec(mlen);
+
+  isap_utils::random_data<uint8_t>(key, sizeof(key));
+  isap_utils::random_data<uint8_t>(nonce, sizeof(nonce));
+  isap_utils::random_data<uint8_t>(data, sizeof(data));
+  isap_utils::random_data<uint8_t>(txt.data(), mlen);
+
+  bool ok = true;
+
+  perf_events events;
+  events.start();
+
+  for (auto _ : state) {
+    encryptor_t e;
+    e.init(key, nonce, data, sizeof(data));
+
+    size_t off = 0;
+    while (off < mlen) {
+      const size_t len = std::min(ulen, mlen - off);
+      e.update(txt.data() + off, enc.data() + off, len);
+      off += len;
+
+      e.checkpoint(blob);
+      ok &= e.resume(key, blob);
+    }
+
+    e.finalize(tag);
+
+    benchmark::DoNotOptimize(enc.data());
+    benchmark::DoNotOptimize(tag);
+    benchmark::ClobberMemory();
+  }
+
+  events.stop();
+
+  // --- test correctness ---
+  assert(ok);
+
+  bool f0 = false;
+  f0 = isap::decrypt<p, s_b, s_k, s_e, s_h>(
+    key, nonce, tag, data, sizeof(data), enc.data(), dec.data(), mlen);
+
+  assert(f0);
+  assert(txt == dec);
+  // --- test correctness ---
+
+  state.SetBytesProcessed(static_cast<int64_t>(mlen * state.iterations()));
+  events.report(state, mlen);
+  state.counters["checkpoints"] = static_cast<double>((mlen + ulen - 1) / ulen);
+}
+
+}
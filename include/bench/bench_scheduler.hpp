@@ -0,0 +1,162 @@
+#pragma once
+#include "aead.hpp"
+#include "scheduler.hpp"
+#include "utils.hpp"
+#include <benchmark/benchmark.h>
+#include <cassert>
+#include <memory>
+
+// Benchmark ISAP Authenticated Encryption with Associated Data
+namespace isap_bench {
+
+// Benchmarks encryption of 64 -bytes latency-critical messages of ISAP instance
+// ( chosen by template parameters ), submitted to priority-aware scheduler (
+// see include/scheduler.hpp ), while its workers are kept busy with bulk jobs.
+// First argument denotes bulk message length ( 0 => no bulk load ), second one
+// denotes slice length ( 0 => bulk jobs are not sliced ), both in bytes, while
+// third one denotes # -of worker threads. As many bulk jobs as there are
+// workers are kept in flight by a feeder thread, during timed loop.
+//
+// Reports median & 99th percentile queueing delay of latency-critical jobs, in
+// nanoseconds, along with bulk throughput. With slicing, 99th percentile delay
+// should stay flat, no matter how long bulk messages are.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+scheduler_mixed_load(benchmark::State& state)
+{
+  using namespace isap_sched;
+  using sched_t = scheduler_t<p, s_b, s_k, s_e, s_h>;
+  using job_t = typename sched_t::job_t;
+
+  const size_t blen = static_cast<size_t>(state.range(0));
+  const size_t slice = static_cast<size_t>(state.range(1));
+  const size_t nthreads = static_cast<size_t>(state.range(2));
+
+  constexpr size_t mlen = 64;
+
+  uint8_t key[16];
+  uint8_t nonce[16];
+  uint8_t data[32];
+  uint8_t txt[mlen];
+  uint8_t enc[mlen];
+  uint8_t dec[mlen];
+  uint8_t tag[16];
+
+  isap_utils::random_data<uint8_t>(key, sizeof(key));
+  isap_utils::random_data<uint8_t>(nonce, sizeof(nonce));
+  isap_utils::random_data<uint8_t>(data, sizeof(data));
+  isap_utils::random_data<uint8_t>(txt, sizeof(txt));
+
+  std::vector<uint8_t> btxt(blen);
+  std::vector<uint8_t> benc(nthreads * blen);
+  std::vector<uint8_t> btag(nthreads * 16);
+  isap_utils::random_data<uint8_t>(btxt.data(), blen);
+
+  sched_t sched(nthreads, slice);
+
+  std::unique_ptr<job_t[]> bulk(new job_t[nthreads]);
+  for (size_t i = 0; i < nthreads; i++) {
+    bulk[i].key = key;
+    bulk[i].nonce = nonce;
+    bulk[i].data = data;
+    bulk[i].dlen = sizeof(data);
+    bulk[i].msg = btxt.data();
+    bulk[i].enc = benc.data() + i * blen;
+    bulk[i].mlen = blen;
+    bulk[i].tag = btag.data() + i * 16;
+  }
+
+  std::atomic<bool> stop{ false };
+  std::thread feeder;
+
+  if (blen > 0) {
+    for (size_t i = 0; i < nthreads; i++) {
+      sched.submit(bulk[i], prio_t::BULK);
+    }
+
+    feeder = std::thread([&]() {
+      while (!stop.load(std::memory_order_relaxed)) {
+        for (size_t i = 0; i < nthreads; i++) {
+          sched.wait(bulk[i]);
+          if (!stop.load(std::memory_order_relaxed)) {
+            sched.submit(bulk[i], prio_t::BULK);
+          }
+        }
+      }
+    });
+  }
+
+  job_t job;
+  job.key = key;
+  job.nonce = nonce;
+  job.data = data;
+  job.dlen = sizeof(data);
+  job.msg = txt;
+  job.enc = enc;
+  job.mlen = mlen;
+  job.tag = tag;
+
+  sched.reset_stats();
+  const uint64_t beg = now_ns();
+
+  for (auto _ : state) {
+    sched.submit(job, prio_t::LATENCY);
+    sched.wait(job);
+
+    benchmark::DoNotOptimize(enc);
+    benchmark::DoNotOptimize(tag);
+    benchmark::ClobberMemory();
+  }
+
+  const uint64_t wall = now_ns() - beg;
+  const stats_t st = sched.stats();
+
+  stop.store(true, std::memory_order_relaxed);
+  if (feeder.joinable()) {
+    feeder.join();
+  }
+  for (size_t i = 0; i < nthreads && blen > 0; i++) {
+    sched.wait(bulk[i]);
+  }
+
+  // --- test correctness ---
+  bool f0 = false;
+  f0 = isap::decrypt<p, s_b, s_k, s_e, s_h>(
+    key, nonce, tag, data, sizeof(data), enc, dec, mlen);
+
+  assert(f0);
+  assert(std::memcmp(txt, dec, sizeof(txt)) == 0);
+
+  if (blen > 0) {
+    std::vector<uint8_t> bdec(blen);
+
+    bool f1 = false;
+    f1 = isap::decrypt<p, s_b, s_k, s_e, s_h>(key,
+                                              nonce,
+                                              btag.data(),
+                                              data,
+                                              sizeof(data),
+                                              benc.data(),
+                                              bdec.data(),
+                                              blen);
+
+    assert(f1);
+    assert(btxt == bdec);
+  }
+  // --- test correctness ---
+
+  const class_stats_t& lat = st[prio_t::LATENCY];
+  const class_stats_t& bulk_st = st[prio_t::BULK];
+
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+  state.counters["p50_ns"] = static_cast<double>(lat.delay_quantile(.5));
+  state.counters["p99_ns"] = static_cast<double>(lat.delay_quantile(.99));
+  state.counters["bulk_bytes_per_second"] =
+    wall == 0 ? 0. : static_cast<double>(bulk_st.bytes) * 1e9 / wall;
+}
+
+}
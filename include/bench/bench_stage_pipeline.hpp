@@ -0,0 +1,200 @@
+#pragma once
+#include "aead.hpp"
+#include "chunked.hpp"
+#include "stage_pipeline.hpp"
+#include "utils.hpp"
+#include <benchmark/benchmark.h>
+#include <cassert>
+
+// Benchmark ISAP Authenticated Encryption with Associated Data
+namespace isap_bench {
+
+// # -of records, encrypted in each iteration of record stream benchmarks
+constexpr size_t STREAM_RECORDS = 1024;
+
+// Byte length of associated data of each record of stream
+constexpr size_t STREAM_AD_LEN = 16;
+
+// Records of stream, along with buffers they point to, where each record gets
+// its own nonce
+struct stream_records_t
+{
+  std::vector<uint8_t> nonces;
+  std::vector<uint8_t> data;
+  std::vector<uint8_t> txt;
+  std::vector<uint8_t> enc;
+  std::vector<uint8_t> tags;
+  std::vector<isap_stage_pipeline::record_t> recs;
+
+  stream_records_t(const size_t n, const size_t mlen)
+    : nonces(n * 16)
+    , data(n * STREAM_AD_LEN)
+    , txt(n * mlen)
+    , enc(n * mlen)
+    , tags(n * 16)
+    , recs(n)
+  {
+    isap_utils::random_data<uint8_t>(nonces.data(), nonces.size());
+    isap_utils::random_data<uint8_t>(data.data(), data.size());
+    isap_utils::random_data<uint8_t>(txt.data(), txt.size());
+
+    for (size_t i = 0; i < n; i++) {
+      recs[i] = isap_stage_pipeline::record_t{
+        nonces.data() + i * 16, data.data() + i * STREAM_AD_LEN,
+        STREAM_AD_LEN,          txt.data() + i * mlen,
+        enc.data() + i * mlen,  mlen,
+        tags.data() + i * 16
+      };
+    }
+  }
+
+  // Checks whether all records decrypt back to their plain text
+  template<const isap_common::perm_t p,
+           const size_t s_b,
+           const size_t s_k,
+           const size_t s_e,
+           const size_t s_h>
+  inline bool verify(const uint8_t* const key) const
+  {
+    bool ok = true;
+    for (const auto& r : recs) {
+      std::vector<uint8_t> dec(r.mlen);
+
+      ok &= isap::decrypt<p, s_b, s_k, s_e, s_h>(
+        key, r.nonce, r.tag, r.data, r.dlen, r.enc, dec.data(), r.mlen);
+      ok &= std::memcmp(dec.data(), r.msg, r.mlen) == 0;
+    }
+    return ok;
+  }
+};
+
+// Benchmarks encryption of a stream of records of ISAP instance ( chosen by
+// template parameters ), one after another on calling thread, where first
+// argument denotes record length in bytes
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+stream_single_thread(benchmark::State& state)
+{
+  using ctx_t = isap_common::key_context_t<p, s_b, s_k, s_e, s_h>;
+
+  const size_t mlen = static_cast<size_t>(state.range(0));
+
+  uint8_t key[16];
+  isap_utils::random_data<uint8_t>(key, sizeof(key));
+
+  const ctx_t ctx{ key };
+  stream_records_t rs(STREAM_RECORDS, mlen);
+
+  for (auto _ : state) {
+    for (const auto& r : rs.recs) {
+      isap::encrypt<p, s_b, s_k, s_e, s_h>(
+        ctx, r.nonce, r.data, r.dlen, r.msg, r.enc, r.mlen, r.tag);
+    }
+
+    benchmark::DoNotOptimize(rs.enc.data());
+    benchmark::DoNotOptimize(rs.tags.data());
+    benchmark::ClobberMemory();
+  }
+
+  // --- test correctness ---
+  assert((rs.verify<p, s_b, s_k, s_e, s_h>(key)));
+  // --- test correctness ---
+
+  const size_t n = STREAM_RECORDS * static_cast<size_t>(state.iterations());
+  state.SetItemsProcessed(static_cast<int64_t>(n));
+  state.SetBytesProcessed(static_cast<int64_t>(n * mlen));
+}
+
+// Benchmarks encryption of a stream of records of ISAP instance ( chosen by
+// template parameters ), where whole records are spread over a pool of threads
+// ( see `isap_chunked::parallel_for` ), for comparing against stage-pipelined
+// encryption. First argument denotes record length in bytes, while second one
+// denotes # -of threads.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+stream_pool(benchmark::State& state)
+{
+  using ctx_t = isap_common::key_context_t<p, s_b, s_k, s_e, s_h>;
+
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const size_t nthreads = static_cast<size_t>(state.range(1));
+
+  uint8_t key[16];
+  isap_utils::random_data<uint8_t>(key, sizeof(key));
+
+  const ctx_t ctx{ key };
+  stream_records_t rs(STREAM_RECORDS, mlen);
+
+  for (auto _ : state) {
+    isap_chunked::parallel_for(STREAM_RECORDS, nthreads, [&](const size_t i) {
+      const auto& r = rs.recs[i];
+      isap::encrypt<p, s_b, s_k, s_e, s_h>(
+        ctx, r.nonce, r.data, r.dlen, r.msg, r.enc, r.mlen, r.tag);
+    });
+
+    benchmark::DoNotOptimize(rs.enc.data());
+    benchmark::DoNotOptimize(rs.tags.data());
+    benchmark::ClobberMemory();
+  }
+
+  // --- test correctness ---
+  assert((rs.verify<p, s_b, s_k, s_e, s_h>(key)));
+  // --- test correctness ---
+
+  const size_t n = STREAM_RECORDS * static_cast<size_t>(state.iterations());
+  state.SetItemsProcessed(static_cast<int64_t>(n));
+  state.SetBytesProcessed(static_cast<int64_t>(n * mlen));
+}
+
+// Benchmarks stage-pipelined encryption ( see include/stage_pipeline.hpp ) of a
+// stream of records of ISAP instance ( chosen by template parameters ), where
+// first argument denotes record length in bytes, while second one denotes # -of
+// slots in ring. Stage threads are started before timed loop.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+stream_stage_pipeline(benchmark::State& state)
+{
+  using stream_t = isap_stage_pipeline::stream_t<p, s_b, s_k, s_e, s_h>;
+
+  const size_t mlen = static_cast<size_t>(state.range(0));
+  const size_t nslots = static_cast<size_t>(state.range(1));
+
+  uint8_t key[16];
+  isap_utils::random_data<uint8_t>(key, sizeof(key));
+
+  stream_records_t rs(STREAM_RECORDS, mlen);
+  stream_t stream(key, nslots);
+
+  for (auto _ : state) {
+    for (const auto& r : rs.recs) {
+      stream.push(r);
+    }
+    stream.drain();
+
+    benchmark::DoNotOptimize(rs.enc.data());
+    benchmark::DoNotOptimize(rs.tags.data());
+    benchmark::ClobberMemory();
+  }
+
+  // --- test correctness ---
+  assert((rs.verify<p, s_b, s_k, s_e, s_h>(key)));
+  // --- test correctness ---
+
+  const size_t n = STREAM_RECORDS * static_cast<size_t>(state.iterations());
+  state.SetItemsProcessed(static_cast<int64_t>(n));
+  state.SetBytesProcessed(static_cast<int64_t>(n * mlen));
+}
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "common.hpp"
+#include "cost.hpp"
+#include <benchmark/benchmark.h>
+
+// Benchmark ISAP Authenticated Encryption with Associated Data
+namespace isap_bench {
+
+using isap_cost::aead_rounds;
+using isap_cost::keystream_rounds;
+using isap_cost::mac_absorb_rounds;
+using isap_cost::mac_rounds;
+using isap_cost::rekeying_rounds;
+
+// Reports estimated # -of permutation rounds executed in each iteration of
+// benchmark, along with # -of rounds executed per second, so that estimated
+// cost model can be validated against measured time
+static inline void
+report_rounds(benchmark::State& state, const size_t rounds_per_itr)
+{
+  const double rounds = static_cast<double>(rounds_per_itr);
+  const double itrs = static_cast<double>(state.iterations());
+
+  state.counters["rounds"] = rounds;
+  state.counters["rounds/s"] =
+    benchmark::Counter(rounds * itrs, benchmark::Counter::kIsRate);
+}
+
+}
@@ -0,0 +1,227 @@
+#pragma once
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Benchmark ISAP Authenticated Encryption with Associated Data
+namespace isap_bench {
+
+// Hardware events, which are counted around timed loop of each benchmark
+enum class hw_event_t : size_t
+{
+  CYCLES,        // CPU cycles
+  INSTRUCTIONS,  // retired instructions
+  BRANCH_MISSES, // mispredicted branch instructions
+  L1D_MISSES     // L1 data cache read misses
+};
+
+// # -of hardware events being counted
+constexpr size_t HW_EVENT_CNT = 4;
+
+// Names used when reporting hardware events as benchmark user counters
+constexpr const char* HW_EVENT_NAME[HW_EVENT_CNT]{ "cycles",
+                                                   "instructions",
+                                                   "branch_misses",
+                                                   "l1d_misses" };
+
+// Hardware event counters, attached to calling thread ( counting only user
+// space execution ), opened using Linux perf_event_open(2) system call.
+//
+// Events are opened as a single group, led by CPU cycles, so that kernel
+// schedules all of them on PMU together & they're enabled, disabled & read at
+// once, which keeps ratios ( say IPC ) consistent, even when counters are
+// multiplexed. An event which can't be opened ( say on a non-Linux host, on a
+// VM without exposed PMU or with restrictive `perf_event_paranoid` setting ) is
+// left out of group, in which case first one opened leads it. When none of
+// them are available, benchmark is reported as usual i.e. only with wall time &
+// bytes processed.
+class perf_events
+{
+private:
+  int fds[HW_EVENT_CNT];
+  uint64_t vals[HW_EVENT_CNT]{};
+  int leader = -1;
+
+#if defined __linux__
+  // Opens perf event of given type/ config, as a member of group led by given
+  // file descriptor ( or as group leader, when it's -1 ), returning file
+  // descriptor ( >= 0 ) on success, otherwise -1 is returned
+  static int open_event(const uint32_t type,
+                        const uint64_t config,
+                        const int group_fd)
+  {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group_fd < 0; // members follow their leader
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+    return static_cast<int>(fd);
+  }
+#endif
+
+public:
+  perf_events()
+  {
+#if defined __linux__
+    constexpr uint64_t l1d_miss =
+      PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+    constexpr uint32_t types[HW_EVENT_CNT]{ PERF_TYPE_HARDWARE,
+                                            PERF_TYPE_HARDWARE,
+                                            PERF_TYPE_HARDWARE,
+                                            PERF_TYPE_HW_CACHE };
+    constexpr uint64_t configs[HW_EVENT_CNT]{ PERF_COUNT_HW_CPU_CYCLES,
+                                              PERF_COUNT_HW_INSTRUCTIONS,
+                                              PERF_COUNT_HW_BRANCH_MISSES,
+                                              l1d_miss };
+
+    for (size_t i = 0; i < HW_EVENT_CNT; i++) {
+      fds[i] = open_event(types[i], configs[i], leader);
+      if (leader < 0) {
+        leader = fds[i];
+      }
+    }
+#else
+    for (size_t i = 0; i < HW_EVENT_CNT; i++) {
+      fds[i] = -1;
+    }
+#endif
+  }
+
+  ~perf_events()
+  {
+#if defined __linux__
+    for (size_t i = 0; i < HW_EVENT_CNT; i++) {
+      if (fds[i] >= 0) {
+        close(fds[i]);
+      }
+    }
+#endif
+  }
+
+  perf_events(const perf_events&) = delete;
+  perf_events& operator=(const perf_events&) = delete;
+
+  // Whether given hardware event is being counted or not
+  bool available(const hw_event_t evt) const
+  {
+    return fds[static_cast<size_t>(evt)] >= 0;
+  }
+
+  // Resets & starts counting all available events, at once
+  void start()
+  {
+#if defined __linux__
+    if (leader >= 0) {
+      ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+  }
+
+  // Stops counting all available events, at once & reads their values, in a
+  // single read of group leader, scaling them in case group was multiplexed on
+  // hardware counters
+  void stop()
+  {
+#if defined __linux__
+    if (leader < 0) {
+      return;
+    }
+
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // # -of events, time enabled, time running, followed by value of each
+    // event, in order they joined group
+    uint64_t buf[3 + HW_EVENT_CNT]{};
+
+    const ssize_t n = read(leader, buf, sizeof(buf));
+    const bool ok = n >= static_cast<ssize_t>(3 * sizeof(uint64_t)) &&
+                    n == static_cast<ssize_t>((3 + buf[0]) * sizeof(uint64_t));
+
+    if (!ok || buf[2] == 0) {
+      // group never got scheduled on PMU, better not to report it
+      for (size_t i = 0; i < HW_EVENT_CNT; i++) {
+        if (fds[i] >= 0) {
+          close(fds[i]);
+          fds[i] = -1;
+        }
+      }
+      leader = -1;
+      return;
+    }
+
+    const double scale =
+      static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+
+    for (size_t i = 0, j = 3; i < HW_EVENT_CNT; i++) {
+      if (fds[i] >= 0) {
+        vals[i] = static_cast<uint64_t>(static_cast<double>(buf[j++]) * scale);
+      }
+    }
+#endif
+  }
+
+  // Counted value of given hardware event, only meaningful when event is
+  // available & counting has been stopped
+  uint64_t value(const hw_event_t evt) const
+  {
+    return vals[static_cast<size_t>(evt)];
+  }
+
+  // Reports counted hardware events as per-message ( read per-iteration ) and
+  // per-byte user counters of benchmark, given # -of bytes processed in each
+  // iteration. Also reports instructions per cycle, when both are available.
+  void report(benchmark::State& state, const size_t bytes_per_itr) const
+  {
+    const double itrs = static_cast<double>(state.iterations());
+    const double bytes = static_cast<double>(bytes_per_itr) * itrs;
+
+    if (itrs == 0.) {
+      return;
+    }
+
+    for (size_t i = 0; i < HW_EVENT_CNT; i++) {
+      if (fds[i] < 0) {
+        continue;
+      }
+
+      const double v = static_cast<double>(vals[i]);
+      const std::string name{ HW_EVENT_NAME[i] };
+
+      state.counters[name + "/msg"] = v / itrs;
+      if (bytes_per_itr > 0) {
+        state.counters[name + "/byte"] = v / bytes;
+      }
+    }
+
+    const size_t cyc = static_cast<size_t>(hw_event_t::CYCLES);
+    const size_t ins = static_cast<size_t>(hw_event_t::INSTRUCTIONS);
+
+    if (fds[cyc] >= 0 && fds[ins] >= 0 && vals[cyc] > 0) {
+      const double ipc =
+        static_cast<double>(vals[ins]) / static_cast<double>(vals[cyc]);
+      state.counters["IPC"] = ipc;
+    }
+  }
+};
+
+}
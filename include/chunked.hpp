@@ -0,0 +1,324 @@
+#pragma once
+#include "aead.hpp"
+#include "common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Chunked ( segmented ) encryption format, built on top of ISAP AEAD, which
+// splits a large message into fixed size chunks, each of which is encrypted
+// independently, so that chunks can be processed in parallel.
+//
+// Encrypted byte stream is laid out as
+//
+// header ( 32 -bytes ) || chunk_0 || tag_0 || ... || chunk_{n-1} || tag_{n-1}
+//
+// where header is
+//
+// magic ( 8 -bytes ) || variant ( 1 -byte ) || reserved zero ( 3 -bytes ) ||
+// chunk length ( 4 -bytes, little-endian ) || file nonce ( 16 -bytes )
+//
+// All chunks, but last one, are of chunk length bytes, while last one holds
+// remaining [0, chunk length] -bytes. Empty message is encrypted as single,
+// empty last chunk. Chunk i is encrypted using
+//
+// - nonce = file nonce ^ ( i as 64 -bit big-endian integer, placed in last 8
+// -bytes )
+// - associated data = header || ( i as 64 -bit little-endian integer ) || last
+// chunk flag ( 1 -byte )
+//
+// Binding chunk index with both nonce & associated data detects reordering or
+// duplication of chunks, while binding last chunk flag detects truncation at
+// chunk boundary. Binding header detects tampering with chunk length/ variant.
+namespace isap_chunked {
+
+// Magic bytes, identifying chunked encryption format ( version 1 )
+constexpr uint8_t MAGIC[]{ 'I', 'S', 'A', 'P', 'C', 'H', 'K', '1' };
+
+// Byte length of header
+constexpr size_t HDR_LEN = 32;
+
+// Byte length of authentication tag, appended to each chunk
+constexpr size_t TAG_LEN = isap_common::knt_len;
+
+// Byte length of associated data, used for authenticating each chunk
+constexpr size_t AD_LEN = HDR_LEN + 8 + 1;
+
+// Default chunk length ( in bytes ), large enough that per-chunk rekeying cost
+// is amortized, while small enough to be spread over many cores
+constexpr size_t DEFAULT_CHUNK_LEN = 1ul << 16;
+
+// Parsed header of chunked encryption format
+struct header_t
+{
+  uint32_t variant;   // see `isap_common::variant_id`
+  uint32_t chunk_len; // byte length of each chunk, but last one
+  uint8_t nonce[isap_common::knt_len]; // file nonce
+};
+
+// Given header, this routine serializes it as 32 -bytes
+static inline void
+encode_header(const header_t& hdr, uint8_t* const bytes)
+{
+  std::memset(bytes, 0, HDR_LEN);
+  std::memcpy(bytes, MAGIC, sizeof(MAGIC));
+
+  bytes[8] = static_cast<uint8_t>(hdr.variant);
+  for (size_t i = 0; i < 4; i++) {
+    bytes[12 + i] = static_cast<uint8_t>(hdr.chunk_len >> (i << 3));
+  }
+
+  std::memcpy(bytes + 16, hdr.nonce, sizeof(hdr.nonce));
+}
+
+// Given 32 -bytes serialized header, this routine parses it, returning boolean
+// truth value only when magic bytes match, reserved bytes are zero & chunk
+// length is non-zero
+static inline bool
+decode_header(const uint8_t* const bytes, header_t& hdr)
+{
+  if (std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0) {
+    return false;
+  }
+  if ((bytes[9] | bytes[10] | bytes[11]) != 0) {
+    return false;
+  }
+
+  hdr.variant = bytes[8];
+  hdr.chunk_len = 0;
+  for (size_t i = 0; i < 4; i++) {
+    hdr.chunk_len |= static_cast<uint32_t>(bytes[12 + i]) << (i << 3);
+  }
+
+  std::memcpy(hdr.nonce, bytes + 16, sizeof(hdr.nonce));
+  return hdr.chunk_len != 0;
+}
+
+// Given message length & chunk length ( both in bytes ), this routine computes
+// # -of chunks message is split into
+static inline constexpr size_t
+chunk_count(const size_t mlen, const size_t clen)
+{
+  return mlen == 0 ? 1 : (mlen + clen - 1) / clen;
+}
+
+// Given message length & chunk length ( both in bytes ), this routine computes
+// byte length of encrypted stream
+static inline constexpr size_t
+encrypted_len(const size_t mlen, const size_t clen)
+{
+  return HDR_LEN + mlen + chunk_count(mlen, clen) * TAG_LEN;
+}
+
+// Given byte length of encrypted stream & chunk length, this routine computes
+// byte length of message, returning boolean truth value only when encrypted
+// stream length is well-formed. Note, only an empty message is encrypted as an
+// empty last chunk, so that an empty trailing chunk ( i.e. a lone tag ) after
+// some full chunks is rejected; otherwise it'd be ignored, as message length
+// decides # -of chunks being decrypted.
+static inline bool
+plain_len(const size_t elen, const size_t clen, size_t& mlen)
+{
+  if (elen < HDR_LEN + TAG_LEN) {
+    return false;
+  }
+
+  const size_t blen = elen - HDR_LEN;     // all chunks along with their tags
+  const size_t rlen = clen + TAG_LEN;     // single full chunk along with tag
+  const size_t cnt = (blen + rlen - 1) / rlen;
+  const size_t last = blen - (cnt - 1) * rlen;
+
+  if (last < TAG_LEN) {
+    return false;
+  }
+
+  mlen = blen - cnt * TAG_LEN;
+  return chunk_count(mlen, clen) == cnt;
+}
+
+// Given 16 -bytes file nonce & chunk index, this routine derives 16 -bytes
+// nonce of that chunk
+static inline void
+chunk_nonce(const uint8_t* const __restrict nonce,
+            const uint64_t idx,
+            uint8_t* const __restrict cnonce)
+{
+  constexpr size_t last = isap_common::knt_len - 1;
+
+  std::memcpy(cnonce, nonce, isap_common::knt_len);
+  for (size_t i = 0; i < 8; i++) {
+    cnonce[last - i] ^= static_cast<uint8_t>(idx >> (i << 3));
+  }
+}
+
+// Given 32 -bytes serialized header, chunk index & last chunk flag, this
+// routine prepares 41 -bytes associated data of that chunk
+static inline void
+chunk_ad(const uint8_t* const __restrict hdr,
+         const uint64_t idx,
+         const bool last,
+         uint8_t* const __restrict ad)
+{
+  std::memcpy(ad, hdr, HDR_LEN);
+  for (size_t i = 0; i < 8; i++) {
+    ad[HDR_LEN + i] = static_cast<uint8_t>(idx >> (i << 3));
+  }
+  ad[HDR_LEN + 8] = static_cast<uint8_t>(last);
+}
+
+// Given # -of work items & # -of threads ( 0 => all available cores ), this
+// routine invokes `fn(i)` for each work item i, spreading them over threads,
+// which dynamically pick up next unprocessed item
+template<typename F>
+static inline void
+parallel_for(const size_t cnt, const size_t nthreads, F&& fn)
+{
+  const size_t hw = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  const size_t tcnt = std::min(nthreads == 0 ? hw : nthreads, cnt);
+
+  if (tcnt <= 1) {
+    for (size_t i = 0; i < cnt; i++) {
+      fn(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next{ 0 };
+  auto work = [&]() {
+    size_t i;
+    while ((i = next.fetch_add(1, std::memory_order_relaxed)) < cnt) {
+      fn(i);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(tcnt - 1);
+  for (size_t t = 1; t < tcnt; t++) {
+    workers.emplace_back(work);
+  }
+
+  work();
+  for (auto& w : workers) {
+    w.join();
+  }
+}
+
+// Given 16 -bytes secret key, 16 -bytes file nonce, chunk length ( > 0 ) & M (
+// >=0 ) -bytes message, this routine computes `encrypted_len(M, chunk length)`
+// -bytes encrypted stream, using ISAP instance chosen by template parameters,
+// encrypting chunks in parallel over given # -of threads ( 0 => all available
+// cores ).
+//
+// Note, same file nonce must never be reused under same secret key.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static inline void
+encrypt(const uint8_t* const __restrict key,
+        const uint8_t* const __restrict nonce,
+        const uint32_t clen,
+        const uint8_t* const __restrict msg,
+        const size_t mlen,
+        uint8_t* const __restrict out,
+        const size_t nthreads = 0)
+{
+  header_t hdr{};
+  hdr.variant = isap_common::variant_id<p, s_b, s_k, s_e, s_h>();
+  hdr.chunk_len = clen;
+  std::memcpy(hdr.nonce, nonce, sizeof(hdr.nonce));
+
+  encode_header(hdr, out);
+
+  const size_t cnt = chunk_count(mlen, clen);
+
+  parallel_for(cnt, nthreads, [&](const size_t i) {
+    const size_t moff = i * clen;
+    const size_t len = std::min<size_t>(mlen - moff, clen);
+    const bool last = i == cnt - 1;
+
+    uint8_t cnonce[isap_common::knt_len];
+    uint8_t ad[AD_LEN];
+
+    chunk_nonce(nonce, i, cnonce);
+    chunk_ad(out, i, last, ad);
+
+    uint8_t* const enc = out + HDR_LEN + i * (clen + TAG_LEN);
+    isap::encrypt<p, s_b, s_k, s_e, s_h>(
+      key, cnonce, ad, sizeof(ad), msg + moff, enc, len, enc + len);
+  });
+}
+
+// Given 16 -bytes secret key & N -bytes encrypted stream, this routine decrypts
+// `plain_len(N, chunk length)` -bytes message, using ISAP instance chosen by
+// template parameters, decrypting chunks in parallel over given # -of threads (
+// 0 => all available cores ). Returned boolean flag holds truth value only when
+// header is well-formed, it was produced by same ISAP instance & all chunks are
+// authenticated.
+//
+// Note, if verification fails, message bytes are zeroed, so that unverified
+// bytes are never released.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static inline bool
+decrypt(const uint8_t* const __restrict key,
+        const uint8_t* const __restrict in,
+        const size_t elen,
+        uint8_t* const __restrict msg,
+        const size_t nthreads = 0)
+{
+  header_t hdr;
+  size_t mlen;
+
+  if (elen < HDR_LEN || !decode_header(in, hdr)) {
+    return false;
+  }
+  if (hdr.variant != isap_common::variant_id<p, s_b, s_k, s_e, s_h>()) {
+    return false;
+  }
+  if (!plain_len(elen, hdr.chunk_len, mlen)) {
+    return false;
+  }
+
+  const size_t clen = hdr.chunk_len;
+  const size_t cnt = chunk_count(mlen, clen);
+  std::atomic<bool> ok{ true };
+
+  parallel_for(cnt, nthreads, [&](const size_t i) {
+    if (!ok.load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    const size_t moff = i * clen;
+    const size_t len = std::min<size_t>(mlen - moff, clen);
+    const bool last = i == cnt - 1;
+
+    uint8_t cnonce[isap_common::knt_len];
+    uint8_t ad[AD_LEN];
+
+    chunk_nonce(hdr.nonce, i, cnonce);
+    chunk_ad(in, i, last, ad);
+
+    const uint8_t* const enc = in + HDR_LEN + i * (clen + TAG_LEN);
+    const bool flg = isap::decrypt<p, s_b, s_k, s_e, s_h>(
+      key, cnonce, enc + len, ad, sizeof(ad), enc, msg + moff, len);
+
+    if (!flg) {
+      ok.store(false, std::memory_order_relaxed);
+    }
+  });
+
+  if (!ok.load()) {
+    std::memset(msg, 0, mlen);
+    return false;
+  }
+  return true;
+}
+
+}
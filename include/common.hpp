@@ -1,10 +1,13 @@
 #pragma once
 #include "ascon.hpp"
+#include "instrument.hpp"
 #include "keccak.hpp"
+#include "probes.hpp"
 #include "utils.hpp"
 #include <algorithm>
 #include <cstring>
 #include <iterator>
+#include <type_traits>
 
 // ISAP AEAD common functions
 namespace isap_common {
@@ -32,14 +35,66 @@ constexpr size_t PERM_STATE_LEN[]{ 40, 50 };
 // https://csrc.nist.gov/CSRC/media/Projects/lightweight-cryptography/documents/finalist-round/updated-spec-doc/isap-spec-final.pdf
 constexpr size_t knt_len = 16;
 
-// Generates session key `Ke` for encryption & `Ka` for authentication, given
-// 128 -bit secret key, 128 -bit string Y & a flag denoting encryption/
-// authentication mode
-//
-// Read section 2.1 of ISAP specification ( linked below ), then see pseudocode
-// described in algorithm 4 ( named `ISAP_Rk` )
+// Rate ( in bytes ) of sponge constructions, using Ascon-p, Keccak-p[400]
+// permutation, see column `r_H` of table 2.2 of ISAP specification. Note, same
+// rate is used for both encryption & authentication.
+constexpr size_t RATE[]{ PERM_STATE_LEN[0] - (knt_len << 1),
+                         PERM_STATE_LEN[1] - (knt_len << 1) };
+
+// Ascon-p state is represented as 5 64 -bit words, while Keccak-p[400] state is
+// represented as 25 16 -bit lanes, both held by value ( see `ascon::state` &
+// `keccak::state400` ), so that sponge states can be kept in registers
+template<const perm_t p>
+using state_t =
+  std::conditional_t<p == perm_t::ASCON, ascon::state, keccak::state400>;
+
+// Applies R -many rounds of permutation on state
+template<const size_t R, typename S>
+inline static constexpr void
+permute(S& state)
+{
+  state.template permute<R>();
+}
+
+// Identifies ISAP instance ( chosen by template parameters, see table 2.2 of
+// ISAP specification ) using a small integer i.e. ISAP-A-128A => 1, ISAP-A-128
+// => 2, ISAP-K-128A => 3 & ISAP-K-128 => 4, while any other parameter set is
+// identified as 0
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static constexpr uint32_t
+variant_id()
+{
+  if constexpr (p == perm_t::ASCON) {
+    if constexpr (s_b == 1 && s_k == 12 && s_e == 6 && s_h == 12) {
+      return 1;
+    } else if constexpr (s_b == 12 && s_k == 12 && s_e == 12 && s_h == 12) {
+      return 2;
+    } else {
+      return 0;
+    }
+  } else {
+    if constexpr (s_b == 1 && s_k == 8 && s_e == 8 && s_h == 16) {
+      return 3;
+    } else if constexpr (s_b == 12 && s_k == 12 && s_e == 12 && s_h == 20) {
+      return 4;
+    } else {
+      return 0;
+    }
+  }
+}
+
+// Initializes sponge state used for generating session key `Ke` for encryption
+// or `Ka` for authentication, by placing 128 -bit secret key & respective
+// initialization vector into state, which is then permuted. Resulting state
+// depends only on secret key & mode flag, so it can be computed once per key &
+// reused for many messages ( see `key_context_t` ).
 //
-// ISAP specification:
+// See initialization phase of algorithm 4 ( named `ISAP_Rk` ) of ISAP
+// specification
 // https://csrc.nist.gov/CSRC/media/Projects/lightweight-cryptography/documents/finalist-round/updated-spec-doc/isap-spec-final.pdf
 template<const perm_t p,
          const rk_flag_t f,
@@ -48,15 +103,9 @@ template<const perm_t p,
          const size_t s_e,
          const size_t s_h>
 inline static void
-rekeying(const uint8_t* const __restrict key,
-         const uint8_t* const __restrict y,
-         uint8_t* const __restrict skey)
+rekeying_init(const uint8_t* const __restrict key, state_t<p>& state)
 {
-  constexpr size_t slen = PERM_STATE_LEN[static_cast<uint32_t>(p)];
-  constexpr size_t rate = slen - (knt_len << 1);
-
-  constexpr size_t Z[]{ slen - knt_len, knt_len };
-  constexpr size_t z = Z[static_cast<size_t>(f)];
+  constexpr size_t rate = RATE[static_cast<uint32_t>(p)];
 
   // See table 2.3 of ISAP specification
   constexpr uint8_t IV_KA[8]{ 0x02, knt_len << 3, rate << 3, 0x01,
@@ -66,95 +115,249 @@ rekeying(const uint8_t* const __restrict key,
   constexpr uint8_t IV_KE[8]{ 0x03, knt_len << 3, rate << 3, 0x01,
                               s_h,  s_b,          s_e,       s_k };
 
-  if constexpr (p == perm_t::ASCON) {
-    // --- begin initialization ---
+  state = {};
+  state.set_bytes(key, 0, knt_len);
 
-    uint64_t state[5]{};
+  if constexpr (f == rk_flag_t::ENC) {
+    state.set_bytes(IV_KE, knt_len, sizeof(IV_KE));
+  } else {
+    state.set_bytes(IV_KA, knt_len, sizeof(IV_KA));
+  }
 
-    isap_utils::copy_bytes_to_be_u64(key, knt_len, state);
+  permute<s_k>(state);
+}
 
-    if constexpr (f == rk_flag_t::ENC) {
-      isap_utils::copy_bytes_to_be_u64(IV_KE, sizeof(IV_KE), state + 2);
-    } else {
-      isap_utils::copy_bytes_to_be_u64(IV_KA, sizeof(IV_KA), state + 2);
-    }
+// Absorbs leading 127 bits of 128 -bit string Y, one bit at a time, into
+// already initialized rekeying sponge state, permuting state with `s_b` rounds
+// after each bit.
+template<const perm_t p, const size_t s_b>
+inline static void
+rekeying_bits(state_t<p>& state, const uint8_t* const __restrict y)
+{
+  constexpr size_t bits = (knt_len << 3) - 1;
 
-    ascon::permute<s_k>(state);
+  for (size_t i = 0; i < bits; i++) {
+    const size_t off = i >> 3;       // byte offset
+    const size_t bpos = 7 - (i & 7); // bit position in selected byte
 
-    // --- end initialization ---
+    const uint8_t bit = (y[off] >> bpos) & 0b1;
 
-    // --- begin absorption ---
+    state.xor_byte(0, bit << 7);
+    permute<s_b>(state);
+  }
+}
 
-    constexpr size_t bits = (knt_len << 3) - 1;
+// Absorbs 128 -bit string Y, one bit at a time, into already initialized
+// sponge state ( see `rekeying_init` ), which is then squeezed for generating
+// session key `Ke` for encryption or `Ka` for authentication. Note, state is
+// updated in-place.
+//
+// See absorption & squeezing phases of algorithm 4 ( named `ISAP_Rk` ) of ISAP
+// specification
+// https://csrc.nist.gov/CSRC/media/Projects/lightweight-cryptography/documents/finalist-round/updated-spec-doc/isap-spec-final.pdf
+template<const perm_t p,
+         const rk_flag_t f,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static void
+rekeying_absorb(state_t<p>& state,
+                const uint8_t* const __restrict y,
+                uint8_t* const __restrict skey)
+{
+  constexpr size_t slen = PERM_STATE_LEN[static_cast<uint32_t>(p)];
 
-    for (size_t i = 0; i < bits; i++) {
-      const size_t off = i >> 3;       // byte offset
-      const size_t bpos = 7 - (i & 7); // bit position in selected byte
+  constexpr size_t Z[]{ slen - knt_len, knt_len };
+  constexpr size_t z = Z[static_cast<size_t>(f)];
 
-      const uint8_t bit = (y[off] >> bpos) & 0b1;
-      state[0] ^= static_cast<uint64_t>(bit) << 63;
+  isap_instr::absorb<isap_instr::sponge_t::REKEYING>(knt_len);
+  isap_instr::squeeze<isap_instr::sponge_t::REKEYING>(z);
 
-      ascon::permute<s_b>(state);
-    }
+  // --- begin absorption ---
 
-    const uint8_t bit = y[15] & 0b1;
-    state[0] ^= static_cast<uint64_t>(bit) << 63;
+  rekeying_bits<p, s_b>(state, y);
 
-    ascon::permute<s_k>(state);
+  const uint8_t bit = y[15] & 0b1;
 
-    // --- end absorption ---
+  state.xor_byte(0, bit << 7);
+  permute<s_k>(state);
 
-    // --- begin squeezing ---
-    isap_utils::copy_be_u64_to_bytes(state, skey, z);
-    // --- end squeezing ---
+  // --- end absorption ---
 
-  } else {
-    // --- begin initialization ---
+  // --- begin squeezing ---
+  state.extract_bytes(skey, z);
+  // --- end squeezing ---
+}
 
-    uint16_t state[25]{};
+// Precomputed, per-key state of ISAP instance ( chosen by template parameters
+// ), holding rekeying sponge states right after initialization ( see
+// `rekeying_init` ), for both encryption & authentication mode. It can be used
+// in place of 16 -bytes secret key, saving two permutation calls ( of `s_k`
+// rounds ) per message.
+//
+// Note, as permutation is invertible, key context is as sensitive as secret
+// key.
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+struct key_context_t
+{
+  state_t<p> ke; // ENC mode
+  state_t<p> ka; // MAC mode
 
-    isap_utils::copy_bytes_to_le_u16(key, knt_len, state);
+  key_context_t() = default;
 
-    if constexpr (f == rk_flag_t::ENC) {
-      isap_utils::copy_bytes_to_le_u16(IV_KE, sizeof(IV_KE), state + 8);
-    } else {
-      isap_utils::copy_bytes_to_le_u16(IV_KA, sizeof(IV_KA), state + 8);
-    }
+  // Given 16 -bytes secret key, this routine precomputes key context
+  explicit key_context_t(const uint8_t* const key)
+  {
+    rekeying_init<p, rk_flag_t::ENC, s_b, s_k, s_e, s_h>(key, ke);
+    rekeying_init<p, rk_flag_t::MAC, s_b, s_k, s_e, s_h>(key, ka);
+  }
+};
 
-    keccak::permute<s_k>(state);
+// Generates session key `Ke` for encryption & `Ka` for authentication, given
+// 128 -bit secret key, 128 -bit string Y & a flag denoting encryption/
+// authentication mode
+//
+// Read section 2.1 of ISAP specification ( linked below ), then see pseudocode
+// described in algorithm 4 ( named `ISAP_Rk` )
+//
+// ISAP specification:
+// https://csrc.nist.gov/CSRC/media/Projects/lightweight-cryptography/documents/finalist-round/updated-spec-doc/isap-spec-final.pdf
+template<const perm_t p,
+         const rk_flag_t f,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static void
+rekeying(const uint8_t* const __restrict key,
+         const uint8_t* const __restrict y,
+         uint8_t* const __restrict skey)
+{
+  [[maybe_unused]] constexpr uint32_t vid = variant_id<p, s_b, s_k, s_e, s_h>();
+  [[maybe_unused]] constexpr uint32_t flg = static_cast<uint32_t>(f);
 
-    // --- end initialization ---
+  ISAP_PROBE2(rekeying_entry, vid, flg);
 
-    // --- begin absorption ---
+  state_t<p> state;
 
-    constexpr size_t bits = (knt_len << 3) - 1;
+  rekeying_init<p, f, s_b, s_k, s_e, s_h>(key, state);
+  rekeying_absorb<p, f, s_b, s_k, s_e, s_h>(state, y, skey);
 
-    for (size_t i = 0; i < bits; i++) {
-      const size_t off = i >> 3;       // byte offset
-      const size_t bpos = 7 - (i & 7); // bit position in selected byte
+  ISAP_PROBE2(rekeying_return, vid, flg);
+}
 
-      const uint8_t bit = (y[off] >> bpos) & 0b1;
-      state[0] ^= static_cast<uint16_t>(bit) << 7;
+// Same as above, but starts from already initialized sponge state, held in
+// precomputed key context, instead of 128 -bit secret key
+template<const perm_t p,
+         const rk_flag_t f,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static void
+rekeying(const key_context_t<p, s_b, s_k, s_e, s_h>& ctx,
+         const uint8_t* const __restrict y,
+         uint8_t* const __restrict skey)
+{
+  [[maybe_unused]] constexpr uint32_t vid = variant_id<p, s_b, s_k, s_e, s_h>();
+  [[maybe_unused]] constexpr uint32_t flg = static_cast<uint32_t>(f);
 
-      keccak::permute<s_b>(state);
-    }
+  ISAP_PROBE2(rekeying_entry, vid, flg);
 
-    const uint8_t bit = y[15] & 0b1;
-    state[0] ^= static_cast<uint16_t>(bit) << 7;
+  state_t<p> state = f == rk_flag_t::ENC ? ctx.ke : ctx.ka;
 
-    keccak::permute<s_k>(state);
+  rekeying_absorb<p, f, s_b, s_k, s_e, s_h>(state, y, skey);
 
-    // --- end absorption ---
+  ISAP_PROBE2(rekeying_return, vid, flg);
+}
 
-    // --- begin squeezing ---
-    isap_utils::copy_le_u16_to_bytes(state, skey, z);
-    // --- end squeezing ---
+// Initializes sponge state used for encrypting/ decrypting message bytes, by
+// deriving session key `Ke` ( see `rekeying` ) from 128 -bit secret key and 128
+// -bit public message nonce, which is followed by nonce itself. Secret key can
+// be passed either as 16 -bytes or as precomputed `key_context_t`.
+//
+// See initialization phase of algorithm 3 ( named `ISAP_Enc` ) of ISAP
+// specification
+// https://csrc.nist.gov/CSRC/media/Projects/lightweight-cryptography/documents/finalist-round/updated-spec-doc/isap-spec-final.pdf
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h,
+         typename key_arg_t>
+inline static void
+enc_init(const key_arg_t& key,
+         const uint8_t* const __restrict nonce,
+         state_t<p>& state)
+{
+  constexpr size_t slen = PERM_STATE_LEN[static_cast<uint32_t>(p)];
+  constexpr size_t z = slen - knt_len;
+
+  uint8_t skey[z];
+  rekeying<p, rk_flag_t::ENC, s_b, s_k, s_e, s_h>(key, nonce, skey);
+
+  state.set_bytes(skey, 0, z);
+  state.set_bytes(nonce, z, knt_len);
+}
+
+// Encrypts/ decrypts N -many message bytes ( producing equal many encrypted/
+// decrypted bytes as output ), by squeezing key stream out of already
+// initialized sponge state ( see `enc_init` ), which is XOR-ed with input.
+//
+// Note, sponge state is updated in-place, so encrypting a long message in
+// multiple calls, each with length being multiple of rate ( except possibly the
+// last one ), produces same output as encrypting it in a single call. Each
+// block of input is consumed before respective output block is written, so
+// input & output may be same buffer. Sponge state is worked on as a local copy,
+// so that it's not reloaded from memory after each output block is written.
+//
+// See squeezing phase of algorithm 3 ( named `ISAP_Enc` ) of ISAP specification
+// https://csrc.nist.gov/CSRC/media/Projects/lightweight-cryptography/documents/finalist-round/updated-spec-doc/isap-spec-final.pdf
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static void
+enc_squeeze(state_t<p>& state,
+            const uint8_t* const msg,
+            uint8_t* const out,
+            const size_t mlen)
+{
+  constexpr size_t rate = RATE[static_cast<uint32_t>(p)];
+
+  isap_instr::squeeze<isap_instr::sponge_t::ENC>(mlen);
+
+  state_t<p> s = state;
+
+  size_t off = 0;
+  while (off < mlen) {
+    permute<s_e>(s);
+
+    // full blocks take constant length path, which is fully unrolled
+    const size_t elen = std::min(rate, mlen - off);
+    if (elen == rate) {
+      s.xor_extract(msg + off, out + off, rate);
+    } else {
+      s.xor_extract(msg + off, out + off, elen);
+    }
+
+    off += elen;
   }
+
+  state = s;
 }
 
 // Encrypts/ decrypts N -many message bytes ( producing equal many encrypted/
 // decrypted bytes as output ), using keyed sponge construction in streaming
-// mode, when 128 -bit secret key, 128 -bit public message nonce is provided
+// mode, when 128 -bit secret key ( or its precomputed `key_context_t` ), 128
+// -bit public message nonce is provided. When there's no message byte, session
+// key isn't derived at all, as no key stream is needed.
 //
 // Read section 2.2 of ISAP specification ( linked below ), then see pseudocode
 // described in algorithm 3 ( named `ISAP_Enc` )
@@ -165,97 +368,178 @@ template<const perm_t p,
          const size_t s_b,
          const size_t s_k,
          const size_t s_e,
-         const size_t s_h>
+         const size_t s_h,
+         typename key_arg_t>
 inline static void
-enc(const uint8_t* const __restrict key,
+enc(const key_arg_t& key,
     const uint8_t* const __restrict nonce,
-    const uint8_t* const __restrict msg,
-    uint8_t* const __restrict out,
+    const uint8_t* const msg,
+    uint8_t* const out,
     const size_t mlen)
 {
-  constexpr size_t slen = PERM_STATE_LEN[static_cast<uint32_t>(p)];
-  constexpr size_t rate = slen - (knt_len << 1);
-
-  if constexpr (p == perm_t::ASCON) {
-    // --- begin initialization ---
+  if (mlen == 0) {
+    return;
+  }
 
-    constexpr size_t z = slen - knt_len;
-    uint8_t skey[z];
-    rekeying<p, rk_flag_t::ENC, s_b, s_k, s_e, s_h>(key, nonce, skey);
+  state_t<p> state;
 
-    uint64_t state[5];
+  enc_init<p, s_b, s_k, s_e, s_h>(key, nonce, state);
+  enc_squeeze<p, s_b, s_k, s_e, s_h>(state, msg, out, mlen);
+}
 
-    isap_utils::copy_bytes_to_be_u64(skey, z, state);
-    isap_utils::copy_bytes_to_be_u64(nonce, knt_len, state + (z / 8));
+// Initializes sponge state used for computing suffix-MAC, by placing 128 -bit
+// public message nonce & initialization vector `IV_A` into state, which is
+// then permuted
+//
+// See initialization phase of algorithm 5 ( named `ISAP_Mac` ) of ISAP
+// specification
+// https://csrc.nist.gov/CSRC/media/Projects/lightweight-cryptography/documents/finalist-round/updated-spec-doc/isap-spec-final.pdf
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static void
+mac_init(const uint8_t* const __restrict nonce, state_t<p>& state)
+{
+  constexpr size_t rate = RATE[static_cast<uint32_t>(p)];
 
-    // --- end initialization ---
+  // See table 2.3 of ISAP specification
+  constexpr uint8_t IV_A[8]{ 0x01, knt_len << 3, rate << 3, 0x01,
+                             s_h,  s_b,          s_e,       s_k };
 
-    // --- begin squeezing ---
+  state = {};
+  state.set_bytes(nonce, 0, knt_len);
+  state.set_bytes(IV_A, knt_len, sizeof(IV_A));
 
-    size_t off = 0;
-    while (off < mlen) {
-      ascon::permute<s_e>(state);
+  permute<s_h>(state);
+}
 
-      const size_t elen = std::min(rate, mlen - off);
+// Absorbs N -many full rate blocks into sponge state used for computing
+// suffix-MAC, where input must have N * rate -many bytes. Sponge state is
+// worked on as a local copy, same as `enc_squeeze` does.
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static void
+mac_absorb_blocks(state_t<p>& state,
+                  const uint8_t* const __restrict in,
+                  const size_t blk_cnt)
+{
+  constexpr size_t rate = RATE[static_cast<uint32_t>(p)];
 
-      uint64_t mword = 0;
-      isap_utils::copy_bytes_to_be_u64(msg + off, elen, &mword);
+  isap_instr::absorb<isap_instr::sponge_t::MAC>(blk_cnt * rate);
 
-      const uint64_t eword = mword ^ state[0];
-      isap_utils::copy_be_u64_to_bytes(&eword, out + off, elen);
+  state_t<p> s = state;
 
-      off += elen;
-    }
+  for (size_t i = 0; i < blk_cnt; i++) {
+    s.xor_bytes(in + i * rate, rate);
+    permute<s_h>(s);
+  }
 
-    // --- end squeezing ---
+  state = s;
+}
 
-  } else {
-    // --- begin initialization ---
+// Absorbs last ( possibly empty ) block of M -many bytes, padded using 10*
+// rule, into sponge state used for computing suffix-MAC, where M < rate
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static void
+mac_absorb_last(state_t<p>& state,
+                const uint8_t* const __restrict in,
+                const size_t rm_bytes)
+{
+  constexpr uint8_t seperator = 0b10000000;
 
-    constexpr size_t z = slen - knt_len;
-    uint8_t skey[z];
-    rekeying<p, rk_flag_t::ENC, s_b, s_k, s_e, s_h>(key, nonce, skey);
+  isap_instr::absorb<isap_instr::sponge_t::MAC>(rm_bytes);
 
-    uint16_t state[25];
+  state.xor_bytes(in, rm_bytes);
+  state.xor_byte(rm_bytes, seperator);
 
-    isap_utils::copy_bytes_to_le_u16(skey, z, state);
-    isap_utils::copy_bytes_to_le_u16(nonce, knt_len, state + (z / 2));
+  permute<s_h>(state);
+}
 
-    // --- end initialization ---
+// Absorbs N ( >=0 ) -many bytes ( i.e. associated data or cipher text ), padded
+// using 10* rule, into sponge state used for computing suffix-MAC
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static void
+mac_absorb(state_t<p>& state,
+           const uint8_t* const __restrict in,
+           const size_t ilen)
+{
+  constexpr size_t rate = RATE[static_cast<uint32_t>(p)];
 
-    // --- begin squeezing ---
+  const size_t blk_cnt = ilen / rate;
+  const size_t rm_bytes = ilen % rate;
 
-    uint64_t buf0[(rate + 7) / 8];
-    uint64_t buf1[(rate + 7) / 8];
+  mac_absorb_blocks<p, s_b, s_k, s_e, s_h>(state, in, blk_cnt);
+  mac_absorb_last<p, s_b, s_k, s_e, s_h>(state, in + blk_cnt * rate, rm_bytes);
+}
 
-    size_t off = 0;
-    while (off < mlen) {
-      keccak::permute<s_e>(state);
+// Flips last bit of sponge state used for computing suffix-MAC, separating
+// associated data from cipher text
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static void
+mac_domain_separate(state_t<p>& state)
+{
+  constexpr size_t slen = PERM_STATE_LEN[static_cast<uint32_t>(p)];
 
-      const size_t elen = std::min(rate, mlen - off);
+  state.xor_byte(slen - 1, 0b1);
+}
 
-      std::memset(buf0, 0, sizeof(buf0));
-      isap_utils::copy_bytes_to_le_u64(msg + off, elen, buf0);
+// Finalizes computation of 128 -bit suffix-MAC, by squeezing 128 -bit string Y
+// out of sponge state ( which has already absorbed associated data & cipher
+// text ), deriving session key `Ka` from Y ( see `rekeying` ), which replaces
+// first 128 -bits of state, before it's permuted once more for squeezing tag.
+// Secret key can be passed either as 16 -bytes or as precomputed
+// `key_context_t`.
+//
+// See finalization phase of algorithm 5 ( named `ISAP_Mac` ) of ISAP
+// specification
+// https://csrc.nist.gov/CSRC/media/Projects/lightweight-cryptography/documents/finalist-round/updated-spec-doc/isap-spec-final.pdf
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h,
+         typename key_arg_t>
+inline static void
+mac_finalize(const key_arg_t& key,
+             state_t<p>& state,
+             uint8_t* const __restrict tag)
+{
+  uint8_t y[knt_len];
+  uint8_t skey[knt_len];
 
-      std::memset(buf1, 0, sizeof(buf1));
-      isap_utils::copy_le_u16_to_le_u64(state, elen, buf1);
+  // both Y & tag are squeezed out of suffix-MAC sponge
+  isap_instr::squeeze<isap_instr::sponge_t::MAC>(knt_len << 1);
 
-      for (size_t i = 0; i < (rate + 7) / 8; i++) {
-        buf1[i] ^= buf0[i];
-      }
+  state.extract_bytes(y, knt_len);
+  rekeying<p, rk_flag_t::MAC, s_b, s_k, s_e, s_h>(key, y, skey);
+  state.set_bytes(skey, 0, knt_len);
 
-      isap_utils::copy_le_u64_to_bytes(buf1, out + off, elen);
-      off += elen;
-    }
+  permute<s_h>(state);
 
-    // --- end squeezing ---
-  }
+  state.extract_bytes(tag, knt_len);
 }
 
 // Computes 128 -bit suffix-MAC ( message authentication code ), using sponge
 // based hash function, used for message authentication purpose, given 128 -bit
-// secret key, 128 -bit public message nonce, N -bytes associated data & M
-// -bytes cipher text
+// secret key ( or its precomputed `key_context_t` ), 128 -bit public message
+// nonce, N -bytes associated data & M -bytes cipher text
 //
 // Read section 2.3 of ISAP specification ( linked below ), then see pseudocode
 // described in algorithm 5 ( named `ISAP_Mac` )
@@ -266,9 +550,10 @@ template<const perm_t p,
          const size_t s_b,
          const size_t s_k,
          const size_t s_e,
-         const size_t s_h>
+         const size_t s_h,
+         typename key_arg_t>
 inline static void
-mac(const uint8_t* const __restrict key,
+mac(const key_arg_t& key,
     const uint8_t* const __restrict nonce,
     const uint8_t* const __restrict data,
     const size_t dlen,
@@ -276,196 +561,27 @@ mac(const uint8_t* const __restrict key,
     const size_t clen,
     uint8_t* const __restrict tag)
 {
-  constexpr size_t slen = PERM_STATE_LEN[static_cast<uint32_t>(p)];
-  constexpr size_t rate = slen - (knt_len << 1);
-  constexpr uint8_t seperator = 0b10000000;
+  state_t<p> state;
 
-  // See table 2.3 of ISAP specification
-  constexpr uint8_t IV_A[8]{ 0x01, knt_len << 3, rate << 3, 0x01,
-                             s_h,  s_b,          s_e,       s_k };
-
-  if constexpr (p == perm_t::ASCON) {
-    // --- begin initialization ---
-
-    uint64_t state[5]{};
-
-    isap_utils::copy_bytes_to_be_u64(nonce, knt_len, state);
-    isap_utils::copy_bytes_to_be_u64(IV_A, sizeof(IV_A), state + 2);
-
-    ascon::permute<s_h>(state);
-
-    // --- end initialization ---
-
-    // --- begin absorbing associated data ---
-    {
-      const size_t blk_cnt = dlen / rate;
-      const size_t rm_bytes = dlen % rate;
-
-      for (size_t i = 0; i < blk_cnt; i++) {
-        const size_t off = i * rate;
-
-        uint64_t word;
-        isap_utils::copy_bytes_to_be_u64(data + off, rate, &word);
-
-        state[0] ^= word;
-        ascon::permute<s_h>(state);
-      }
-
-      const size_t off = blk_cnt * rate;
-
-      uint64_t word = 0;
-      isap_utils::copy_bytes_to_be_u64(data + off, rm_bytes, &word);
-      word |= static_cast<uint64_t>(seperator) << ((7 - rm_bytes) * 8);
-
-      state[0] ^= word;
-      ascon::permute<s_h>(state);
-
-      state[4] ^= 0b1; // seperator between associated data & cipher text
-    }
-    // --- end absorbing associated data ---
-
-    // --- begin absorbing cipher text ---
-    {
-      const size_t blk_cnt = clen / rate;
-      const size_t rm_bytes = clen % rate;
-
-      for (size_t i = 0; i < blk_cnt; i++) {
-        const size_t off = i * rate;
-
-        uint64_t word;
-        isap_utils::copy_bytes_to_be_u64(cipher + off, rate, &word);
-
-        state[0] ^= word;
-        ascon::permute<s_h>(state);
-      }
-
-      const size_t off = blk_cnt * rate;
-
-      uint64_t word = 0;
-      isap_utils::copy_bytes_to_be_u64(cipher + off, rm_bytes, &word);
-      word |= static_cast<uint64_t>(seperator) << ((7 - rm_bytes) * 8);
-
-      state[0] ^= word;
-      ascon::permute<s_h>(state);
-    }
-    // --- end absorbing cipher text ---
-
-    // --- begin squeezing tag ---
-
-    uint8_t y[knt_len];
-    uint8_t skey[knt_len];
-
-    isap_utils::copy_be_u64_to_bytes(state, y, knt_len);
-    rekeying<p, rk_flag_t::MAC, s_b, s_k, s_e, s_h>(key, y, skey);
-    isap_utils::copy_bytes_to_be_u64(skey, knt_len, state);
-
-    ascon::permute<s_h>(state);
-
-    isap_utils::copy_be_u64_to_bytes(state, tag, knt_len);
-
-    // --- end squeezing tag ---
-
-  } else {
-    // --- begin initialization ---
-
-    uint16_t state[25]{};
-
-    isap_utils::copy_bytes_to_le_u16(nonce, knt_len, state);
-    isap_utils::copy_bytes_to_le_u16(IV_A, sizeof(IV_A), state + 8);
-
-    keccak::permute<s_h>(state);
-
-    // --- end initialization ---
-
-    // --- begin absorbing associated data ---
-    {
-      uint64_t buf0[(rate + 7) / 8];
-      uint64_t buf1[(rate + 7) / 8];
-
-      size_t off = 0;
-      while (off < dlen) {
-        const size_t elen = std::min(rate, dlen - off);
-
-        std::memset(buf0, 0, sizeof(buf0));
-        isap_utils::copy_bytes_to_le_u64(data + off, elen, buf0);
-        isap_utils::copy_le_u16_to_le_u64(state, sizeof(buf1), buf1);
-
-        for (size_t i = 0; i < (rate + 7) / 8; i++) {
-          buf1[i] ^= buf0[i];
-        }
-
-        isap_utils::copy_le_u64_to_le_u16(buf1, state, sizeof(buf1));
-        off += elen;
-
-        if (elen == rate) {
-          keccak::permute<s_h>(state);
-        }
-      }
-
-      const size_t rm_bytes = dlen % rate;
-      const size_t soff = rm_bytes >> 1;
-      const size_t boff = (rm_bytes & 1) * 8;
-
-      const uint16_t w = static_cast<uint16_t>(seperator) << boff;
-      state[soff] ^= w;
-
-      keccak::permute<s_h>(state);
-
-      state[24] ^= 0b1 << 8; // seperator between associated data & cipher text
-    }
-    // --- end absorbing associated data ---
-
-    // --- begin absorbing cipher text ---
-    {
-      uint64_t buf0[(rate + 7) / 8];
-      uint64_t buf1[(rate + 7) / 8];
-
-      size_t off = 0;
-      while (off < clen) {
-        const size_t elen = std::min(rate, clen - off);
-
-        std::memset(buf0, 0, sizeof(buf0));
-        isap_utils::copy_bytes_to_le_u64(cipher + off, elen, buf0);
-        isap_utils::copy_le_u16_to_le_u64(state, sizeof(buf1), buf1);
-
-        for (size_t i = 0; i < (rate + 7) / 8; i++) {
-          buf1[i] ^= buf0[i];
-        }
-
-        isap_utils::copy_le_u64_to_le_u16(buf1, state, sizeof(buf1));
-        off += elen;
-
-        if (elen == rate) {
-          keccak::permute<s_h>(state);
-        }
-      }
-
-      const size_t rm_bytes = clen % rate;
-      const size_t soff = rm_bytes >> 1;
-      const size_t boff = (rm_bytes & 1) * 8;
-
-      const uint16_t w = static_cast<uint16_t>(seperator) << boff;
-      state[soff] ^= w;
-
-      keccak::permute<s_h>(state);
-    }
-    // --- end absorbing cipher text ---
-
-    // --- begin squeezing tag ---
-
-    uint8_t y[knt_len];
-    uint8_t skey[knt_len];
-
-    isap_utils::copy_le_u16_to_bytes(state, y, knt_len);
-    rekeying<p, rk_flag_t::MAC, s_b, s_k, s_e, s_h>(key, y, skey);
-    isap_utils::copy_bytes_to_le_u16(skey, knt_len, state);
-
-    keccak::permute<s_h>(state);
-
-    isap_utils::copy_le_u16_to_bytes(state, tag, knt_len);
+  mac_init<p, s_b, s_k, s_e, s_h>(nonce, state);
+  mac_absorb<p, s_b, s_k, s_e, s_h>(state, data, dlen);
+  mac_domain_separate<p, s_b, s_k, s_e, s_h>(state);
+  mac_absorb<p, s_b, s_k, s_e, s_h>(state, cipher, clen);
+  mac_finalize<p, s_b, s_k, s_e, s_h>(key, state, tag);
+}
 
-    // --- end squeezing tag ---
+// Given two 16 -bytes authentication tags, this routine compares them in
+// constant-time i.e. looking at all bytes, no matter where they first differ,
+// returning boolean truth value only when they're equal
+inline static bool
+tag_equal(const uint8_t* const __restrict a, const uint8_t* const __restrict b)
+{
+  uint8_t diff = 0;
+  for (size_t i = 0; i < knt_len; i++) {
+    diff |= a[i] ^ b[i];
   }
+
+  return diff == 0;
 }
 
 }
@@ -0,0 +1,74 @@
+#pragma once
+#include "common.hpp"
+
+// Estimated cost of ISAP routines, in # -of permutation rounds executed, which
+// is used by benchmarks for reporting rounds executed per second & by
+// tools/isap_kat.cpp for checking instrumentation counters
+namespace isap_cost {
+
+// Estimated # -of permutation rounds executed by `rekeying` routine i.e.
+// initialization, absorption of 127 bits ( one bit at a time ) & absorption of
+// final bit, see algorithm 4 of ISAP specification
+//
+// https://csrc.nist.gov/CSRC/media/Projects/lightweight-cryptography/documents/finalist-round/updated-spec-doc/isap-spec-final.pdf
+template<const size_t s_b, const size_t s_k>
+static inline constexpr size_t
+rekeying_rounds()
+{
+  constexpr size_t bits = isap_common::knt_len << 3;
+  return s_k + (bits - 1) * s_b + s_k;
+}
+
+// Estimated # -of permutation rounds executed for squeezing key stream, which
+// is used for encrypting/ decrypting N -bytes message
+template<const isap_common::perm_t p, const size_t s_e>
+static inline constexpr size_t
+keystream_rounds(const size_t mlen)
+{
+  constexpr size_t rate = isap_common::RATE[static_cast<uint32_t>(p)];
+  return ((mlen + rate - 1) / rate) * s_e;
+}
+
+// Estimated # -of permutation rounds executed for absorbing N -bytes associated
+// data & M -bytes cipher text ( both padded ) into suffix-MAC sponge
+template<const isap_common::perm_t p, const size_t s_h>
+static inline constexpr size_t
+mac_absorb_rounds(const size_t dlen, const size_t clen)
+{
+  constexpr size_t rate = isap_common::RATE[static_cast<uint32_t>(p)];
+  return ((dlen / rate + 1) + (clen / rate + 1)) * s_h;
+}
+
+// Estimated # -of permutation rounds executed by suffix-MAC routine, when
+// authenticating N -bytes associated data & M -bytes cipher text
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_h>
+static inline constexpr size_t
+mac_rounds(const size_t dlen, const size_t clen)
+{
+  constexpr size_t rk = rekeying_rounds<s_b, s_k>();
+  return s_h + mac_absorb_rounds<p, s_h>(dlen, clen) + rk + s_h;
+}
+
+// Estimated # -of permutation rounds executed by ISAP encrypt/ decrypt routine,
+// when processing N -bytes associated data & M -bytes message. Encryption
+// rekeying is skipped when there's no message byte.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static inline constexpr size_t
+aead_rounds(const size_t dlen, const size_t mlen)
+{
+  constexpr size_t rk = rekeying_rounds<s_b, s_k>();
+
+  const size_t enc = mlen > 0 ? rk + keystream_rounds<p, s_e>(mlen) : 0;
+  const size_t mac = mac_rounds<p, s_b, s_k, s_h>(dlen, mlen);
+
+  return enc + mac;
+}
+
+}
@@ -0,0 +1,357 @@
+#pragma once
+#include "aead.hpp"
+#include "common.hpp"
+#include <algorithm>
+#include <vector>
+
+// Fan-out encryption of a single plain text & associated data under many
+// recipients' ( secret key, nonce ) pairs, producing per-recipient cipher text
+// & authentication tag, same as what `isap::encrypt` computes for each of them.
+//
+// When `ISAP_NEON` is set, recipients are processed in groups of `LANES` ( two
+// for Ascon-p, eight for Keccak-p[400] ), whose encryption & suffix-MAC
+// sponges are run side by side, in lanes of multi-state permutation ( see
+// `ascon::state_x2` & `keccak::state400_x8` ). All groups stay resident, while
+// plain text & associated data are walked only once, so that each block is
+// loaded & converted to words only once, no matter how many recipients there
+// are, while full cipher text blocks are absorbed into suffix-MAC, right out
+// of words they're computed in.
+//
+// Elsewhere, multi-state permutations permute one state after another, so
+// grouping recipients only adds bookkeeping on top of per-recipient rekeying,
+// which dominates. Hence each recipient is encrypted using `isap::encrypt`.
+namespace isap_fanout {
+
+using isap_common::perm_t;
+using isap_common::state_t;
+
+#if ISAP_NEON
+
+// Group of sponge states, one per recipient, as kept in lanes of multi-state
+// permutation
+template<const perm_t p>
+struct lanes_t
+{
+  using multi_t = std::conditional_t<p == perm_t::ASCON,
+                                     ascon::state_x2,
+                                     keccak::state400_x8>;
+  using word_t = std::remove_cvref_t<decltype(state_t<p>{}[0])>;
+
+  static constexpr size_t LANES = multi_t::LANES;
+
+  multi_t m;
+
+  // i -th word of j -th state
+  inline constexpr word_t& word(const size_t i, const size_t j)
+  {
+    return m.w[i][j];
+  }
+
+  inline constexpr void insert(const size_t j, const state_t<p>& s)
+  {
+    m.insert(j, s);
+  }
+
+  inline constexpr state_t<p> extract(const size_t j) const
+  {
+    return m.extract(j);
+  }
+
+  // Applies ROUNDS -many rounds of permutation on all states, at once
+  template<const size_t ROUNDS>
+  inline void permute()
+  {
+    m.template permute<ROUNDS>();
+  }
+
+  // XORs N leading words of given state into j -th state
+  inline constexpr void xor_words(const size_t j,
+                                  const state_t<p>& b,
+                                  const size_t n)
+  {
+    for (size_t i = 0; i < n; i++) {
+      word(i, j) ^= b[i];
+    }
+  }
+};
+
+// Derives session key for each lane, given 16 -bytes secret key & 16 -bytes
+// string Y of each of them, same as `isap_common::rekeying` does, leaving
+// rekeying sponge states ( whose leading bytes are session keys ) in lanes.
+// Each bit of Y is injected into respective lane, before all lanes are
+// permuted at once.
+template<const perm_t p,
+         const isap_common::rk_flag_t f,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static void
+rekeying(const uint8_t* const (&key)[lanes_t<p>::LANES],
+         const uint8_t* const (&y)[lanes_t<p>::LANES],
+         lanes_t<p>& m)
+{
+  using namespace isap_common;
+
+  constexpr size_t slen = PERM_STATE_LEN[static_cast<uint32_t>(p)];
+  constexpr size_t z = f == rk_flag_t::ENC ? slen - knt_len : knt_len;
+
+  using word_t = typename lanes_t<p>::word_t;
+
+  constexpr size_t L = lanes_t<p>::LANES;
+
+  // first bit of state is most significant bit of first Ascon-p word, while
+  // it's bit 7 of first Keccak-p[400] lane
+  constexpr uint64_t msb = uint64_t{ 1 } << 63;
+  constexpr size_t shr = p == perm_t::ASCON ? 0 : 56;
+
+  isap_instr::absorb<isap_instr::sponge_t::REKEYING>(L * knt_len);
+  isap_instr::squeeze<isap_instr::sponge_t::REKEYING>(L * z);
+
+  // Y of each lane, as two big-endian 64 -bit words, whose bits are consumed
+  // from most significant one
+  uint64_t v[L][2];
+  for (size_t j = 0; j < L; j++) {
+    state_t<p> s;
+    rekeying_init<p, f, s_b, s_k, s_e, s_h>(key[j], s);
+    m.insert(j, s);
+
+    isap_utils::copy_bytes_to_be_u64(y[j], knt_len, v[j]);
+  }
+
+  for (size_t w = 0; w < 2; w++) {
+    const size_t cnt = w == 0 ? 64 : 63;
+
+    for (size_t i = 0; i < cnt; i++) {
+      for (size_t j = 0; j < L; j++) {
+        m.word(0, j) ^= static_cast<word_t>((v[j][w] & msb) >> shr);
+        v[j][w] <<= 1;
+      }
+      m.template permute<s_b>();
+    }
+  }
+
+  for (size_t j = 0; j < L; j++) {
+    m.word(0, j) ^= static_cast<word_t>((v[j][1] & msb) >> shr);
+  }
+  m.template permute<s_k>();
+}
+
+// Sponge states of a group of recipients, where lanes beyond last recipient
+// repeat it, while their output is discarded
+template<const perm_t p>
+struct group_t
+{
+  lanes_t<p> enc;
+  lanes_t<p> mac;
+  size_t idx[lanes_t<p>::LANES];
+  size_t active;
+};
+
+#endif
+
+// Given K ( >=0 ) recipients' 16 -bytes secret keys & 16 -bytes public message
+// nonces ( each concatenated i.e. i -th key is at `keys[16 * i]` ), N ( >=0 )
+// -bytes associated data & M ( >=0 ) -bytes plain text, this routine computes M
+// -bytes cipher text & 16 -bytes authentication tag for each recipient, using
+// ISAP instance chosen by template parameters. i -th cipher text is written at
+// `enc[M * i]` & i -th tag is written at `tags[16 * i]`.
+//
+// Output is same as calling `isap::encrypt` for each recipient, while plain
+// text & associated data are loaded only once, when `ISAP_NEON` is set. Note,
+// each recipient must use a unique nonce under its secret key, same as for
+// `isap::encrypt`.
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+inline static void
+encrypt(const uint8_t* const __restrict keys,
+        const uint8_t* const __restrict nonces,
+        const size_t cnt,
+        const uint8_t* const __restrict data,
+        const size_t dlen,
+        const uint8_t* const __restrict msg,
+        const size_t mlen,
+        uint8_t* const __restrict enc,
+        uint8_t* const __restrict tags)
+{
+  using namespace isap_common;
+
+#if ISAP_NEON
+  constexpr size_t L = lanes_t<p>::LANES;
+  constexpr size_t slen = PERM_STATE_LEN[static_cast<uint32_t>(p)];
+  constexpr size_t rate = RATE[static_cast<uint32_t>(p)];
+  constexpr size_t z = slen - knt_len;
+
+  // # -of words in state & in its rate portion
+  constexpr size_t swords = slen / sizeof(typename lanes_t<p>::word_t);
+  constexpr size_t rwords = rate / sizeof(typename lanes_t<p>::word_t);
+
+  constexpr uint8_t seperator = 0b10000000;
+
+  if (cnt == 0) {
+    return;
+  }
+
+  std::vector<group_t<p>> grps((cnt + L - 1) / L);
+
+  // --- initialize encryption & suffix-MAC sponges of each group ---
+
+  for (size_t g = 0; g < grps.size(); g++) {
+    group_t<p>& grp = grps[g];
+
+    const uint8_t* key[L];
+    const uint8_t* nonce[L];
+
+    grp.active = std::min(L, cnt - g * L);
+    for (size_t j = 0; j < L; j++) {
+      grp.idx[j] = std::min(g * L + j, cnt - 1);
+      key[j] = keys + grp.idx[j] * knt_len;
+      nonce[j] = nonces + grp.idx[j] * knt_len;
+    }
+
+    // no key stream is needed, when there's no message byte
+    if (mlen > 0) {
+      rekeying<p, rk_flag_t::ENC, s_b, s_k, s_e, s_h>(key, nonce, grp.enc);
+
+      for (size_t j = 0; j < L; j++) {
+        state_t<p> s = grp.enc.extract(j);
+        s.set_bytes(nonce[j], z, knt_len);
+        grp.enc.insert(j, s);
+      }
+    }
+
+    for (size_t j = 0; j < L; j++) {
+      state_t<p> s;
+      mac_init<p, s_b, s_k, s_e, s_h>(nonce[j], s);
+      grp.mac.insert(j, s);
+    }
+  }
+
+  // --- absorb associated data, loading each block once ---
+
+  isap_instr::absorb<isap_instr::sponge_t::MAC>(cnt * dlen);
+
+  for (size_t off = 0; off <= dlen; off += rate) {
+    const size_t blen = std::min(rate, dlen - off);
+
+    state_t<p> b{};
+    b.xor_bytes(data + off, blen);
+    if (blen < rate) {
+      b.xor_byte(blen, seperator);
+    }
+
+    for (auto& grp : grps) {
+      for (size_t j = 0; j < L; j++) {
+        grp.mac.xor_words(j, b, rwords);
+      }
+      grp.mac.template permute<s_h>();
+    }
+  }
+
+  state_t<p> dsep{};
+  dsep.xor_byte(slen - 1, 0b1);
+
+  for (auto& grp : grps) {
+    for (size_t j = 0; j < L; j++) {
+      grp.mac.xor_words(j, dsep, swords);
+    }
+  }
+
+  // --- encrypt plain text, loading each block once, while absorbing full
+  // cipher text blocks into suffix-MAC right away ---
+
+  isap_instr::squeeze<isap_instr::sponge_t::ENC>(cnt * mlen);
+  isap_instr::absorb<isap_instr::sponge_t::MAC>(cnt * mlen);
+
+  const size_t full = mlen - mlen % rate;
+
+  for (size_t off = 0; off < mlen; off += rate) {
+    const size_t blen = std::min(rate, mlen - off);
+
+    state_t<p> b{};
+    b.xor_bytes(msg + off, blen);
+
+    for (auto& grp : grps) {
+      grp.enc.template permute<s_e>();
+
+      for (size_t j = 0; j < grp.active; j++) {
+        state_t<p> c{};
+        for (size_t i = 0; i < rwords; i++) {
+          c[i] = grp.enc.word(i, j) ^ b[i];
+        }
+
+        c.extract_bytes(enc + grp.idx[j] * mlen + off, blen);
+        if (blen == rate) {
+          grp.mac.xor_words(j, c, rwords);
+        }
+      }
+
+      if (blen == rate) {
+        grp.mac.template permute<s_h>();
+      }
+    }
+  }
+
+  // last ( possibly empty ) cipher text block, padded using 10* rule, differs
+  // for each recipient
+  for (auto& grp : grps) {
+    for (size_t j = 0; j < grp.active; j++) {
+      state_t<p> c{};
+      c.xor_bytes(enc + grp.idx[j] * mlen + full, mlen - full);
+      c.xor_byte(mlen - full, seperator);
+
+      grp.mac.xor_words(j, c, rwords);
+    }
+    grp.mac.template permute<s_h>();
+  }
+
+  // --- finalize suffix-MAC of each group ---
+
+  isap_instr::squeeze<isap_instr::sponge_t::MAC>(cnt * (knt_len << 1));
+
+  for (auto& grp : grps) {
+    uint8_t y[L][knt_len];
+    const uint8_t* key[L];
+    const uint8_t* yp[L];
+
+    for (size_t j = 0; j < L; j++) {
+      grp.mac.extract(j).extract_bytes(y[j], knt_len);
+      key[j] = keys + grp.idx[j] * knt_len;
+      yp[j] = y[j];
+    }
+
+    lanes_t<p> rk;
+    rekeying<p, rk_flag_t::MAC, s_b, s_k, s_e, s_h>(key, yp, rk);
+
+    for (size_t j = 0; j < L; j++) {
+      uint8_t skey[knt_len];
+      rk.extract(j).extract_bytes(skey, knt_len);
+
+      state_t<p> s = grp.mac.extract(j);
+      s.set_bytes(skey, 0, knt_len);
+      grp.mac.insert(j, s);
+    }
+    grp.mac.template permute<s_h>();
+
+    for (size_t j = 0; j < grp.active; j++) {
+      grp.mac.extract(j).extract_bytes(tags + grp.idx[j] * knt_len, knt_len);
+    }
+  }
+#else
+  for (size_t i = 0; i < cnt; i++) {
+    isap::encrypt<p, s_b, s_k, s_e, s_h>(keys + i * knt_len,
+                                         nonces + i * knt_len,
+                                         data,
+                                         dlen,
+                                         msg,
+                                         enc + i * mlen,
+                                         mlen,
+                                         tags + i * knt_len);
+  }
+#endif
+}
+
+}
@@ -0,0 +1,273 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+// Optional, compile-time enabled instrumentation of ISAP AEAD, counting
+// permutation invocations, rounds executed & bytes absorbed/ squeezed by each
+// sponge, along with log2 latency histograms of top-level encrypt/ decrypt
+// calls.
+//
+// Define `ISAP_INSTRUMENT` for enabling counters & additionally define
+// `ISAP_INSTRUMENT_LATENCY` for enabling latency histograms. When not defined,
+// all instrumentation hooks are empty and compile to nothing.
+namespace isap_instr {
+
+#if defined ISAP_INSTRUMENT
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+#if defined ISAP_INSTRUMENT && defined ISAP_INSTRUMENT_LATENCY
+constexpr bool latency_enabled = true;
+#else
+constexpr bool latency_enabled = false;
+#endif
+
+// Permutations being instrumented, indexed same as `isap_common::perm_t`
+enum class perm_t : size_t
+{
+  ASCON,
+  KECCAK
+};
+
+// Sponges being instrumented i.e. session key derivation ( rekeying ), key
+// stream generation ( encryption ) & suffix-MAC computation ( authentication )
+enum class sponge_t : size_t
+{
+  REKEYING,
+  ENC,
+  MAC
+};
+
+// Top-level operations, whose latency is recorded in log2 histograms
+enum class op_t : size_t
+{
+  ENCRYPT,
+  DECRYPT
+};
+
+// # -of buckets in latency histogram, where bucket i holds # -of calls which
+// took [2^(i-1), 2^i) nanoseconds ( bucket 0 holds calls taking < 1ns )
+constexpr size_t HIST_BUCKETS = 64;
+
+// Point-in-time copy of instrumentation counters. It's a standard layout type,
+// so that same layout can be used from C ABI.
+struct snapshot_t
+{
+  uint64_t perm_calls[2];  // permutation invocations, indexed by `perm_t`
+  uint64_t perm_rounds[2]; // permutation rounds executed, indexed by `perm_t`
+  uint64_t absorbed[3];    // bytes absorbed, indexed by `sponge_t`
+  uint64_t squeezed[3];    // bytes squeezed, indexed by `sponge_t`
+  uint64_t latency[2][HIST_BUCKETS]; // log2 ns histogram, indexed by `op_t`
+};
+
+// # -of 64 -bit counters in a snapshot
+constexpr size_t COUNTER_CNT = sizeof(snapshot_t) / sizeof(uint64_t);
+
+// Offsets of counter groups in flattened snapshot
+constexpr size_t OFF_PERM_CALLS = 0;
+constexpr size_t OFF_PERM_ROUNDS = 2;
+constexpr size_t OFF_ABSORBED = 4;
+constexpr size_t OFF_SQUEEZED = 7;
+constexpr size_t OFF_LATENCY = 10;
+
+static_assert(OFF_LATENCY + 2 * HIST_BUCKETS == COUNTER_CNT);
+
+// Per-thread counters, only ever updated by owning thread ( so relaxed load
+// followed by relaxed store suffices ), while being readable from any thread
+struct alignas(64) counters_t
+{
+  std::atomic<uint64_t> vals[COUNTER_CNT]{};
+
+  inline void add(const size_t idx, const uint64_t v)
+  {
+    const uint64_t cur = vals[idx].load(std::memory_order_relaxed);
+    vals[idx].store(cur + v, std::memory_order_relaxed);
+  }
+
+  inline void collect(uint64_t* const out) const
+  {
+    for (size_t i = 0; i < COUNTER_CNT; i++) {
+      out[i] += vals[i].load(std::memory_order_relaxed);
+    }
+  }
+};
+
+// Registry of counters of all live threads, along with accumulated counters of
+// threads which have already exited
+struct registry_t
+{
+  std::mutex lock;
+  std::vector<const counters_t*> live;
+  uint64_t retired[COUNTER_CNT]{};
+};
+
+// Process-wide registry. Note, it's deliberately not `static`, so that all
+// translation units share same registry.
+inline registry_t&
+registry()
+{
+  static registry_t reg;
+  return reg;
+}
+
+// Owner of calling thread's counters, registering them on construction &
+// retiring them on thread exit
+struct holder_t
+{
+  counters_t ctrs;
+
+  holder_t()
+  {
+    registry_t& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    reg.live.push_back(&ctrs);
+  }
+
+  ~holder_t()
+  {
+    registry_t& reg = registry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+
+    ctrs.collect(reg.retired);
+    std::erase(reg.live, &ctrs);
+  }
+};
+
+// Counters of calling thread. Note, it's deliberately not `static`, so that all
+// translation units share same thread-local counters.
+inline counters_t&
+local()
+{
+  thread_local holder_t holder;
+  return holder.ctrs;
+}
+
+// Records invocation of permutation, executing given # -of rounds
+template<const perm_t p>
+static inline void
+permute(const size_t rounds)
+{
+  if constexpr (enabled) {
+    counters_t& c = local();
+    c.add(OFF_PERM_CALLS + static_cast<size_t>(p), 1);
+    c.add(OFF_PERM_ROUNDS + static_cast<size_t>(p), rounds);
+  }
+}
+
+// Records N -bytes being absorbed into sponge
+template<const sponge_t s>
+static inline void
+absorb(const size_t blen)
+{
+  if constexpr (enabled) {
+    local().add(OFF_ABSORBED + static_cast<size_t>(s), blen);
+  }
+}
+
+// Records N -bytes being squeezed out of sponge
+template<const sponge_t s>
+static inline void
+squeeze(const size_t blen)
+{
+  if constexpr (enabled) {
+    local().add(OFF_SQUEEZED + static_cast<size_t>(s), blen);
+  }
+}
+
+// Scoped timer, recording wall clock latency of a top-level operation into
+// log2 histogram of calling thread, when it goes out of scope. When latency
+// histograms are disabled, it's an empty type, which compiles to nothing.
+template<const op_t o, const bool = latency_enabled>
+struct latency_timer_t
+{};
+
+template<const op_t o>
+struct latency_timer_t<o, true>
+{
+  const std::chrono::steady_clock::time_point beg;
+
+  latency_timer_t()
+    : beg(std::chrono::steady_clock::now())
+  {}
+
+  ~latency_timer_t()
+  {
+    using namespace std::chrono;
+
+    const auto end = steady_clock::now();
+    const auto ns = duration_cast<nanoseconds>(end - beg).count();
+
+    const uint64_t v = static_cast<uint64_t>(ns < 0 ? 0 : ns);
+    const size_t bkt = std::min<size_t>(std::bit_width(v), HIST_BUCKETS - 1);
+
+    const size_t off = OFF_LATENCY + static_cast<size_t>(o) * HIST_BUCKETS;
+    local().add(off + bkt, 1);
+  }
+};
+
+// Snapshot of instrumentation counters of calling thread
+static inline snapshot_t
+thread_snapshot()
+{
+  snapshot_t snap{};
+
+  if constexpr (enabled) {
+    uint64_t vals[COUNTER_CNT]{};
+    local().collect(vals);
+
+    std::memcpy(&snap, vals, sizeof(snap));
+  }
+  return snap;
+}
+
+// Snapshot of instrumentation counters, aggregated over all threads ( both live
+// & already exited ) of the process
+static inline snapshot_t
+snapshot()
+{
+  snapshot_t snap{};
+
+  if constexpr (enabled) {
+    uint64_t vals[COUNTER_CNT]{};
+
+    {
+      registry_t& reg = registry();
+      std::lock_guard<std::mutex> guard(reg.lock);
+
+      for (size_t i = 0; i < COUNTER_CNT; i++) {
+        vals[i] = reg.retired[i];
+      }
+      for (const counters_t* c : reg.live) {
+        c->collect(vals);
+      }
+    }
+
+    std::memcpy(&snap, vals, sizeof(snap));
+  }
+  return snap;
+}
+
+// Resets instrumentation counters of calling thread to zero. For observing
+// activity of other threads, take two process-wide snapshots & compute their
+// difference.
+static inline void
+reset()
+{
+  if constexpr (enabled) {
+    counters_t& c = local();
+    for (size_t i = 0; i < COUNTER_CNT; i++) {
+      c.vals[i].store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include "aead.hpp"
 #include "common.hpp"
+#include "fanout.hpp"
+#include "nonce.hpp"
 
 // ISAP-K-128A authenticated encryption with associated data ( AEAD )
 namespace isap_k_128a {
@@ -17,8 +19,8 @@ encrypt(const uint8_t* const __restrict key,
         const uint8_t* const __restrict nonce,
         const uint8_t* const __restrict data,
         const size_t dlen,
-        const uint8_t* const __restrict msg,
-        uint8_t* const __restrict enc,
+        const uint8_t* const msg,
+        uint8_t* const enc,
         const size_t mlen,
         uint8_t* const __restrict tag)
 {
@@ -39,12 +41,140 @@ decrypt(const uint8_t* const __restrict key,
         const uint8_t* const __restrict tag,
         const uint8_t* const __restrict data,
         const size_t dlen,
-        const uint8_t* const __restrict enc,
-        uint8_t* const __restrict msg,
+        const uint8_t* const enc,
+        uint8_t* const msg,
         const size_t mlen)
 {
   return isap::decrypt<isap_common::perm_t::KECCAK, 1, 8, 8, 16>(
     key, nonce, tag, data, dlen, enc, msg, mlen);
 }
 
+// Given 16 -bytes secret key, 16 -bytes public message nonce, N ( >=0 ) -bytes
+// associated data, this routine computes 16 -bytes authentication tag, without
+// encrypting anything, using Isap-K-128A algorithm. Tag is same as what
+// `encrypt` computes for empty plain text, while encryption rekeying is
+// skipped.
+inline static void
+authenticate(const uint8_t* const __restrict key,
+             const uint8_t* const __restrict nonce,
+             const uint8_t* const __restrict data,
+             const size_t dlen,
+             uint8_t* const __restrict tag)
+{
+  isap::authenticate<isap_common::perm_t::KECCAK, 1, 8, 8, 16>(
+    key, nonce, data, dlen, tag);
+}
+
+// Given 16 -bytes secret key, 16 -bytes public message nonce, 16 -bytes
+// authentication tag, N ( >=0 ) -bytes associated data, this routine checks tag
+// computed by `authenticate`, returning boolean verification flag, using
+// Isap-K-128A algorithm
+inline static bool
+verify(const uint8_t* const __restrict key,
+       const uint8_t* const __restrict nonce,
+       const uint8_t* const __restrict tag,
+       const uint8_t* const __restrict data,
+       const size_t dlen)
+{
+  return isap::verify<isap_common::perm_t::KECCAK, 1, 8, 8, 16>(
+    key, nonce, tag, data, dlen);
+}
+
+// Given 16 -bytes secret key, 16 -bytes public message nonce, 16 -bytes
+// authentication tag, N ( >=0 ) -bytes associated data, M ( >=0 ) -bytes cipher
+// text, this routine checks tag without decrypting cipher text, returning
+// boolean verification flag, using Isap-K-128A algorithm
+inline static bool
+verify(const uint8_t* const __restrict key,
+       const uint8_t* const __restrict nonce,
+       const uint8_t* const __restrict tag,
+       const uint8_t* const __restrict data,
+       const size_t dlen,
+       const uint8_t* const __restrict cipher,
+       const size_t clen)
+{
+  return isap::verify<isap_common::perm_t::KECCAK, 1, 8, 8, 16>(
+    key, nonce, tag, data, dlen, cipher, clen);
+}
+
+// Given 16 -bytes secret key & K ( >=0 ) -many messages, laid out flat ( see
+// `isap::verify_batch` ), this routine checks tag of each message, without
+// decrypting any of them, writing K boolean verification flags & returning #
+// -of valid messages, using Isap-K-128A algorithm
+inline static size_t
+verify_batch(const uint8_t* const __restrict key,
+             const uint8_t* const __restrict nonces,
+             const uint8_t* const __restrict tags,
+             const uint8_t* const __restrict data,
+             const size_t* const __restrict dlens,
+             const uint8_t* const __restrict cipher,
+             const size_t* const __restrict clens,
+             const size_t cnt,
+             bool* const __restrict flags)
+{
+  return isap::verify_batch<isap_common::perm_t::KECCAK, 1, 8, 8, 16>(
+    key, nonces, tags, data, dlens, cipher, clens, cnt, flags);
+}
+
+// Given K ( >=0 ) recipients' 16 -bytes secret keys & 16 -bytes public message
+// nonces ( each concatenated ), N ( >=0 ) -bytes associated data, M ( >=0 )
+// -bytes plain text, this routine computes M -bytes cipher text & 16 -bytes
+// authentication tag for each recipient ( see `isap_fanout::encrypt` ), using
+// Isap-K-128A algorithm
+inline static void
+encrypt_fanout(const uint8_t* const __restrict keys,
+               const uint8_t* const __restrict nonces,
+               const size_t cnt,
+               const uint8_t* const __restrict data,
+               const size_t dlen,
+               const uint8_t* const __restrict msg,
+               const size_t mlen,
+               uint8_t* const __restrict enc,
+               uint8_t* const __restrict tags)
+{
+  isap_fanout::encrypt<isap_common::perm_t::KECCAK, 1, 8, 8, 16>(
+    keys, nonces, cnt, data, dlen, msg, mlen, enc, tags);
+}
+
+// Given nonce sequencer, 16 -bytes secret key, N ( >=0 ) -bytes associated
+// data, M ( >=0 ) -bytes plain text, this routine takes next unique nonce out
+// of sequencer ( see include/nonce.hpp ) & computes M -bytes cipher text along
+// with 16 -bytes authentication tag, using Isap-K-128A algorithm. Used 16
+// -bytes nonce is written to `nonce`. Returned boolean flag holds truth value
+// only if nonce space is not yet exhausted.
+inline static bool
+encrypt_auto_nonce(isap_nonce::sequencer_t& seq,
+                   const uint8_t* const __restrict key,
+                   const uint8_t* const __restrict data,
+                   const size_t dlen,
+                   const uint8_t* const msg,
+                   uint8_t* const enc,
+                   const size_t mlen,
+                   uint8_t* const __restrict tag,
+                   uint8_t* const __restrict nonce)
+{
+  using isap_common::perm_t;
+
+  return isap_nonce::encrypt_auto_nonce<perm_t::KECCAK, 1, 8, 8, 16>(
+    seq, key, data, dlen, msg, enc, mlen, tag, nonce);
+}
+
+// Same as above, but takes nonce out of given per-thread stream
+inline static bool
+encrypt_auto_nonce(isap_nonce::stream_t& st,
+                   const uint8_t* const __restrict key,
+                   const uint8_t* const __restrict data,
+                   const size_t dlen,
+                   const uint8_t* const msg,
+                   uint8_t* const enc,
+                   const size_t mlen,
+                   uint8_t* const __restrict tag,
+                   uint8_t* const __restrict nonce)
+{
+  using isap_common::perm_t;
+
+  return isap_nonce::encrypt_auto_nonce<perm_t::KECCAK, 1, 8, 8, 16>(
+    st, key, data, dlen, msg, enc, mlen, tag, nonce);
+}
+
 }
@@ -1,7 +1,32 @@
 #pragma once
+#include "instrument.hpp"
 #include <bit>
 #include <cstddef>
 #include <cstdint>
+#include <utility>
+
+// See include/ascon.hpp
+#if !defined ISAP_PERM_UNROLL
+#define ISAP_PERM_UNROLL 0
+#endif
+
+// Keccak-p[400] permutation works on 16 -bit lanes, lane by lane, following
+// step mappings of FIPS 202, when this is 0 ( default ). Otherwise, it works on
+// lanes widened to 32 -bit words, in-place ( see `permute_wide` ), which should
+// be preferred on CPUs, where 16 -bit operations are slower than native word
+// sized ones & there's no useful SIMD.
+#if !defined ISAP_KECCAK_WIDE
+#define ISAP_KECCAK_WIDE 0
+#endif
+
+// See include/ascon.hpp
+#if !defined ISAP_NEON
+#define ISAP_NEON 0
+#endif
+
+#if ISAP_NEON
+#include <arm_neon.h>
+#endif
 
 // Keccak-p[400] permutation, adapted from my previous work on Keccak-p[1600]
 // https://github.com/itzmeanjan/merklize-sha/blob/53c339d/include/sha3.hpp
@@ -173,19 +198,665 @@ round(uint16_t* const state, const size_t r_idx)
   iota(state, r_idx);
 }
 
+// keccak-p[400] round function, indexed by round, so that its constant is an
+// immediate operand
+template<const size_t R>
+static inline constexpr void
+round(uint16_t* const state)
+  requires(R < MAX_ROUNDS)
+{
+  round(state, R);
+}
+
+// Applies rounds BEG + I, for each I in index sequence, as straight-line code
+template<const size_t BEG, size_t... I>
+static inline constexpr void
+rounds(uint16_t* const state, std::index_sequence<I...>)
+{
+  (round<BEG + I>(state), ...);
+}
+
 // keccak-p[400] permutation, applying ROUNDS -many rounds of permutation
 // on state of dimension 5 x 5 x 16, using algorithm 7 defined in section 3.3 of
 // http://dx.doi.org/10.6028/NIST.FIPS.202
-template<const size_t ROUNDS>
+//
+// State is kept in a local array, while rounds are fully unrolled, unless
+// UNROLL is non-zero & less than ROUNDS, in which case UNROLL -many rounds are
+// run in each loop iteration.
+template<const size_t ROUNDS, const size_t UNROLL = ISAP_PERM_UNROLL>
 static inline constexpr void
-permute(uint16_t* const state)
+permute_ref(uint16_t* const state)
   requires(ROUNDS <= MAX_ROUNDS)
 {
   constexpr size_t beg = MAX_ROUNDS - ROUNDS;
 
-  for (size_t i = beg; i < MAX_ROUNDS; i++) {
-    round(state, i);
+  isap_instr::permute<isap_instr::perm_t::KECCAK>(ROUNDS);
+
+  uint16_t s[25];
+  for (size_t i = 0; i < 25; i++) {
+    s[i] = state[i];
+  }
+
+  if constexpr (UNROLL == 0 || UNROLL >= ROUNDS) {
+    rounds<beg>(s, std::make_index_sequence<ROUNDS>{});
+  } else {
+    constexpr size_t rem = ROUNDS % UNROLL;
+
+    // leftover rounds first, so that loop runs over whole blocks
+    if constexpr (rem > 0) {
+      rounds<beg>(s, std::make_index_sequence<rem>{});
+    }
+
+    for (size_t i = beg + rem; i < MAX_ROUNDS; i += UNROLL) {
+#if defined __clang__
+#pragma clang loop unroll(full)
+#elif defined __GNUG__
+#pragma GCC unroll 20
+#endif
+      for (size_t j = 0; j < UNROLL; j++) {
+        round(s, i + j);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < 25; i++) {
+    state[i] = s[i];
   }
 }
 
+// Lanes visited by π, when walking its single cycle of 24 lanes ( lane(0, 0) is
+// fixed ), starting from lane 1, such that i -th lane of cycle receives lane
+// preceding it, rotated by RHO_CYCLE[i] ( i.e. ρ offset of preceding lane ), so
+// that ρ & π can be applied together, in-place, holding one lane aside
+//
+// dst = {PERM[i]: i for i in range(25)}
+// src = 1
+// for _ in range(24):
+//     print(dst[src], ROT[src - 1])
+//     src = dst[src]
+//
+// Tables generated using above Python code snippet.
+constexpr size_t PI_CYCLE[24]{ 10, 7,  11, 17, 18, 3,  5,  16,
+                               8,  21, 24, 4,  15, 23, 19, 13,
+                               12, 2,  20, 14, 22, 9,  6,  1 };
+constexpr size_t RHO_CYCLE[24]{ 1,  3,  6,  10, 15, 5, 12, 4,
+                                13, 7,  2,  14, 11, 9, 8,  8,
+                                9,  11, 14, 2,  7,  13, 4, 12 };
+
+// keccak-p[400] round function, working on lanes widened to 32 -bit words,
+// where 16 -bit lane x is kept as x || x. All bitwise operations act on both
+// halves alike, while 16 -bit rotation of x is same as 32 -bit rotation of x ||
+// x, so that each step mapping is done using native word sized operations.
+// Rows are worked on in local variables, so that no temporary state array is
+// needed.
+static inline constexpr void
+round_wide(uint32_t* const state, const uint32_t rc)
+{
+  // θ
+  uint32_t c[5]{};
+
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t x = 0; x < 25; x += 5) {
+    c[0] ^= state[x + 0];
+    c[1] ^= state[x + 1];
+    c[2] ^= state[x + 2];
+    c[3] ^= state[x + 3];
+    c[4] ^= state[x + 4];
+  }
+
+  const uint32_t d0 = c[4] ^ std::rotl(c[1], 1);
+  const uint32_t d1 = c[0] ^ std::rotl(c[2], 1);
+  const uint32_t d2 = c[1] ^ std::rotl(c[3], 1);
+  const uint32_t d3 = c[2] ^ std::rotl(c[4], 1);
+  const uint32_t d4 = c[3] ^ std::rotl(c[0], 1);
+
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t x = 0; x < 25; x += 5) {
+    state[x + 0] ^= d0;
+    state[x + 1] ^= d1;
+    state[x + 2] ^= d2;
+    state[x + 3] ^= d3;
+    state[x + 4] ^= d4;
+  }
+
+  // ρ & π, in-place
+  uint32_t t = state[1];
+
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 24
+#endif
+  for (size_t i = 0; i < 24; i++) {
+    const uint32_t u = state[PI_CYCLE[i]];
+    state[PI_CYCLE[i]] = std::rotl(t, RHO_CYCLE[i]);
+    t = u;
+  }
+
+  // χ, a row at a time
+#if defined __clang__
+#pragma clang loop unroll(enable)
+#elif defined __GNUG__
+#pragma GCC unroll 5
+#endif
+  for (size_t y = 0; y < 25; y += 5) {
+    const uint32_t b0 = state[y + 0];
+    const uint32_t b1 = state[y + 1];
+    const uint32_t b2 = state[y + 2];
+    const uint32_t b3 = state[y + 3];
+    const uint32_t b4 = state[y + 4];
+
+    state[y + 0] = b0 ^ (~b1 & b2);
+    state[y + 1] = b1 ^ (~b2 & b3);
+    state[y + 2] = b2 ^ (~b3 & b4);
+    state[y + 3] = b3 ^ (~b4 & b0);
+    state[y + 4] = b4 ^ (~b0 & b1);
+  }
+
+  // ι
+  state[0] ^= rc;
+}
+
+// Round function working on widened lanes, indexed by round, so that its
+// widened constant is an immediate operand
+template<const size_t R>
+static inline constexpr void
+round_wide(uint32_t* const state)
+  requires(R < MAX_ROUNDS)
+{
+  round_wide(state, static_cast<uint32_t>(RC[R]) * 0x10001u);
+}
+
+// Applies rounds BEG + I, on widened lanes, for each I in index sequence, as
+// straight-line code
+template<const size_t BEG, size_t... I>
+static inline constexpr void
+rounds_wide(uint32_t* const state, std::index_sequence<I...>)
+{
+  (round_wide<BEG + I>(state), ...);
+}
+
+// keccak-p[400] permutation, same as `permute_ref`, but working on lanes
+// widened to 32 -bit words ( see `round_wide` ), which are narrowed back, once
+// done with all rounds
+template<const size_t ROUNDS, const size_t UNROLL = ISAP_PERM_UNROLL>
+static inline constexpr void
+permute_wide(uint16_t* const state)
+  requires(ROUNDS <= MAX_ROUNDS)
+{
+  constexpr size_t beg = MAX_ROUNDS - ROUNDS;
+
+  isap_instr::permute<isap_instr::perm_t::KECCAK>(ROUNDS);
+
+  uint32_t s[25];
+  for (size_t i = 0; i < 25; i++) {
+    s[i] = static_cast<uint32_t>(state[i]) * 0x10001u;
+  }
+
+  if constexpr (UNROLL == 0 || UNROLL >= ROUNDS) {
+    rounds_wide<beg>(s, std::make_index_sequence<ROUNDS>{});
+  } else {
+    constexpr size_t rem = ROUNDS % UNROLL;
+
+    // leftover rounds first, so that loop runs over whole blocks
+    if constexpr (rem > 0) {
+      rounds_wide<beg>(s, std::make_index_sequence<rem>{});
+    }
+
+    for (size_t i = beg + rem; i < MAX_ROUNDS; i += UNROLL) {
+#if defined __clang__
+#pragma clang loop unroll(full)
+#elif defined __GNUG__
+#pragma GCC unroll 20
+#endif
+      for (size_t j = 0; j < UNROLL; j++) {
+        round_wide(s, static_cast<uint32_t>(RC[i + j]) * 0x10001u);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < 25; i++) {
+    state[i] = static_cast<uint16_t>(s[i]);
+  }
+}
+
+#if ISAP_NEON
+
+// Byte indices for NEON table lookups on a row vector, holding 5 lanes of a
+// row in its 16 -bit lanes 0..4, selecting lane x - 1, x + 1 & x + 2 ( mod 5 )
+// of same row, for each x. Unused lanes 5..7 are zeroed ( index 0xff ).
+alignas(16) constexpr uint8_t ROW_M1[16]{ 8,   9,   0,   1,   2,   3,
+                                          4,   5,   6,   7,   255, 255,
+                                          255, 255, 255, 255 };
+alignas(16) constexpr uint8_t ROW_P1[16]{ 2,   3,   4,   5,   6,   7,
+                                          8,   9,   0,   1,   255, 255,
+                                          255, 255, 255, 255 };
+alignas(16) constexpr uint8_t ROW_P2[16]{ 4,   5,   6,   7,   8,   9,
+                                          0,   1,   2,   3,   255, 255,
+                                          255, 255, 255, 255 };
+
+// ρ offsets of lanes of each row i.e. RHO_L[y][x] = `rho_of(5 * y + x)`, as
+// signed per-lane shift amounts of left ( RHO_L ) & right ( RHO_R = RHO_L - 16
+// ) shifts, whose OR is the rotation. Unused lanes 5..7 aren't shifted.
+alignas(16) constexpr int16_t RHO_L[5][8]{ { 0, 1, 14, 12, 11, 0, 0, 0 },
+                                           { 4, 12, 6, 7, 4, 0, 0, 0 },
+                                           { 3, 10, 11, 9, 7, 0, 0, 0 },
+                                           { 9, 13, 15, 5, 8, 0, 0, 0 },
+                                           { 2, 2, 13, 8, 14, 0, 0, 0 } };
+alignas(16) constexpr int16_t RHO_R[5][8]{
+  { -16, -15, -2, -4, -5, 0, 0, 0 },  { -12, -4, -10, -9, -12, 0, 0, 0 },
+  { -13, -6, -5, -7, -9, 0, 0, 0 },   { -7, -3, -1, -11, -8, 0, 0, 0 },
+  { -14, -14, -3, -8, -2, 0, 0, 0 }
+};
+
+// Byte indices for NEON table lookups, applying π on row vectors, such that
+// lane x of output row y is lane ( x + 3y ) % 5 of input row x. Lookup into
+// rows 0..3 ( concatenated ) uses PI_TBL, while lane coming from row 4 is
+// inserted using PI_TBX, which keeps other lanes ( index 0xff ).
+alignas(16) constexpr uint8_t PI_TBL[5][16]{
+  { 0, 1, 18, 19, 36, 37, 54, 55, 255, 255, 255, 255, 255, 255, 255, 255 },
+  { 6, 7, 24, 25, 32, 33, 50, 51, 255, 255, 255, 255, 255, 255, 255, 255 },
+  { 2, 3, 20, 21, 38, 39, 56, 57, 255, 255, 255, 255, 255, 255, 255, 255 },
+  { 8, 9, 16, 17, 34, 35, 52, 53, 255, 255, 255, 255, 255, 255, 255, 255 },
+  { 4, 5, 22, 23, 40, 41, 48, 49, 255, 255, 255, 255, 255, 255, 255, 255 }
+};
+alignas(16) constexpr uint8_t PI_TBX[5][16]{
+  { 255, 255, 255, 255, 255, 255, 255, 255, 8, 9, 255, 255, 255, 255, 255,
+    255 },
+  { 255, 255, 255, 255, 255, 255, 255, 255, 4, 5, 255, 255, 255, 255, 255,
+    255 },
+  { 255, 255, 255, 255, 255, 255, 255, 255, 0, 1, 255, 255, 255, 255, 255,
+    255 },
+  { 255, 255, 255, 255, 255, 255, 255, 255, 6, 7, 255, 255, 255, 255, 255,
+    255 },
+  { 255, 255, 255, 255, 255, 255, 255, 255, 2, 3, 255, 255, 255, 255, 255,
+    255 }
+};
+
+// Selects 16 -bit lanes of vector, using byte indices of table lookup
+static inline uint16x8_t
+lookup(const uint16x8_t v, const uint8_t* const idx)
+{
+  const uint8x16_t t = vqtbl1q_u8(vreinterpretq_u8_u16(v), vld1q_u8(idx));
+  return vreinterpretq_u16_u8(t);
+}
+
+// Leftwards circular rotation of all 16 -bit lanes of vector by R -bits
+template<const size_t R>
+static inline uint16x8_t
+rotl_x8(const uint16x8_t v)
+  requires(R < 16)
+{
+  if constexpr (R == 0) {
+    return v;
+  } else {
+    return vsliq_n_u16(vshrq_n_u16(v, 16 - R), v, R);
+  }
+}
+
+// keccak-p[400] round function, on single state, where y -th row of state is
+// held in lanes 0..4 of y -th vector, while lanes 5..7 are kept zeroed. θ & χ
+// work on whole rows, while ρ & π are done using per-lane shifts & table
+// lookups, respectively.
+static inline void
+round_neon(uint16x8_t* const row, const uint16_t rc)
+{
+  const uint16x8_t c = row[0] ^ row[1] ^ row[2] ^ row[3] ^ row[4];
+  const uint16x8_t d = lookup(c, ROW_M1) ^ rotl_x8<1>(lookup(c, ROW_P1));
+
+  for (size_t y = 0; y < 5; y++) {
+    const uint16x8_t t = row[y] ^ d;
+    row[y] = vshlq_u16(t, vld1q_s16(RHO_L[y])) |
+             vshlq_u16(t, vld1q_s16(RHO_R[y]));
+  }
+
+  const uint8x16x4_t lo{ { vreinterpretq_u8_u16(row[0]),
+                           vreinterpretq_u8_u16(row[1]),
+                           vreinterpretq_u8_u16(row[2]),
+                           vreinterpretq_u8_u16(row[3]) } };
+  const uint8x16_t hi = vreinterpretq_u8_u16(row[4]);
+
+  uint16x8_t b[5];
+  for (size_t y = 0; y < 5; y++) {
+    const uint8x16_t t = vqtbl4q_u8(lo, vld1q_u8(PI_TBL[y]));
+    b[y] = vreinterpretq_u16_u8(vqtbx1q_u8(t, hi, vld1q_u8(PI_TBX[y])));
+  }
+
+  for (size_t y = 0; y < 5; y++) {
+    row[y] = b[y] ^ vbicq_u16(lookup(b[y], ROW_P2), lookup(b[y], ROW_P1));
+  }
+
+  row[0] ^= vsetq_lane_u16(rc, vdupq_n_u16(0), 0);
+}
+
+// Applies rounds BEG + I, on single state held in row vectors, for each I in
+// index sequence, as straight-line code
+template<const size_t BEG, size_t... I>
+static inline void
+rounds_neon(uint16x8_t* const row, std::index_sequence<I...>)
+{
+  (round_neon(row, RC[BEG + I]), ...);
+}
+
+// keccak-p[400] permutation, same as `permute_ref`, but using NEON, where each
+// row of state is held in a vector ( see `round_neon` )
+template<const size_t ROUNDS, const size_t UNROLL = ISAP_PERM_UNROLL>
+static inline void
+permute_neon(uint16_t* const state)
+  requires(ROUNDS <= MAX_ROUNDS)
+{
+  constexpr size_t beg = MAX_ROUNDS - ROUNDS;
+
+  isap_instr::permute<isap_instr::perm_t::KECCAK>(ROUNDS);
+
+  // rows are loaded as 4 + 1 lanes, so that nothing past state is read
+  uint16x8_t row[5];
+  for (size_t y = 0; y < 5; y++) {
+    const uint16x4_t l = vld1_u16(state + 5 * y);
+    const uint16x4_t h = vset_lane_u16(state[5 * y + 4], vdup_n_u16(0), 0);
+    row[y] = vcombine_u16(l, h);
+  }
+
+  if constexpr (UNROLL == 0 || UNROLL >= ROUNDS) {
+    rounds_neon<beg>(row, std::make_index_sequence<ROUNDS>{});
+  } else {
+    constexpr size_t rem = ROUNDS % UNROLL;
+
+    // leftover rounds first, so that loop runs over whole blocks
+    if constexpr (rem > 0) {
+      rounds_neon<beg>(row, std::make_index_sequence<rem>{});
+    }
+
+    for (size_t i = beg + rem; i < MAX_ROUNDS; i += UNROLL) {
+#if defined __clang__
+#pragma clang loop unroll(full)
+#elif defined __GNUG__
+#pragma GCC unroll 20
+#endif
+      for (size_t j = 0; j < UNROLL; j++) {
+        round_neon(row, RC[i + j]);
+      }
+    }
+  }
+
+  for (size_t y = 0; y < 5; y++) {
+    vst1_u16(state + 5 * y, vget_low_u16(row[y]));
+    state[5 * y + 4] = vgetq_lane_u16(row[y], 4);
+  }
+}
+
+// ρ offset of i -th lane of state
+static inline constexpr size_t
+rho_of(const size_t i)
+{
+  return i == 0 ? 0 : ROT[i - 1];
+}
+
+// Applies ρ & π, on eight states at once, writing i -th lane of output, for
+// each I in index sequence
+template<size_t... I>
+static inline void
+rho_pi_x8(const uint16x8_t* const __restrict in,
+          uint16x8_t* const __restrict out,
+          std::index_sequence<I...>)
+{
+  ((out[I] = rotl_x8<rho_of(PERM[I])>(in[PERM[I]])), ...);
+}
+
+// keccak-p[400] round function, on eight states at once, where i -th lane of
+// each state is held in i -th vector, so that each step mapping is same as in
+// `round`, applied on vectors
+static inline void
+round_x8(uint16x8_t* const state, const uint16_t rc)
+{
+  uint16x8_t c[5];
+  for (size_t x = 0; x < 5; x++) {
+    c[x] = state[x] ^ state[x + 5] ^ state[x + 10] ^ state[x + 15] ^
+           state[x + 20];
+  }
+
+  for (size_t x = 0; x < 5; x++) {
+    const uint16x8_t d = c[(x + 4) % 5] ^ rotl_x8<1>(c[(x + 1) % 5]);
+    for (size_t y = 0; y < 25; y += 5) {
+      state[y + x] ^= d;
+    }
+  }
+
+  uint16x8_t tmp[25];
+  rho_pi_x8(state, tmp, std::make_index_sequence<25>{});
+
+  for (size_t y = 0; y < 25; y += 5) {
+    for (size_t x = 0; x < 5; x++) {
+      const uint16x8_t x0 = tmp[y + (x + 1) % 5];
+      const uint16x8_t x1 = tmp[y + (x + 2) % 5];
+      state[y + x] = tmp[y + x] ^ vbicq_u16(x1, x0);
+    }
+  }
+
+  state[0] ^= vdupq_n_u16(rc);
+}
+
+// Applies rounds BEG + I, on eight states at once, for each I in index
+// sequence, as straight-line code
+template<const size_t BEG, size_t... I>
+static inline void
+rounds_x8(uint16x8_t* const state, std::index_sequence<I...>)
+{
+  (round_x8(state, RC[BEG + I]), ...);
+}
+
+// keccak-p[400] permutation, same as `permute_ref`, but on eight states at
+// once, using NEON, where w[i][j] is i -th lane of j -th state
+template<const size_t ROUNDS, const size_t UNROLL = ISAP_PERM_UNROLL>
+static inline void
+permute_x8(uint16_t (*const w)[8])
+  requires(ROUNDS <= MAX_ROUNDS)
+{
+  constexpr size_t beg = MAX_ROUNDS - ROUNDS;
+
+  // counted once per state
+  for (size_t j = 0; j < 8; j++) {
+    isap_instr::permute<isap_instr::perm_t::KECCAK>(ROUNDS);
+  }
+
+  uint16x8_t s[25];
+  for (size_t i = 0; i < 25; i++) {
+    s[i] = vld1q_u16(w[i]);
+  }
+
+  if constexpr (UNROLL == 0 || UNROLL >= ROUNDS) {
+    rounds_x8<beg>(s, std::make_index_sequence<ROUNDS>{});
+  } else {
+    constexpr size_t rem = ROUNDS % UNROLL;
+
+    // leftover rounds first, so that loop runs over whole blocks
+    if constexpr (rem > 0) {
+      rounds_x8<beg>(s, std::make_index_sequence<rem>{});
+    }
+
+    for (size_t i = beg + rem; i < MAX_ROUNDS; i += UNROLL) {
+#if defined __clang__
+#pragma clang loop unroll(full)
+#elif defined __GNUG__
+#pragma GCC unroll 20
+#endif
+      for (size_t j = 0; j < UNROLL; j++) {
+        round_x8(s, RC[i + j]);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < 25; i++) {
+    vst1q_u16(w[i], s[i]);
+  }
+}
+
+#endif
+
+// keccak-p[400] permutation, using backend chosen by `ISAP_NEON` or
+// `ISAP_KECCAK_WIDE`, in that order
+template<const size_t ROUNDS, const size_t UNROLL = ISAP_PERM_UNROLL>
+static inline constexpr void
+permute(uint16_t* const state)
+  requires(ROUNDS <= MAX_ROUNDS)
+{
+#if ISAP_NEON
+  permute_neon<ROUNDS, UNROLL>(state);
+#else
+  if constexpr (ISAP_KECCAK_WIDE) {
+    permute_wide<ROUNDS, UNROLL>(state);
+  } else {
+    permute_ref<ROUNDS, UNROLL>(state);
+  }
+#endif
+}
+
+// Keccak-p[400] permutation state, held by value, same as `ascon::state`.
+// Bytes are converted to/ from lanes using shifts, interpreting each 16 -bit
+// lane in little-endian byte order.
+struct state400
+{
+  uint16_t w[25];
+
+  inline constexpr uint16_t& operator[](const size_t i) { return w[i]; }
+  inline constexpr uint16_t operator[](const size_t i) const { return w[i]; }
+
+  // Byte at given byte offset of state
+  inline constexpr uint8_t byte(const size_t off) const
+  {
+    return static_cast<uint8_t>(w[off >> 1] >> ((off & 1) << 3));
+  }
+
+  // Overwrites N -bytes of state, starting at given byte offset, where both
+  // offset & N must be multiple of 2
+  inline constexpr void set_bytes(const uint8_t* const bytes,
+                                  const size_t off,
+                                  const size_t len)
+  {
+    for (size_t i = 0; i < len; i += 2) {
+      w[(off + i) >> 1] = load(bytes + i);
+    }
+  }
+
+  // XORs a single byte into state, at given byte offset
+  inline constexpr void xor_byte(const size_t off, const uint8_t b)
+  {
+    w[off >> 1] ^= static_cast<uint16_t>(b) << ((off & 1) << 3);
+  }
+
+  // Given 2 -bytes, this routine returns them as little-endian lane
+  static inline constexpr uint16_t load(const uint8_t* const bytes)
+  {
+    const uint16_t lo = bytes[0];
+    const uint16_t hi = bytes[1];
+
+    return static_cast<uint16_t>(lo | (hi << 8));
+  }
+
+  // Given a little-endian lane, this routine writes it as 2 -bytes
+  static inline constexpr void store(const uint16_t v, uint8_t* const bytes)
+  {
+    bytes[0] = static_cast<uint8_t>(v);
+    bytes[1] = static_cast<uint8_t>(v >> 8);
+  }
+
+  // XORs N ( <= 50 ) -bytes into leading bytes of state
+  inline constexpr void xor_bytes(const uint8_t* const bytes, const size_t len)
+  {
+    for (size_t i = 0; i < (len >> 1); i++) {
+      w[i] ^= load(bytes + (i << 1));
+    }
+    if (len & 1) {
+      xor_byte(len - 1, bytes[len - 1]);
+    }
+  }
+
+  // Writes N ( <= 50 ) leading bytes of state
+  inline constexpr void extract_bytes(uint8_t* const bytes,
+                                      const size_t len) const
+  {
+    for (size_t i = 0; i < (len >> 1); i++) {
+      store(w[i], bytes + (i << 1));
+    }
+    if (len & 1) {
+      bytes[len - 1] = byte(len - 1);
+    }
+  }
+
+  // Writes N ( <= 50 ) leading bytes of state, XOR-ed with N -bytes input,
+  // where input & output may be same buffer
+  inline constexpr void xor_extract(const uint8_t* const in,
+                                    uint8_t* const out,
+                                    const size_t len) const
+  {
+    for (size_t i = 0; i < (len >> 1); i++) {
+      store(load(in + (i << 1)) ^ w[i], out + (i << 1));
+    }
+    if (len & 1) {
+      out[len - 1] = in[len - 1] ^ byte(len - 1);
+    }
+  }
+
+  // Applies ROUNDS -many rounds of Keccak-p[400] permutation on state
+  template<const size_t ROUNDS, const size_t UNROLL = ISAP_PERM_UNROLL>
+  inline constexpr void permute()
+    requires(ROUNDS <= MAX_ROUNDS)
+  {
+    keccak::permute<ROUNDS, UNROLL>(w);
+  }
+};
+
+// Eight Keccak-p[400] permutation states, lane-sliced i.e. w[i][j] is i -th
+// lane of j -th state, so that all of them can be permuted at once, using
+// multi-state backend, when `ISAP_NEON` is set. Otherwise, each state is
+// permuted on its own.
+struct state400_x8
+{
+  static constexpr size_t LANES = 8;
+
+  alignas(16) uint16_t w[25][LANES];
+
+  // Writes state into j -th lane
+  inline constexpr void insert(const size_t j, const state400& s)
+  {
+    for (size_t i = 0; i < 25; i++) {
+      w[i][j] = s[i];
+    }
+  }
+
+  // Reads state out of j -th lane
+  inline constexpr state400 extract(const size_t j) const
+  {
+    state400 s;
+    for (size_t i = 0; i < 25; i++) {
+      s[i] = w[i][j];
+    }
+    return s;
+  }
+
+  // Applies ROUNDS -many rounds of Keccak-p[400] permutation on all states
+  template<const size_t ROUNDS, const size_t UNROLL = ISAP_PERM_UNROLL>
+  inline void permute()
+    requires(ROUNDS <= MAX_ROUNDS)
+  {
+#if ISAP_NEON
+    keccak::permute_x8<ROUNDS, UNROLL>(w);
+#else
+    for (size_t j = 0; j < LANES; j++) {
+      state400 s = extract(j);
+      s.permute<ROUNDS, UNROLL>();
+      insert(j, s);
+    }
+#endif
+  }
+};
+
 }
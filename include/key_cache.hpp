@@ -0,0 +1,420 @@
+#pragma once
+#include "common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Concurrent, bounded cache of precomputed key contexts ( see
+// `isap_common::key_context_t` ), keyed by 64 -bit tenant identifier, for
+// services encrypting under many secret keys, picking one per request.
+//
+// Cache is organized as a set-associative table, where each tenant maps to a
+// set of `WAYS` -many entries. Each entry occupies its own cache line(s), so
+// that threads touching different entries never false share. Lookups are
+// lock-free, as each entry is guarded by a sequence lock, which readers only
+// ever read. Inserting a missing tenant takes mutex of the shard owning its
+// set, picking a victim out of that set, using CLOCK ( second chance ) policy.
+// Memory footprint is fixed at construction.
+namespace isap_key_cache {
+
+// # -of entries in each set
+constexpr size_t WAYS = 8;
+
+// # -of stripes, metrics are spread over, so that threads rarely update same
+// counters
+constexpr size_t STRIPES = 64;
+
+// # -of buckets in lookup latency histogram, where bucket i holds # -of lookups
+// which took [2^(i-1), 2^i) nanoseconds
+constexpr size_t LAT_BUCKETS = 32;
+
+// Latency of only one out of these many lookups ( per thread ) is measured,
+// keeping cost of reading clock off the common path
+constexpr uint64_t LAT_SAMPLE = 16;
+
+// Point-in-time copy of cache metrics, aggregated over all stripes
+struct stats_t
+{
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+  uint64_t latency[LAT_BUCKETS]{}; // sampled, log2 ns histogram of lookups
+
+  inline double hit_rate() const
+  {
+    const uint64_t tot = hits + misses;
+    return tot == 0 ? 0. : static_cast<double>(hits) / tot;
+  }
+
+  // Upper bound ( in nanoseconds ) of given quantile ( in [0, 1] ) of lookup
+  // latency, as recorded in histogram
+  inline uint64_t latency_quantile(const double q) const
+  {
+    uint64_t tot = 0;
+    for (size_t i = 0; i < LAT_BUCKETS; i++) {
+      tot += latency[i];
+    }
+
+    const uint64_t lim = static_cast<uint64_t>(q * static_cast<double>(tot));
+    uint64_t acc = 0;
+    for (size_t i = 0; i < LAT_BUCKETS; i++) {
+      acc += latency[i];
+      if (acc > lim) {
+        return uint64_t{ 1 } << i;
+      }
+    }
+    return uint64_t{ 1 } << (LAT_BUCKETS - 1);
+  }
+};
+
+// Stripe of metrics, updated using relaxed atomic operations
+struct alignas(64) stripe_t
+{
+  std::atomic<uint64_t> hits{ 0 };
+  std::atomic<uint64_t> misses{ 0 };
+  std::atomic<uint64_t> evictions{ 0 };
+  std::atomic<uint64_t> latency[LAT_BUCKETS]{};
+};
+
+// Index of metrics stripe, updated by calling thread
+static inline size_t
+stripe_index()
+{
+  static std::atomic<size_t> next{ 0 };
+  thread_local const size_t idx =
+    next.fetch_add(1, std::memory_order_relaxed) % STRIPES;
+  return idx;
+}
+
+// Mixes bits of 64 -bit tenant identifier, so that consecutive identifiers are
+// spread over sets ( finalizer of splitmix64 )
+static inline constexpr uint64_t
+mix(uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ul;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebul;
+  x ^= x >> 31;
+  return x;
+}
+
+// Zeroes N -bytes, holding secret key or key context, through volatile pointer,
+// so that it isn't elided as a dead store, when buffer goes out of scope
+static inline void
+wipe(void* const buf, const size_t len)
+{
+  volatile uint8_t* const bytes = static_cast<volatile uint8_t*>(buf);
+  for (size_t i = 0; i < len; i++) {
+    bytes[i] = 0;
+  }
+}
+
+// Bounded cache of key contexts of ISAP instance ( chosen by template
+// parameters )
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+struct cache_t
+{
+  using ctx_t = isap_common::key_context_t<p, s_b, s_k, s_e, s_h>;
+
+  static_assert(std::is_trivially_copyable_v<ctx_t>);
+
+  // # -of 64 -bit words of entry payload i.e. tenant identifier, liveness flag
+  // & key context
+  static constexpr size_t WORDS = 2 + (sizeof(ctx_t) + 7) / 8;
+
+  // Cache entry, guarded by sequence lock, whose value is odd while entry is
+  // being written. Payload is kept as atomic words, so that readers racing with
+  // a writer never have a data race; they simply retry.
+  struct alignas(64) entry_t
+  {
+    std::atomic<uint64_t> seq{ 0 };
+    std::atomic<uint8_t> ref{ 0 }; // CLOCK reference bit
+    std::atomic<uint64_t> words[WORDS]{};
+  };
+
+  // Shard of cache, owning every `shards` -th set, whose mutex serializes
+  // writers of those sets. Generation is bumped by each invalidation of a
+  // tenant of this shard, so that a miss, which loaded secret key before an
+  // invalidation, doesn't insert now stale key context after it.
+  struct alignas(64) shard_t
+  {
+    std::mutex lock;
+    std::atomic<uint64_t> gen{ 0 };
+  };
+
+  std::unique_ptr<entry_t[]> entries;
+  std::unique_ptr<uint8_t[]> hands; // CLOCK hand of each set
+  std::unique_ptr<shard_t[]> shard_locks;
+  std::unique_ptr<stripe_t[]> stripes;
+  size_t sets = 0;
+  size_t shards = 0;
+
+  // Given maximum # -of cached key contexts & # -of shards, this routine
+  // allocates cache. Capacity is rounded up, so that # -of sets is a power of
+  // 2.
+  explicit cache_t(const size_t capacity, const size_t nshards = 64)
+  {
+    const size_t want = std::max<size_t>((capacity + WAYS - 1) / WAYS, 1);
+
+    sets = std::bit_ceil(want);
+    shards = std::clamp<size_t>(nshards, 1, sets);
+
+    entries = std::make_unique<entry_t[]>(sets * WAYS);
+    hands = std::make_unique<uint8_t[]>(sets);
+    shard_locks = std::make_unique<shard_t[]>(shards);
+    stripes = std::make_unique<stripe_t[]>(STRIPES);
+  }
+
+  cache_t(const cache_t&) = delete;
+  cache_t& operator=(const cache_t&) = delete;
+
+  // Maximum # -of cached key contexts
+  inline size_t capacity() const { return sets * WAYS; }
+
+  // Given tenant identifier, this routine returns its key context, copied into
+  // `ctx`. On miss, `load(tenant, key)` is invoked for fetching 16 -bytes
+  // secret key of tenant, which must return boolean truth value only if tenant
+  // is known, while derived key context is inserted into cache, possibly
+  // evicting another one. Returns boolean truth value only if key context is
+  // available.
+  //
+  // Note, concurrent misses of same tenant may each invoke `load`. A miss,
+  // racing with `invalidate` of a tenant of same shard, still returns key
+  // context it derived, but doesn't insert it.
+  template<typename F>
+  inline bool get(const uint64_t tenant, ctx_t& ctx, F&& load)
+  {
+    thread_local uint64_t calls = 0;
+
+    if ((calls++ % LAT_SAMPLE) != 0) {
+      return get_(tenant, ctx, load);
+    }
+
+    const auto beg = std::chrono::steady_clock::now();
+    const bool ok = get_(tenant, ctx, load);
+    const auto end = std::chrono::steady_clock::now();
+
+    const auto ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - beg).count();
+    const uint64_t v = static_cast<uint64_t>(ns < 0 ? 0 : ns);
+    const size_t bkt = std::min<size_t>(std::bit_width(v), LAT_BUCKETS - 1);
+
+    stripes[stripe_index()].latency[bkt].fetch_add(1,
+                                                   std::memory_order_relaxed);
+    return ok;
+  }
+
+  // Removes key context of given tenant, if cached ( say, after its secret key
+  // is rotated ). Any miss of a tenant of same shard, which is in progress, is
+  // kept from inserting key context, as it may have loaded old secret key.
+  inline void invalidate(const uint64_t tenant)
+  {
+    const size_t set = set_of(tenant);
+    shard_t& shard = shard_locks[set % shards];
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    shard.gen.fetch_add(1, std::memory_order_release);
+
+    entry_t* const ways = entries.get() + set * WAYS;
+    for (size_t i = 0; i < WAYS; i++) {
+      uint64_t buf[WORDS];
+      if (read(ways[i], buf) && buf[1] == 1 && buf[0] == tenant) {
+        std::memset(buf + 2, 0, sizeof(buf) - 2 * sizeof(buf[0]));
+        buf[1] = 0;
+        write(ways[i], buf);
+      }
+      wipe(buf, sizeof(buf));
+    }
+  }
+
+  // Aggregated metrics, since construction or last reset
+  inline stats_t stats() const
+  {
+    stats_t st;
+    for (size_t i = 0; i < STRIPES; i++) {
+      const stripe_t& s = stripes[i];
+
+      st.hits += s.hits.load(std::memory_order_relaxed);
+      st.misses += s.misses.load(std::memory_order_relaxed);
+      st.evictions += s.evictions.load(std::memory_order_relaxed);
+      for (size_t j = 0; j < LAT_BUCKETS; j++) {
+        st.latency[j] += s.latency[j].load(std::memory_order_relaxed);
+      }
+    }
+    return st;
+  }
+
+  // Resets metrics to zero
+  inline void reset_stats()
+  {
+    for (size_t i = 0; i < STRIPES; i++) {
+      stripe_t& s = stripes[i];
+
+      s.hits.store(0, std::memory_order_relaxed);
+      s.misses.store(0, std::memory_order_relaxed);
+      s.evictions.store(0, std::memory_order_relaxed);
+      for (size_t j = 0; j < LAT_BUCKETS; j++) {
+        s.latency[j].store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Index of set, given tenant maps to
+  inline size_t set_of(const uint64_t tenant) const
+  {
+    return static_cast<size_t>(mix(tenant)) & (sets - 1);
+  }
+
+  // Takes consistent snapshot of entry payload, returning boolean truth value
+  // only if no writer raced with it
+  static inline bool read(const entry_t& e, uint64_t* const buf)
+  {
+    const uint64_t s0 = e.seq.load(std::memory_order_acquire);
+    if ((s0 & 1) == 1) {
+      return false;
+    }
+
+    for (size_t i = 0; i < WORDS; i++) {
+      buf[i] = e.words[i].load(std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return e.seq.load(std::memory_order_relaxed) == s0;
+  }
+
+  // Overwrites entry payload; must be called with shard mutex held
+  static inline void write(entry_t& e, const uint64_t* const buf)
+  {
+    const uint64_t s = e.seq.load(std::memory_order_relaxed);
+
+    e.seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < WORDS; i++) {
+      e.words[i].store(buf[i], std::memory_order_relaxed);
+    }
+
+    e.seq.store(s + 2, std::memory_order_release);
+  }
+
+  // Looks up tenant in given set, without taking any lock, returning boolean
+  // truth value on hit
+  static inline bool probe(entry_t* const ways,
+                           const uint64_t tenant,
+                           ctx_t& ctx)
+  {
+    for (size_t i = 0; i < WAYS; i++) {
+      entry_t& e = ways[i];
+
+      // cheap check first, as most ways don't hold this tenant
+      if (e.words[0].load(std::memory_order_relaxed) != tenant) {
+        continue;
+      }
+
+      uint64_t buf[WORDS];
+      for (size_t att = 0; att < 4; att++) {
+        if (!read(e, buf)) {
+          continue;
+        }
+        if (buf[1] == 1 && buf[0] == tenant) {
+          std::memcpy(&ctx, buf + 2, sizeof(ctx));
+          wipe(buf, sizeof(buf));
+
+          // avoid dirtying cache line, if it's already marked
+          if (e.ref.load(std::memory_order_relaxed) == 0) {
+            e.ref.store(1, std::memory_order_relaxed);
+          }
+          return true;
+        }
+        break;
+      }
+      wipe(buf, sizeof(buf));
+    }
+    return false;
+  }
+
+  template<typename F>
+  inline bool get_(const uint64_t tenant, ctx_t& ctx, F& load)
+  {
+    const size_t set = set_of(tenant);
+    entry_t* const ways = entries.get() + set * WAYS;
+    stripe_t& st = stripes[stripe_index()];
+
+    if (probe(ways, tenant, ctx)) {
+      st.hits.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+
+    st.misses.fetch_add(1, std::memory_order_relaxed);
+
+    // generation, before secret key is loaded, see `invalidate`
+    shard_t& shard = shard_locks[set % shards];
+    const uint64_t gen = shard.gen.load(std::memory_order_acquire);
+
+    // derive key context, before taking shard mutex
+    uint8_t key[isap_common::knt_len];
+    if (!load(tenant, key)) {
+      wipe(key, sizeof(key));
+      return false;
+    }
+
+    ctx = ctx_t{ key };
+    wipe(key, sizeof(key));
+
+    std::lock_guard<std::mutex> guard(shard.lock);
+
+    // tenant of this shard was invalidated, after secret key was loaded
+    if (shard.gen.load(std::memory_order_relaxed) != gen) {
+      return true;
+    }
+
+    // writers of this set are serialized, so entries can't change under us
+    size_t victim = WAYS;
+    for (size_t i = 0; i < WAYS; i++) {
+      const uint64_t live = ways[i].words[1].load(std::memory_order_relaxed);
+      const uint64_t tid = ways[i].words[0].load(std::memory_order_relaxed);
+
+      if (live == 1 && tid == tenant) {
+        return true; // inserted by another thread, in the meantime
+      }
+      if (live == 0 && victim == WAYS) {
+        victim = i;
+      }
+    }
+
+    if (victim == WAYS) {
+      uint8_t& hand = hands[set];
+      while (ways[hand].ref.load(std::memory_order_relaxed) == 1) {
+        ways[hand].ref.store(0, std::memory_order_relaxed);
+        hand = static_cast<uint8_t>((hand + 1) % WAYS);
+      }
+
+      victim = hand;
+      hand = static_cast<uint8_t>((hand + 1) % WAYS);
+      st.evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t buf[WORDS]{};
+    buf[0] = tenant;
+    buf[1] = 1;
+    std::memcpy(buf + 2, &ctx, sizeof(ctx));
+
+    write(ways[victim], buf);
+    wipe(buf, sizeof(buf));
+
+    ways[victim].ref.store(0, std::memory_order_relaxed);
+    return true;
+  }
+};
+
+}
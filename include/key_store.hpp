@@ -0,0 +1,361 @@
+#pragma once
+#include "common.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// Persistent, memory mappable store of precomputed key contexts ( see
+// `isap_common::key_context_t` ), keyed by 64 -bit tenant identifier, so that a
+// restarting service doesn't need to rebuild per-key state of every tenant
+// before serving traffic. Opening a store only maps it read-only & checks its
+// header, so it takes same time, no matter how many keys it holds, while key
+// contexts are used right out of mapping, without any parsing.
+//
+// Store is laid out as
+//
+// header ( 64 -bytes ) || entry_0 || ... || entry_{n-1}
+//
+// where header is
+//
+// magic ( 8 -bytes ) || version ( 4 -bytes ) || variant ( 4 -bytes ) || byte
+// order mark ( 4 -bytes ) || entry length ( 4 -bytes ) || context length ( 4
+// -bytes ) || context layout ( 4 -bytes ) || # -of entries ( 8 -bytes ) ||
+// reserved zero ( 16 -bytes ) || header checksum ( 8 -bytes )
+//
+// and each entry is
+//
+// tenant identifier ( 8 -bytes ) || entry checksum ( 8 -bytes ) || key context
+// || zero padding, up to entry length ( multiple of 8 )
+//
+// All integers ( & key contexts ) are kept in native byte order, while byte
+// order mark lets a host reject a store written by a host of other byte order.
+// Similarly, as key contexts are kept exactly as they're laid out in memory,
+// context layout lets a build reject a store written by a build, which keeps
+// permutation state in another representation ( see `ctx_layout` ). Entries
+// are sorted by tenant identifier, so that they can be binary searched. Entry
+// checksum covers tenant identifier & key context, which is checked on each
+// lookup, while whole store can be checked using `verify_all`.
+//
+// Note, key contexts are as sensitive as secret keys, so store must be
+// protected same way as secret keys are.
+namespace isap_key_store {
+
+// Magic bytes, identifying key context store
+constexpr uint8_t MAGIC[]{ 'I', 'S', 'A', 'P', 'K', 'S', 'T', '1' };
+
+// Version of store layout; bumped to 2, when context layout was recorded in
+// header, so that stores of unknown context layout are rejected
+constexpr uint32_t VERSION = 2;
+
+// Byte order mark, as written by host
+constexpr uint32_t BOM = 0x01020304;
+
+// Byte length of header
+constexpr size_t HDR_LEN = 64;
+
+// Identifies in-memory representation of key contexts of given permutation,
+// as chosen by permutation backend at compile-time i.e. Ascon-p state kept as
+// 64 -bit words => 0, bit-interleaved Ascon-p state ( see `ISAP_ASCON_BI` ) =>
+// 1, while Keccak-p[400] state is always kept as 16 -bit lanes => 0. Other
+// backends ( say, assembly or NEON ) don't change representation.
+template<const isap_common::perm_t p>
+inline static constexpr uint32_t
+ctx_layout()
+{
+  if constexpr (p == isap_common::perm_t::ASCON) {
+    return ISAP_ASCON_BI ? 1 : 0;
+  } else {
+    return 0;
+  }
+}
+
+// Header of key context store, laid out exactly as it's kept on disk
+struct header_t
+{
+  uint8_t magic[8];
+  uint32_t version;
+  uint32_t variant; // see `isap_common::variant_id`
+  uint32_t bom;
+  uint32_t entry_len;
+  uint32_t ctx_len;
+  uint32_t layout; // see `ctx_layout`
+  uint64_t count;
+  uint64_t reserved1[2];
+  uint64_t checksum; // over all preceding bytes of header
+};
+
+static_assert(sizeof(header_t) == HDR_LEN);
+
+// Computes 64 -bit checksum of N ( multiple of 8 ) -bytes, for detecting
+// accidental corruption ( not tampering ) of store, mixing each 64 -bit word
+// using finalizer of splitmix64
+static inline uint64_t
+checksum(const uint8_t* const bytes, const size_t len, uint64_t h = 0)
+{
+  for (size_t off = 0; off < len; off += 8) {
+    uint64_t w;
+    std::memcpy(&w, bytes + off, sizeof(w));
+
+    h ^= w + 0x9e3779b97f4a7c15ul;
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ul;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebul;
+    h ^= h >> 31;
+  }
+  return h;
+}
+
+// Read-only, memory mapped store of key contexts of ISAP instance ( chosen by
+// template parameters )
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+struct store_t
+{
+  using ctx_t = isap_common::key_context_t<p, s_b, s_k, s_e, s_h>;
+
+  static_assert(std::is_trivially_copyable_v<ctx_t>);
+
+  // Byte length of each entry
+  static constexpr size_t ENTRY_LEN = (16 + sizeof(ctx_t) + 7) / 8 * 8;
+
+  const uint8_t* mem = nullptr;
+  size_t len = 0;
+  uint64_t cnt = 0;
+
+  store_t() = default;
+  store_t(const store_t&) = delete;
+  store_t& operator=(const store_t&) = delete;
+
+  ~store_t() { close(); }
+
+  // Given N tenant identifiers & N secret keys ( 16 -bytes each, concatenated
+  // ), this routine precomputes their key contexts, writing store to given
+  // path. Store is first written to a uniquely named, owner-only temporary
+  // file, which is atomically renamed, so that readers never observe a
+  // partially written store. Returned boolean flag holds truth value only when
+  // tenant identifiers are distinct & all writes succeed.
+  static inline bool write(const char* const path,
+                           const uint64_t* const tenants,
+                           const uint8_t* const keys,
+                           const size_t n)
+  {
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; i++) {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](const size_t a, const size_t b) {
+      return tenants[a] < tenants[b];
+    });
+    for (size_t i = 1; i < n; i++) {
+      if (tenants[order[i - 1]] == tenants[order[i]]) {
+        return false;
+      }
+    }
+
+    std::vector<uint8_t> buf(HDR_LEN + n * ENTRY_LEN, 0);
+
+    header_t hdr{};
+    std::memcpy(hdr.magic, MAGIC, sizeof(MAGIC));
+    hdr.version = VERSION;
+    hdr.variant = isap_common::variant_id<p, s_b, s_k, s_e, s_h>();
+    hdr.bom = BOM;
+    hdr.entry_len = ENTRY_LEN;
+    hdr.ctx_len = sizeof(ctx_t);
+    hdr.layout = ctx_layout<p>();
+    hdr.count = n;
+    hdr.checksum = checksum(reinterpret_cast<const uint8_t*>(&hdr),
+                            offsetof(header_t, checksum));
+    std::memcpy(buf.data(), &hdr, sizeof(hdr));
+
+    for (size_t i = 0; i < n; i++) {
+      uint8_t* const ent = buf.data() + HDR_LEN + i * ENTRY_LEN;
+      const uint64_t tenant = tenants[order[i]];
+      const ctx_t ctx{ keys + order[i] * isap_common::knt_len };
+
+      std::memcpy(ent, &tenant, 8);
+      std::memcpy(ent + 16, &ctx, sizeof(ctx));
+
+      const uint64_t sum = entry_checksum(ent);
+      std::memcpy(ent + 8, &sum, 8);
+    }
+
+    // uniquely named, so that concurrent writers don't clobber each other,
+    // while `mkstemp` creates it exclusively, readable only by owner ( 0600 ),
+    // so that key contexts are never exposed, no matter what umask is
+    std::string tmp = std::string(path) + ".XXXXXX";
+
+    const int tfd = mkstemp(tmp.data());
+    if (tfd < 0) {
+      return false;
+    }
+
+    FILE* const fd = fdopen(tfd, "wb");
+    if (fd == nullptr) {
+      ::close(tfd);
+      std::remove(tmp.c_str());
+      return false;
+    }
+
+    bool ok = std::fwrite(buf.data(), 1, buf.size(), fd) == buf.size();
+    ok &= std::fflush(fd) == 0;
+    ok &= fsync(fileno(fd)) == 0;
+    ok &= std::fclose(fd) == 0;
+
+    if (!ok || std::rename(tmp.c_str(), path) != 0) {
+      std::remove(tmp.c_str());
+      return false;
+    }
+    return true;
+  }
+
+  // Maps store at given path read-only, returning boolean truth value only
+  // when header is well-formed & intact, store was written by a host of same
+  // byte order, by a build of same context layout, for same ISAP instance &
+  // file length matches # -of entries.
+  // Entries are not touched, so it takes constant time.
+  inline bool open(const char* const path)
+  {
+    close();
+
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || static_cast<size_t>(sb.st_size) < HDR_LEN) {
+      ::close(fd);
+      return false;
+    }
+
+    const size_t flen = static_cast<size_t>(sb.st_size);
+    void* const m = mmap(nullptr, flen, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (m == MAP_FAILED) {
+      return false;
+    }
+
+    mem = static_cast<const uint8_t*>(m);
+    len = flen;
+
+    header_t hdr;
+    std::memcpy(&hdr, mem, sizeof(hdr));
+
+    bool ok = std::memcmp(hdr.magic, MAGIC, sizeof(MAGIC)) == 0;
+    ok &= hdr.checksum == checksum(mem, offsetof(header_t, checksum));
+    ok &= hdr.version == VERSION;
+    ok &= hdr.bom == BOM;
+    ok &= hdr.variant == isap_common::variant_id<p, s_b, s_k, s_e, s_h>();
+    ok &= hdr.entry_len == ENTRY_LEN && hdr.ctx_len == sizeof(ctx_t);
+    ok &= hdr.layout == ctx_layout<p>();
+    ok &= hdr.reserved1[0] == 0 && hdr.reserved1[1] == 0;
+    ok &= hdr.count <= (flen - HDR_LEN) / ENTRY_LEN &&
+          flen == HDR_LEN + hdr.count * ENTRY_LEN;
+
+    if (!ok) {
+      close();
+      return false;
+    }
+
+    cnt = hdr.count;
+    return true;
+  }
+
+  // Unmaps store, if mapped
+  inline void close()
+  {
+    if (mem != nullptr) {
+      munmap(const_cast<uint8_t*>(mem), len);
+    }
+    mem = nullptr;
+    len = 0;
+    cnt = 0;
+  }
+
+  // # -of key contexts in store
+  inline size_t size() const { return static_cast<size_t>(cnt); }
+
+  // Given tenant identifier, this routine binary searches store, returning
+  // pointer to its key context, living inside mapping ( so valid until store
+  // is closed ), only if tenant is found & its entry is intact, otherwise
+  // returns nullptr
+  inline const ctx_t* find(const uint64_t tenant) const
+  {
+    size_t lo = 0;
+    size_t hi = static_cast<size_t>(cnt);
+
+    while (lo < hi) {
+      const size_t mid = lo + ((hi - lo) >> 1);
+      const uint8_t* const ent = entry(mid);
+
+      uint64_t tid;
+      std::memcpy(&tid, ent, sizeof(tid));
+
+      if (tid < tenant) {
+        lo = mid + 1;
+      } else if (tid > tenant) {
+        hi = mid;
+      } else {
+        uint64_t sum;
+        std::memcpy(&sum, ent + 8, sizeof(sum));
+
+        if (sum != entry_checksum(ent)) {
+          return nullptr;
+        }
+        return reinterpret_cast<const ctx_t*>(ent + 16);
+      }
+    }
+    return nullptr;
+  }
+
+  // Checks every entry of store, returning boolean truth value only if all
+  // entries are intact & sorted by strictly increasing tenant identifier. It
+  // touches whole store, so it's meant to be run off the startup path ( say,
+  // in background ), if at all.
+  inline bool verify_all() const
+  {
+    uint64_t prev = 0;
+
+    for (size_t i = 0; i < cnt; i++) {
+      const uint8_t* const ent = entry(i);
+
+      uint64_t tid, sum;
+      std::memcpy(&tid, ent, sizeof(tid));
+      std::memcpy(&sum, ent + 8, sizeof(sum));
+
+      if (sum != entry_checksum(ent) || (i > 0 && tid <= prev)) {
+        return false;
+      }
+      prev = tid;
+    }
+    return true;
+  }
+
+  // Pointer to i -th entry
+  inline const uint8_t* entry(const size_t i) const
+  {
+    return mem + HDR_LEN + i * ENTRY_LEN;
+  }
+
+  // Checksum of entry, covering tenant identifier & key context, along with
+  // zero padding
+  static inline uint64_t entry_checksum(const uint8_t* const ent)
+  {
+    const uint64_t h = checksum(ent, 8);
+    return checksum(ent + 16, ENTRY_LEN - 16, h);
+  }
+};
+
+}
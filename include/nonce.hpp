@@ -0,0 +1,210 @@
+#pragma once
+#include "aead.hpp"
+#include "common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <random>
+
+// Lock-free nonce sequencer, handing out unique 16 -bytes nonces to many
+// threads, encrypting under same secret key.
+//
+// Nonce is laid out as
+//
+// prefix ( 8 -bytes ) || counter ( 8 -bytes, big-endian )
+//
+// where prefix is fixed for lifetime of sequencer, while counter space is
+// carved out into disjoint blocks, by atomically bumping a shared base. Each
+// thread reserves a whole block at once & then hands out nonces from it without
+// touching any shared state, so that cost of contended atomic operation is
+// amortized over block length -many encryptions.
+//
+// Note, nonces are unique only within a sequencer. If same secret key is used
+// by more than one sequencer ( say, across process restarts ), they must use
+// distinct prefixes or disjoint counter ranges.
+namespace isap_nonce {
+
+// Default # -of nonces reserved by a thread at once
+constexpr uint64_t DEFAULT_BLOCK = 1ul << 16;
+
+// Returns a process-wide unique, non-zero identifier, used for telling apart
+// sequencers in thread-local caches, even if one is allocated at the address of
+// another, already destroyed one
+static inline uint64_t
+next_id()
+{
+  static std::atomic<uint64_t> id{ 0 };
+  return id.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+// Shared source of nonces, for a single secret key
+struct sequencer_t
+{
+  uint8_t prefix[8];
+  const uint64_t block; // # -of nonces reserved at once
+  const uint64_t id;    // see `next_id`
+
+  // next unreserved counter value, kept on its own cache line, as it's the only
+  // shared, mutable state
+  alignas(64) std::atomic<uint64_t> base;
+
+  // Given 8 -bytes prefix, starting counter value & block length ( > 0 ), this
+  // routine initializes sequencer
+  sequencer_t(const uint8_t* const pfx,
+              const uint64_t start = 0,
+              const uint64_t blk = DEFAULT_BLOCK)
+    : block(std::max<uint64_t>(blk, 1))
+    , id(next_id())
+    , base(start)
+  {
+    std::memcpy(prefix, pfx, sizeof(prefix));
+  }
+
+  // Initializes sequencer with random 8 -bytes prefix, drawn from
+  // `std::random_device`, starting counter at 0
+  explicit sequencer_t(const uint64_t blk = DEFAULT_BLOCK)
+    : block(std::max<uint64_t>(blk, 1))
+    , id(next_id())
+    , base(0)
+  {
+    std::random_device rd;
+    for (size_t i = 0; i < sizeof(prefix); i += 4) {
+      const uint32_t w = rd();
+      std::memcpy(prefix + i, &w, 4);
+    }
+  }
+
+  sequencer_t(const sequencer_t&) = delete;
+  sequencer_t& operator=(const sequencer_t&) = delete;
+
+  // Reserves next block of counter values i.e. [beg, end), returning boolean
+  // truth value only if counter space is not yet exhausted. Last block may be
+  // shorter than block length.
+  inline bool reserve(uint64_t& beg, uint64_t& end)
+  {
+    uint64_t cur = base.load(std::memory_order_relaxed);
+    uint64_t nxt;
+
+    do {
+      if (cur == UINT64_MAX) {
+        return false;
+      }
+      nxt = cur + std::min(block, UINT64_MAX - cur);
+    } while (!base.compare_exchange_weak(
+      cur, nxt, std::memory_order_relaxed, std::memory_order_relaxed));
+
+    beg = cur;
+    end = nxt;
+    return true;
+  }
+
+  // Given counter value, this routine writes respective 16 -bytes nonce
+  inline void compose(const uint64_t ctr, uint8_t* const nonce) const
+  {
+    std::memcpy(nonce, prefix, sizeof(prefix));
+    for (size_t i = 0; i < 8; i++) {
+      nonce[8 + i] = static_cast<uint8_t>(ctr >> ((7 - i) << 3));
+    }
+  }
+};
+
+// Per-thread view of a sequencer, handing out nonces from currently reserved
+// block, while reserving next block only when current one runs out. Must not be
+// shared among threads.
+struct stream_t
+{
+  sequencer_t* seq = nullptr;
+  uint64_t next = 0;
+  uint64_t end = 0;
+
+  stream_t() = default;
+  explicit stream_t(sequencer_t& s)
+    : seq(&s)
+  {}
+
+  // Writes next unique 16 -bytes nonce, returning boolean truth value only if
+  // counter space of sequencer is not yet exhausted
+  inline bool next_nonce(uint8_t* const nonce)
+  {
+    if (next == end) [[unlikely]] {
+      if (!seq->reserve(next, end)) {
+        return false;
+      }
+    }
+
+    seq->compose(next++, nonce);
+    return true;
+  }
+};
+
+// Returns stream of calling thread, for given sequencer. Each thread caches
+// stream of only one sequencer, so switching between sequencers on same thread
+// abandons rest of reserved block ( nonces are still unique, only some counter
+// values are never used ).
+static inline stream_t&
+thread_stream(sequencer_t& seq)
+{
+  thread_local uint64_t id = 0;
+  thread_local stream_t st;
+
+  if (id != seq.id) [[unlikely]] {
+    id = seq.id;
+    st = stream_t{ seq };
+  }
+  return st;
+}
+
+// Given 16 -bytes secret key, N ( >=0 ) -bytes associated data & M ( >=0 )
+// -bytes plain text, this routine takes next nonce out of stream & computes M
+// -bytes cipher text along with 16 -bytes authentication tag, using ISAP
+// instance chosen by template parameters. Used nonce is written to `nonce`, as
+// it must be sent along with cipher text. Returned boolean flag holds truth
+// value only if a nonce was available, otherwise nothing is encrypted.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static inline bool
+encrypt_auto_nonce(stream_t& st,
+                   const uint8_t* const __restrict key,
+                   const uint8_t* const __restrict data,
+                   const size_t dlen,
+                   const uint8_t* const msg,
+                   uint8_t* const enc,
+                   const size_t mlen,
+                   uint8_t* const __restrict tag,
+                   uint8_t* const __restrict nonce)
+{
+  if (!st.next_nonce(nonce)) {
+    return false;
+  }
+
+  isap::encrypt<p, s_b, s_k, s_e, s_h>(
+    key, nonce, data, dlen, msg, enc, mlen, tag);
+  return true;
+}
+
+// Same as above, but takes nonce out of calling thread's stream of given
+// sequencer ( see `thread_stream` )
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static inline bool
+encrypt_auto_nonce(sequencer_t& seq,
+                   const uint8_t* const __restrict key,
+                   const uint8_t* const __restrict data,
+                   const size_t dlen,
+                   const uint8_t* const msg,
+                   uint8_t* const enc,
+                   const size_t mlen,
+                   uint8_t* const __restrict tag,
+                   uint8_t* const __restrict nonce)
+{
+  return encrypt_auto_nonce<p, s_b, s_k, s_e, s_h>(
+    thread_stream(seq), key, data, dlen, msg, enc, mlen, tag, nonce);
+}
+
+}
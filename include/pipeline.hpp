@@ -0,0 +1,364 @@
+#pragma once
+#include "aead.hpp"
+#include "chunked.hpp"
+#include "common.hpp"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Double-buffered ( well, N -buffered ) I/O pipeline for bulk encryption,
+// overlapping reads from input file descriptor, ISAP encryption & writes to
+// output file descriptor, each running on its own thread, while chunks flow
+// through a ring of preallocated, page aligned buffers. Output is same as
+// chunked encryption format ( see include/chunked.hpp ), so it can be decrypted
+// using `isap_chunked::decrypt` or `isap-file decrypt`.
+//
+// As input is consumed as a stream, file descriptors can be pipes/ sockets too.
+namespace isap_pipeline {
+
+// Statistics of a single pipeline stage
+struct stage_stats_t
+{
+  uint64_t bytes = 0;   // bytes processed by stage
+  uint64_t busy_ns = 0; // time spent doing useful work i.e. I/O or crypto
+  uint64_t wait_ns = 0; // time spent waiting for other stages
+
+  // Throughput of stage ( in bytes/ second ), if it'd never have to wait
+  inline double throughput() const
+  {
+    return busy_ns == 0 ? 0. : static_cast<double>(bytes) * 1e9 / busy_ns;
+  }
+
+  // Fraction of wall clock time, stage was busy. Bottleneck stage is the one
+  // which is busy almost all the time.
+  inline double utilization(const uint64_t wall_ns) const
+  {
+    return wall_ns == 0 ? 0. : static_cast<double>(busy_ns) / wall_ns;
+  }
+};
+
+// Statistics of all stages of pipeline
+struct stats_t
+{
+  stage_stats_t read;
+  stage_stats_t crypto;
+  stage_stats_t write;
+  uint64_t wall_ns = 0;
+};
+
+// Monotonic clock reading, in nanoseconds
+static inline uint64_t
+now_ns()
+{
+  using namespace std::chrono;
+
+  const auto t = steady_clock::now().time_since_epoch();
+  return static_cast<uint64_t>(duration_cast<nanoseconds>(t).count());
+}
+
+// Buffer of ring, holding a single chunk as it flows through pipeline
+struct slot_t
+{
+  uint8_t* txt; // plain text chunk
+  uint8_t* enc; // cipher text chunk, followed by authentication tag
+  size_t len;   // byte length of chunk
+  uint64_t idx; // index of chunk
+  bool last;    // is it last chunk ?
+  bool err;     // did read fail or was pipeline aborted ? If so, it's drained
+};
+
+// Bounded FIFO queue of slot indices, connecting two adjacent stages
+struct queue_t
+{
+  std::mutex lock;
+  std::condition_variable cv;
+  std::vector<size_t> ring;
+  size_t head = 0;
+  size_t cnt = 0;
+
+  explicit queue_t(const size_t cap)
+    : ring(cap)
+  {}
+
+  inline void push(const size_t v)
+  {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      ring[(head + cnt) % ring.size()] = v;
+      cnt++;
+    }
+    cv.notify_one();
+  }
+
+  // Pops oldest slot index, blocking until one is available, while accounting
+  // time spent being blocked
+  inline size_t pop(stage_stats_t& st)
+  {
+    const uint64_t beg = now_ns();
+
+    std::unique_lock<std::mutex> guard(lock);
+    cv.wait(guard, [&]() { return cnt > 0; });
+
+    const size_t v = ring[head];
+    head = (head + 1) % ring.size();
+    cnt--;
+
+    st.wait_ns += now_ns() - beg;
+    return v;
+  }
+};
+
+// Reads until N -bytes are read or end of file is reached, returning # -of
+// bytes read or -1 on failure
+static inline ssize_t
+read_full(const int fd, uint8_t* const buf, const size_t len)
+{
+  size_t off = 0;
+  while (off < len) {
+    const ssize_t n = read(fd, buf + off, len - off);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      return -1;
+    }
+    if (n == 0) {
+      break;
+    }
+    off += static_cast<size_t>(n);
+  }
+  return static_cast<ssize_t>(off);
+}
+
+// Writes all N -bytes, returning boolean truth value only on success
+static inline bool
+write_full(const int fd, const uint8_t* const buf, const size_t len)
+{
+  size_t off = 0;
+  while (off < len) {
+    const ssize_t n = write(fd, buf + off, len - off);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    off += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+// Given 16 -bytes secret key, 16 -bytes file nonce & chunk length ( > 0 ), this
+// routine reads plain text from input file descriptor till end of file, writing
+// chunked encryption of it ( using ISAP instance chosen by template parameters
+// ) to output file descriptor, through a pipeline of read, crypto & write
+// stages, connected by a ring of given # -of buffers ( >= 3 ). Returned boolean
+// flag holds truth value only when all reads & writes succeed, while per-stage
+// statistics are written to `st`.
+//
+// Note, crypto stage runs on calling thread. Reader looks one chunk ahead, as
+// last chunk flag is known only after next read hits end of file. As soon as a
+// read or write fails, pipeline is aborted i.e. reader stops reading, ending
+// stream with a last chunk, while crypto stage stops encrypting, so that it
+// terminates, even when input never ends.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static inline bool
+encrypt_fd(const uint8_t* const __restrict key,
+           const uint8_t* const __restrict nonce,
+           const uint32_t clen,
+           const int in_fd,
+           const int out_fd,
+           const size_t nbufs,
+           stats_t& st)
+{
+  using namespace isap_chunked;
+
+  constexpr size_t PAGE = 4096;
+
+  const size_t cnt = std::max<size_t>(nbufs, 3);
+  const size_t tlen = (clen + PAGE - 1) / PAGE * PAGE;
+  const size_t elen = (clen + TAG_LEN + PAGE - 1) / PAGE * PAGE;
+
+  uint8_t* const mem =
+    static_cast<uint8_t*>(std::aligned_alloc(PAGE, cnt * (tlen + elen)));
+  if (mem == nullptr) {
+    return false;
+  }
+
+  std::vector<slot_t> slots(cnt);
+  for (size_t i = 0; i < cnt; i++) {
+    slots[i].txt = mem + i * (tlen + elen);
+    slots[i].enc = slots[i].txt + tlen;
+  }
+
+  queue_t free_q(cnt), crypto_q(cnt), write_q(cnt);
+  for (size_t i = 0; i < cnt; i++) {
+    free_q.push(i);
+  }
+
+  header_t hdr{};
+  hdr.variant = isap_common::variant_id<p, s_b, s_k, s_e, s_h>();
+  hdr.chunk_len = clen;
+  std::memcpy(hdr.nonce, nonce, sizeof(hdr.nonce));
+
+  uint8_t hdr_bytes[HDR_LEN];
+  encode_header(hdr, hdr_bytes);
+
+  st = stats_t{};
+  const uint64_t beg = now_ns();
+
+  // set by reader or writer on failure, so that other stages stop working
+  std::atomic<bool> abort{ false };
+
+  // fills slot with next chunk of input, unless pipeline is aborted, in which
+  // case slot is marked as failed, without reading
+  auto fill = [&](const size_t i, const uint64_t idx) {
+    slot_t& s = slots[i];
+
+    if (abort.load(std::memory_order_acquire)) {
+      s.len = 0;
+      s.idx = idx;
+      s.err = true;
+      return;
+    }
+
+    const uint64_t t0 = now_ns();
+    const ssize_t n = read_full(in_fd, s.txt, clen);
+    st.read.busy_ns += now_ns() - t0;
+
+    s.len = n < 0 ? 0 : static_cast<size_t>(n);
+    s.idx = idx;
+    s.err = n < 0;
+    st.read.bytes += s.len;
+
+    if (s.err) {
+      abort.store(true, std::memory_order_release);
+    }
+  };
+
+  std::thread reader([&]() {
+    size_t cur = free_q.pop(st.read);
+    fill(cur, 0);
+
+    while (true) {
+      slot_t& s = slots[cur];
+
+      if (s.err || s.len < clen) {
+        s.last = true;
+        crypto_q.push(cur);
+        break;
+      }
+
+      // full chunk, it's last only if there's nothing more to read
+      const size_t next = free_q.pop(st.read);
+      fill(next, s.idx + 1);
+
+      if (slots[next].len == 0 && !slots[next].err) {
+        s.last = true;
+        crypto_q.push(cur);
+        free_q.push(next);
+        break;
+      }
+
+      s.last = false;
+      crypto_q.push(cur);
+      cur = next;
+    }
+  });
+
+  bool write_ok = true;
+
+  std::thread writer([&]() {
+    bool ok = true;
+
+    const uint64_t t0 = now_ns();
+    ok &= write_full(out_fd, hdr_bytes, sizeof(hdr_bytes));
+    st.write.busy_ns += now_ns() - t0;
+    st.write.bytes += sizeof(hdr_bytes);
+
+    if (!ok) {
+      abort.store(true, std::memory_order_release);
+    }
+
+    while (true) {
+      const size_t i = write_q.pop(st.write);
+      slot_t& s = slots[i];
+
+      // crypto stage may have skipped chunks, once pipeline got aborted
+      const bool last = s.last;
+      if (s.err || abort.load(std::memory_order_acquire)) {
+        ok = false;
+      }
+
+      if (ok) {
+        const uint64_t t1 = now_ns();
+        ok &= write_full(out_fd, s.enc, s.len + TAG_LEN);
+        st.write.busy_ns += now_ns() - t1;
+        st.write.bytes += s.len + TAG_LEN;
+
+        if (!ok) {
+          abort.store(true, std::memory_order_release);
+        }
+      }
+
+      // on failure, keep draining pipeline, till reader ends stream
+      free_q.push(i);
+
+      if (last) {
+        break;
+      }
+    }
+
+    write_ok = ok;
+  });
+
+  // crypto stage, on calling thread
+  bool ok = true;
+  while (true) {
+    const size_t i = crypto_q.pop(st.crypto);
+    slot_t& s = slots[i];
+
+    ok &= !s.err;
+    if (!s.err && !abort.load(std::memory_order_acquire)) {
+      uint8_t cnonce[isap_common::knt_len];
+      uint8_t ad[AD_LEN];
+
+      chunk_nonce(nonce, s.idx, cnonce);
+      chunk_ad(hdr_bytes, s.idx, s.last, ad);
+
+      const uint64_t t0 = now_ns();
+      isap::encrypt<p, s_b, s_k, s_e, s_h>(
+        key, cnonce, ad, sizeof(ad), s.txt, s.enc, s.len, s.enc + s.len);
+      st.crypto.busy_ns += now_ns() - t0;
+      st.crypto.bytes += s.len;
+    }
+
+    const bool last = s.last;
+    write_q.push(i);
+
+    if (last) {
+      break;
+    }
+  }
+
+  reader.join();
+  writer.join();
+
+  st.wall_ns = now_ns() - beg;
+  std::free(mem);
+
+  return ok && write_ok;
+}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+// Optional USDT ( user-level statically defined tracing ) probes, placed on hot
+// paths of ISAP AEAD, which can be attached to using bpftrace, perf, SystemTap
+// etc.. See `tools/isap_latency.bt` for an example.
+//
+// Define `ISAP_USDT` for enabling probes, which requires <sys/sdt.h> ( shipped
+// with `systemtap-sdt-dev` on Debian/ Ubuntu ). Each enabled probe compiles to
+// a single `nop` instruction, which is patched only when a tracer attaches to
+// it. When not defined, all probes expand to nothing.
+//
+// All probes belong to provider `isap` & following probes are defined
+//
+// Probe | Arguments
+// --- | ---
+// encrypt_entry | variant, associated data length, message length
+// encrypt_return | variant, associated data length, message length
+// decrypt_entry | variant, associated data length, cipher text length
+// decrypt_return | variant, associated data length, cipher text length, flag
+// rekeying_entry | variant, rekeying flag ( 0 => ENC, 1 => MAC )
+// rekeying_return | variant, rekeying flag ( 0 => ENC, 1 => MAC )
+// verify_fail | variant, associated data length, cipher text length
+//
+// where variant is identified using `isap_common::variant_id`.
+
+#if defined ISAP_USDT
+
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#else
+#error "ISAP_USDT requires <sys/sdt.h>, install systemtap-sdt-dev"
+#endif
+
+#define ISAP_PROBE2(name, a0, a1) STAP_PROBE2(isap, name, a0, a1)
+#define ISAP_PROBE3(name, a0, a1, a2) STAP_PROBE3(isap, name, a0, a1, a2)
+#define ISAP_PROBE4(name, a0, a1, a2, a3)                                      \
+  STAP_PROBE4(isap, name, a0, a1, a2, a3)
+
+#else
+
+#define ISAP_PROBE2(name, a0, a1)
+#define ISAP_PROBE3(name, a0, a1, a2)
+#define ISAP_PROBE4(name, a0, a1, a2, a3)
+
+#endif
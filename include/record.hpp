@@ -0,0 +1,247 @@
+#pragma once
+#include "aead.hpp"
+#include "common.hpp"
+#include <cstdlib>
+#include <cstring>
+
+// Zero-copy record layer for datagram transports, built on top of ISAP AEAD,
+// which seals/ opens records in-place, inside preallocated packet buffers.
+//
+// Record is laid out as
+//
+// header ( 12 -bytes ) || payload ( N -bytes ) || tag ( 16 -bytes )
+//
+// where header is
+//
+// type ( 1 -byte ) || version ( 1 -byte ) || payload length ( 2 -bytes,
+// big-endian ) || sequence number ( 8 -bytes, big-endian )
+//
+// Header is authenticated as associated data, payload is encrypted in-place &
+// tag is appended right after it. Nonce of record is derived by XORing
+// sequence number ( as 64 -bit big-endian integer ) into last 8 -bytes of 16
+// -bytes per-connection IV, so that no two records sealed under same key share
+// nonce. As datagrams can be lost/ reordered, opener accepts records out of
+// order, while rejecting replays using a sliding window of 64 sequence numbers.
+namespace isap_record {
+
+// Version of record layout
+constexpr uint8_t VERSION = 1;
+
+// Byte length of record header
+constexpr size_t HDR_LEN = 12;
+
+// Byte length of authentication tag, appended to payload
+constexpr size_t TAG_LEN = isap_common::knt_len;
+
+// Byte length of per-record overhead
+constexpr size_t OVERHEAD = HDR_LEN + TAG_LEN;
+
+// Maximum byte length of payload, as it's encoded using 2 -bytes
+constexpr size_t MAX_PAYLOAD = 0xffff;
+
+// # -of sequence numbers, tracked by replay window
+constexpr uint64_t REPLAY_WINDOW = 64;
+
+// Given 16 -bytes IV & sequence number, this routine derives 16 -bytes nonce of
+// record
+static inline void
+record_nonce(const uint8_t* const __restrict iv,
+             const uint64_t seq,
+             uint8_t* const __restrict nonce)
+{
+  constexpr size_t last = isap_common::knt_len - 1;
+
+  std::memcpy(nonce, iv, isap_common::knt_len);
+  for (size_t i = 0; i < 8; i++) {
+    nonce[last - i] ^= static_cast<uint8_t>(seq >> (i << 3));
+  }
+}
+
+// Ring of preallocated, cache line aligned packet buffers, each large enough
+// to hold a record carrying maximum payload of given length. Buffers are
+// handed out in round-robin order, so a buffer is reused after `cnt` -many
+// acquisitions.
+struct ring_t
+{
+  uint8_t* mem = nullptr;
+  size_t slot_len = 0;
+  size_t cnt = 0;
+  size_t next = 0;
+
+  ring_t(const size_t n, const size_t max_payload)
+    : slot_len((max_payload + OVERHEAD + 63) / 64 * 64)
+    , cnt(n)
+  {
+    mem = static_cast<uint8_t*>(std::aligned_alloc(64, cnt * slot_len));
+  }
+
+  ~ring_t() { std::free(mem); }
+
+  ring_t(const ring_t&) = delete;
+  ring_t& operator=(const ring_t&) = delete;
+
+  // Returns next packet buffer of ring
+  inline uint8_t* acquire()
+  {
+    uint8_t* const slot = mem + next * slot_len;
+    next = (next + 1) % cnt;
+    return slot;
+  }
+
+  // Returns where payload of record starts, in given packet buffer
+  static inline uint8_t* payload(uint8_t* const slot) { return slot + HDR_LEN; }
+};
+
+// Seals records, sent over a connection, using ISAP instance chosen by template
+// parameters
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+struct sealer_t
+{
+  uint8_t key[isap_common::knt_len];
+  uint8_t iv[isap_common::knt_len];
+  uint64_t seq = 0;
+
+  // Given 16 -bytes secret key & 16 -bytes IV of connection, this routine
+  // initializes sealer, starting at sequence number 0
+  inline void init(const uint8_t* const __restrict k,
+                   const uint8_t* const __restrict v)
+  {
+    std::memcpy(key, k, sizeof(key));
+    std::memcpy(iv, v, sizeof(iv));
+    seq = 0;
+  }
+
+  // Given packet buffer, holding N -bytes payload starting at offset
+  // `HDR_LEN`, this routine writes header, encrypts payload in-place & appends
+  // tag, returning byte length of record. It returns 0, if payload is too long
+  // or sequence numbers are exhausted, in which case buffer is left untouched.
+  inline size_t seal(uint8_t* const rec, const size_t plen, const uint8_t type)
+  {
+    if (plen > MAX_PAYLOAD || seq == UINT64_MAX) {
+      return 0;
+    }
+
+    rec[0] = type;
+    rec[1] = VERSION;
+    rec[2] = static_cast<uint8_t>(plen >> 8);
+    rec[3] = static_cast<uint8_t>(plen);
+    for (size_t i = 0; i < 8; i++) {
+      rec[4 + i] = static_cast<uint8_t>(seq >> ((7 - i) << 3));
+    }
+
+    uint8_t nonce[isap_common::knt_len];
+    record_nonce(iv, seq, nonce);
+
+    uint8_t* const txt = rec + HDR_LEN;
+    isap::encrypt<p, s_b, s_k, s_e, s_h>(
+      key, nonce, rec, HDR_LEN, txt, txt, plen, txt + plen);
+
+    seq++;
+    return plen + OVERHEAD;
+  }
+};
+
+// Opens records, received over a connection, using ISAP instance chosen by
+// template parameters, while rejecting replayed records
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+struct opener_t
+{
+  uint8_t key[isap_common::knt_len];
+  uint8_t iv[isap_common::knt_len];
+  uint64_t top = 0;    // one more than highest sequence number accepted so far
+  uint64_t bitmap = 0; // bit i is set, if record `top - 1 - i` was accepted
+
+  // Given 16 -bytes secret key & 16 -bytes IV of connection, this routine
+  // initializes opener, with empty replay window
+  inline void init(const uint8_t* const __restrict k,
+                   const uint8_t* const __restrict v)
+  {
+    std::memcpy(key, k, sizeof(key));
+    std::memcpy(iv, v, sizeof(iv));
+    top = 0;
+    bitmap = 0;
+  }
+
+  // Checks whether record with given sequence number was already accepted or
+  // is too old to be tracked by replay window
+  inline bool is_replay(const uint64_t seq) const
+  {
+    if (seq >= top) {
+      return false;
+    }
+
+    const uint64_t off = top - 1 - seq;
+    return off >= REPLAY_WINDOW || ((bitmap >> off) & 1) == 1;
+  }
+
+  // Marks record with given sequence number as accepted, sliding window forward
+  // if needed
+  inline void accept(const uint64_t seq)
+  {
+    if (seq >= top) {
+      const uint64_t shift = seq - top + 1;
+
+      bitmap = shift >= REPLAY_WINDOW ? 0 : bitmap << shift;
+      bitmap |= 1;
+      top = seq + 1;
+    } else {
+      bitmap |= uint64_t{ 1 } << (top - 1 - seq);
+    }
+  }
+
+  // Given packet buffer holding N -bytes record, this routine authenticates &
+  // decrypts payload in-place ( starting at offset `HDR_LEN` ), returning
+  // boolean truth value only when record is well-formed, it's not a replay &
+  // it's authenticated. On success, payload length & type are written to
+  // `plen` & `type`.
+  //
+  // Note, on failure, buffer still holds encrypted payload.
+  inline bool open(uint8_t* const rec,
+                   const size_t rlen,
+                   size_t& plen,
+                   uint8_t& type)
+  {
+    if (rlen < OVERHEAD || rec[1] != VERSION) {
+      return false;
+    }
+
+    const size_t len = (static_cast<size_t>(rec[2]) << 8) | rec[3];
+    if (len != rlen - OVERHEAD) {
+      return false;
+    }
+
+    uint64_t seq = 0;
+    for (size_t i = 0; i < 8; i++) {
+      seq = (seq << 8) | rec[4 + i];
+    }
+
+    if (is_replay(seq)) {
+      return false;
+    }
+
+    uint8_t nonce[isap_common::knt_len];
+    record_nonce(iv, seq, nonce);
+
+    uint8_t* const enc = rec + HDR_LEN;
+    const bool flg = isap::decrypt<p, s_b, s_k, s_e, s_h>(
+      key, nonce, enc + len, rec, HDR_LEN, enc, enc, len);
+    if (!flg) {
+      return false;
+    }
+
+    accept(seq);
+    plen = len;
+    type = rec[0];
+    return true;
+  }
+};
+
+}
@@ -0,0 +1,235 @@
+#pragma once
+#include "common.hpp"
+#include <algorithm>
+#include <cstring>
+
+// Incremental ISAP encryption, whose mid-stream state ( i.e. encryption &
+// suffix-MAC sponge states, along with partially consumed key stream block &
+// partially filled cipher text block ) can be exported as a compact, versioned
+// blob & later resumed from, so that a preempted long-running encryption
+// continues from last checkpoint, instead of restarting from byte zero. Cipher
+// text & authentication tag are same as what one-shot `isap::encrypt`
+// computes, no matter how message is split into updates or where checkpoints
+// are taken.
+//
+// Checkpoint blob is laid out as
+//
+// magic ( 4 -bytes ) || version ( 1 -byte ) || variant ( 1 -byte ) || # -of
+// consumed key stream bytes ( 1 -byte ) || # -of buffered cipher text bytes ( 1
+// -byte ) || # -of processed message bytes ( 8 -bytes, little-endian ) ||
+// encryption sponge state || suffix-MAC sponge state || key stream block ||
+// cipher text block
+//
+// where sponge states are serialized same way as permutation state is
+// converted to bytes in ISAP specification, while both blocks are `rate`
+// -bytes.
+//
+// Note, checkpoint blob doesn't hold secret key, which must be supplied again,
+// when resuming. Still, it holds keyed sponge states, so it must be protected
+// same way as secret key. Also, only encryption is resumable, as streaming
+// decryption would release plain text before verifying tag.
+namespace isap_resumable {
+
+// Magic bytes, identifying checkpoint blob
+constexpr uint8_t MAGIC[]{ 'I', 'S', 'R', 'C' };
+
+// Version of checkpoint blob layout
+constexpr uint8_t VERSION = 1;
+
+// Byte length of fixed size prefix of checkpoint blob
+constexpr size_t PREFIX_LEN = 16;
+
+// Resumable encryptor of ISAP instance ( chosen by template parameters )
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+struct encryptor_t
+{
+  static constexpr size_t SLEN =
+    isap_common::PERM_STATE_LEN[static_cast<uint32_t>(p)];
+  static constexpr size_t RATE = isap_common::RATE[static_cast<uint32_t>(p)];
+
+  // Byte length of checkpoint blob
+  static constexpr size_t BLOB_LEN = PREFIX_LEN + 2 * SLEN + 2 * RATE;
+
+  uint8_t key[isap_common::knt_len];
+  isap_common::state_t<p> enc_state;
+  isap_common::state_t<p> mac_state;
+  uint8_t ks[RATE];   // current key stream block
+  uint8_t cbuf[RATE]; // cipher text bytes, not yet absorbed into suffix-MAC
+  size_t ks_off = RATE; // # -of consumed bytes of key stream block
+  size_t cbuf_len = 0;
+  uint64_t processed = 0; // # -of message bytes encrypted so far
+
+  // Given 16 -bytes secret key, 16 -bytes public message nonce & N ( >=0 )
+  // -bytes associated data, this routine starts encryption of a new message
+  inline void init(const uint8_t* const __restrict k,
+                   const uint8_t* const __restrict nonce,
+                   const uint8_t* const __restrict data,
+                   const size_t dlen)
+  {
+    using namespace isap_common;
+
+    std::memcpy(key, k, sizeof(key));
+
+    enc_init<p, s_b, s_k, s_e, s_h>(key, nonce, enc_state);
+
+    mac_init<p, s_b, s_k, s_e, s_h>(nonce, mac_state);
+    mac_absorb<p, s_b, s_k, s_e, s_h>(mac_state, data, dlen);
+    mac_domain_separate<p, s_b, s_k, s_e, s_h>(mac_state);
+
+    ks_off = RATE;
+    cbuf_len = 0;
+    processed = 0;
+  }
+
+  // Encrypts next N ( >=0 ) -bytes of message, writing equal many cipher text
+  // bytes. Message & cipher text may be same buffer, but they must not
+  // partially overlap.
+  inline void update(const uint8_t* const msg,
+                     uint8_t* const out,
+                     const size_t mlen)
+  {
+    size_t off = 0;
+
+    // finish partially consumed key stream block
+    if (ks_off < RATE) {
+      const size_t len = std::min(RATE - ks_off, mlen);
+
+      for (size_t i = 0; i < len; i++) {
+        out[i] = msg[i] ^ ks[ks_off + i];
+      }
+      absorb(out, len);
+
+      off += len;
+      ks_off += len;
+    }
+
+    // full blocks, when there's no partially filled cipher text block, are
+    // encrypted & absorbed in bulk
+    const size_t full = (mlen - off) / RATE * RATE;
+    if (full > 0 && cbuf_len == 0) {
+      isap_common::enc_squeeze<p, s_b, s_k, s_e, s_h>(
+        enc_state, msg + off, out + off, full);
+      isap_common::mac_absorb_blocks<p, s_b, s_k, s_e, s_h>(
+        mac_state, out + off, full / RATE);
+
+      off += full;
+    }
+
+    // rest of bytes, a key stream block at a time
+    while (off < mlen) {
+      const size_t len = std::min(RATE, mlen - off);
+
+      std::memset(ks, 0, sizeof(ks));
+      isap_common::enc_squeeze<p, s_b, s_k, s_e, s_h>(enc_state, ks, ks, RATE);
+
+      for (size_t i = 0; i < len; i++) {
+        out[off + i] = msg[off + i] ^ ks[i];
+      }
+      absorb(out + off, len);
+
+      off += len;
+      ks_off = len;
+    }
+
+    processed += mlen;
+  }
+
+  // Finishes encryption, computing 16 -bytes authentication tag
+  inline void finalize(uint8_t* const __restrict tag)
+  {
+    using namespace isap_common;
+
+    mac_absorb_last<p, s_b, s_k, s_e, s_h>(mac_state, cbuf, cbuf_len);
+    mac_finalize<p, s_b, s_k, s_e, s_h>(key, mac_state, tag);
+
+    cbuf_len = 0;
+  }
+
+  // Exports mid-stream state as `BLOB_LEN` -bytes checkpoint blob
+  inline void checkpoint(uint8_t* const __restrict blob) const
+  {
+    constexpr uint32_t vid = isap_common::variant_id<p, s_b, s_k, s_e, s_h>();
+
+    std::memcpy(blob, MAGIC, sizeof(MAGIC));
+    blob[4] = VERSION;
+    blob[5] = static_cast<uint8_t>(vid);
+    blob[6] = static_cast<uint8_t>(ks_off);
+    blob[7] = static_cast<uint8_t>(cbuf_len);
+    for (size_t i = 0; i < 8; i++) {
+      blob[8 + i] = static_cast<uint8_t>(processed >> (i << 3));
+    }
+
+    uint8_t* const st = blob + PREFIX_LEN;
+    enc_state.extract_bytes(st, SLEN);
+    mac_state.extract_bytes(st + SLEN, SLEN);
+
+    std::memcpy(st + 2 * SLEN, ks, RATE);
+    std::memcpy(st + 2 * SLEN + RATE, cbuf, RATE);
+  }
+
+  // Given 16 -bytes secret key ( same as used for starting encryption ) &
+  // `BLOB_LEN` -bytes checkpoint blob, this routine restores mid-stream state,
+  // returning boolean truth value only when blob is well-formed & it was
+  // exported by same ISAP instance. Encryption continues from message byte
+  // offset `processed`.
+  inline bool resume(const uint8_t* const __restrict k,
+                     const uint8_t* const __restrict blob)
+  {
+    constexpr uint32_t vid = isap_common::variant_id<p, s_b, s_k, s_e, s_h>();
+
+    if (std::memcmp(blob, MAGIC, sizeof(MAGIC)) != 0) {
+      return false;
+    }
+    if (blob[4] != VERSION || blob[5] != vid) {
+      return false;
+    }
+
+    // both blocks are consumed/ filled in lockstep
+    if (blob[6] < 1 || blob[6] > RATE || blob[7] != blob[6] % RATE) {
+      return false;
+    }
+
+    std::memcpy(key, k, sizeof(key));
+    ks_off = blob[6];
+    cbuf_len = blob[7];
+
+    processed = 0;
+    for (size_t i = 0; i < 8; i++) {
+      processed |= static_cast<uint64_t>(blob[8 + i]) << (i << 3);
+    }
+
+    const uint8_t* const st = blob + PREFIX_LEN;
+    enc_state.set_bytes(st, 0, SLEN);
+    mac_state.set_bytes(st + SLEN, 0, SLEN);
+
+    std::memcpy(ks, st + 2 * SLEN, RATE);
+    std::memcpy(cbuf, st + 2 * SLEN + RATE, RATE);
+    return true;
+  }
+
+  // Buffers N -bytes cipher text, absorbing each full block into suffix-MAC
+  // sponge
+  inline void absorb(const uint8_t* const __restrict in, const size_t len)
+  {
+    size_t off = 0;
+    while (off < len) {
+      const size_t n = std::min(RATE - cbuf_len, len - off);
+
+      std::memcpy(cbuf + cbuf_len, in + off, n);
+      cbuf_len += n;
+      off += n;
+
+      if (cbuf_len == RATE) {
+        isap_common::mac_absorb_blocks<p, s_b, s_k, s_e, s_h>(
+          mac_state, cbuf, 1);
+        cbuf_len = 0;
+      }
+    }
+  }
+};
+
+}
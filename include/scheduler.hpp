@@ -0,0 +1,330 @@
+#pragma once
+#include "aead.hpp"
+#include "resumable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Priority-aware scheduler of ISAP encryption jobs, running on a fixed pool of
+// worker threads, so that short, latency-critical messages ( say, 64 -bytes RPC
+// payloads ) don't queue behind bulk ones ( say, 100 MiB backups ) sharing the
+// same workers.
+//
+// Jobs are submitted in one of two priority classes. Latency-critical jobs are
+// encrypted in one go, while bulk jobs are encrypted using resumable encryptor
+// ( see include/resumable.hpp ), a slice at a time, where each slice ends at a
+// key stream block boundary. Between slices, worker goes back to queues, always
+// picking pending latency-critical jobs first, so that a latency-critical job
+// waits for at most one slice ( per worker ), instead of a whole bulk job.
+// Unfinished bulk jobs are requeued behind other bulk jobs, so that they share
+// workers round-robin. To keep bulk jobs from starving under sustained
+// latency-critical load, a bulk slice is run after every `LATENCY_BURST` -many
+// consecutive latency-critical jobs, when some bulk job is waiting.
+//
+// Cipher text & authentication tag are same as what one-shot `isap::encrypt`
+// computes, no matter how bulk jobs are sliced.
+namespace isap_sched {
+
+// Priority classes of jobs, in decreasing order of priority
+enum class prio_t : uint32_t
+{
+  LATENCY = 0, // latency-critical, never sliced
+  BULK = 1     // throughput oriented, sliced
+};
+
+// # -of priority classes
+constexpr size_t CLASSES = 2;
+
+// Default byte length of bulk job slice, small enough that a slice takes tens
+// of microseconds, while large enough that scheduling cost is amortized
+constexpr size_t DEFAULT_SLICE_LEN = 16ul << 10;
+
+// # -of latency-critical jobs, which may run back to back, while a bulk job is
+// waiting
+constexpr size_t LATENCY_BURST = 64;
+
+// # -of buckets in queueing delay histogram, where bucket i holds # -of waits
+// which took [2^(i-1), 2^i) nanoseconds
+constexpr size_t DELAY_BUCKETS = 40;
+
+// Monotonic clock reading, in nanoseconds
+static inline uint64_t
+now_ns()
+{
+  using namespace std::chrono;
+
+  const auto t = steady_clock::now().time_since_epoch();
+  return static_cast<uint64_t>(duration_cast<nanoseconds>(t).count());
+}
+
+// Metrics of a single priority class
+struct class_stats_t
+{
+  uint64_t jobs = 0;   // # -of completed jobs
+  uint64_t slices = 0; // # -of executed slices ( = jobs, if never sliced )
+  uint64_t bytes = 0;  // # -of encrypted message bytes
+  uint64_t delay[DELAY_BUCKETS]{}; // log2 ns histogram of queueing delays
+
+  // Records that a job ( or slice of it ) waited in queue for given duration
+  inline void record_delay(const uint64_t ns)
+  {
+    const size_t b = std::min<size_t>(std::bit_width(ns), DELAY_BUCKETS - 1);
+    delay[b]++;
+  }
+
+  // Upper bound ( in nanoseconds ) of given quantile ( in [0, 1] ) of queueing
+  // delay, as recorded in histogram
+  inline uint64_t delay_quantile(const double q) const
+  {
+    uint64_t tot = 0;
+    for (size_t i = 0; i < DELAY_BUCKETS; i++) {
+      tot += delay[i];
+    }
+
+    const uint64_t lim = static_cast<uint64_t>(q * static_cast<double>(tot));
+    uint64_t acc = 0;
+    for (size_t i = 0; i < DELAY_BUCKETS; i++) {
+      acc += delay[i];
+      if (acc > lim) {
+        return uint64_t{ 1 } << i;
+      }
+    }
+    return uint64_t{ 1 } << (DELAY_BUCKETS - 1);
+  }
+};
+
+// Point-in-time copy of scheduler metrics, indexed by priority class
+struct stats_t
+{
+  class_stats_t cls[CLASSES];
+
+  inline const class_stats_t& operator[](const prio_t c) const
+  {
+    return cls[static_cast<uint32_t>(c)];
+  }
+};
+
+// Encryption job of ISAP instance ( chosen by template parameters ). Caller
+// fills in arguments, same as taken by `isap::encrypt`, submits job & waits for
+// it to complete ( see `scheduler_t::wait` ). All buffers must stay alive &
+// untouched until then, while job itself can be resubmitted, once completed.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+struct job_t
+{
+  const uint8_t* key = nullptr;   // 16 -bytes secret key
+  const uint8_t* nonce = nullptr; // 16 -bytes public message nonce
+  const uint8_t* data = nullptr;  // N ( >=0 ) -bytes associated data
+  size_t dlen = 0;
+  const uint8_t* msg = nullptr; // N ( >=0 ) -bytes plain text
+  uint8_t* enc = nullptr;       // N -bytes cipher text
+  size_t mlen = 0;
+  uint8_t* tag = nullptr; // 16 -bytes authentication tag
+
+  // Scheduler owned state
+  prio_t prio = prio_t::LATENCY;
+  uint64_t queued_ns = 0; // when job ( or its next slice ) was queued
+  size_t off = 0;         // # -of message bytes encrypted so far
+  isap_resumable::encryptor_t<p, s_b, s_k, s_e, s_h> encryptor;
+  std::atomic<bool> done{ false };
+
+  // Checks ( without blocking ) whether job is completed
+  inline bool completed() const { return done.load(std::memory_order_acquire); }
+};
+
+// Scheduler of encryption jobs of ISAP instance ( chosen by template parameters
+// ), over a fixed pool of worker threads. Pending jobs are completed before
+// scheduler is destroyed.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+struct scheduler_t
+{
+  using job_t = isap_sched::job_t<p, s_b, s_k, s_e, s_h>;
+
+  static constexpr size_t RATE = isap_common::RATE[static_cast<uint32_t>(p)];
+
+  std::mutex lock;
+  std::condition_variable cv;      // signals workers, about queued jobs
+  std::condition_variable done_cv; // signals waiters, about completed jobs
+  std::deque<job_t*> queues[CLASSES];
+  stats_t st;
+  size_t burst = 0; // # -of latency-critical jobs run back to back
+  bool stopping = false;
+  const size_t slice;
+  std::vector<std::thread> workers;
+
+  // Given # -of worker threads ( 0 => all available cores ) & byte length of
+  // bulk job slice ( rounded down to multiple of rate, but at least rate ),
+  // this routine starts workers. Slice length of 0 disables slicing, so that
+  // bulk jobs run to completion, once picked up.
+  explicit scheduler_t(const size_t nthreads,
+                       const size_t slice_len = DEFAULT_SLICE_LEN)
+    : slice(slice_len == 0 ? 0 : std::max(slice_len / RATE * RATE, RATE))
+  {
+    const size_t hw = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    const size_t cnt = nthreads == 0 ? hw : nthreads;
+
+    for (size_t i = 0; i < cnt; i++) {
+      workers.emplace_back([this]() { run(); });
+    }
+  }
+
+  scheduler_t(const scheduler_t&) = delete;
+  scheduler_t& operator=(const scheduler_t&) = delete;
+
+  ~scheduler_t()
+  {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      stopping = true;
+    }
+    cv.notify_all();
+
+    for (auto& w : workers) {
+      w.join();
+    }
+  }
+
+  // Queues job in given priority class. Job must not be queued already.
+  inline void submit(job_t& job, const prio_t prio)
+  {
+    job.prio = prio;
+    job.off = 0;
+    job.done.store(false, std::memory_order_relaxed);
+
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      job.queued_ns = now_ns();
+      queues[static_cast<uint32_t>(prio)].push_back(&job);
+    }
+    cv.notify_one();
+  }
+
+  // Blocks calling thread until job is completed
+  inline void wait(const job_t& job)
+  {
+    std::unique_lock<std::mutex> guard(lock);
+    done_cv.wait(guard, [&]() { return job.completed(); });
+  }
+
+  // Aggregated metrics, since construction or last reset
+  inline stats_t stats()
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    return st;
+  }
+
+  inline void reset_stats()
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    st = stats_t{};
+  }
+
+  // Picks next job to run, blocking until one is available, while recording
+  // how long it waited in queue. Returns nullptr, only once scheduler is being
+  // stopped & all queues are drained.
+  inline job_t* pick()
+  {
+    std::unique_lock<std::mutex> guard(lock);
+    auto& lat = queues[static_cast<uint32_t>(prio_t::LATENCY)];
+    auto& bulk = queues[static_cast<uint32_t>(prio_t::BULK)];
+
+    cv.wait(guard, [&]() { return stopping || !lat.empty() || !bulk.empty(); });
+
+    if (lat.empty() && bulk.empty()) {
+      return nullptr;
+    }
+
+    const bool starving = !bulk.empty() && burst >= LATENCY_BURST;
+    auto& q = (lat.empty() || starving) ? bulk : lat;
+    burst = (&q == &lat) ? burst + 1 : 0;
+
+    job_t* const job = q.front();
+    q.pop_front();
+
+    st.cls[static_cast<uint32_t>(job->prio)].record_delay(now_ns() -
+                                                          job->queued_ns);
+    return job;
+  }
+
+  // Runs job, if latency-critical, or its next slice, if bulk, returning
+  // boolean truth value only when job is completed
+  inline bool step(job_t& job)
+  {
+    if (job.prio == prio_t::LATENCY) {
+      isap::encrypt<p, s_b, s_k, s_e, s_h>(job.key,
+                                           job.nonce,
+                                           job.data,
+                                           job.dlen,
+                                           job.msg,
+                                           job.enc,
+                                           job.mlen,
+                                           job.tag);
+      job.off = job.mlen;
+      return true;
+    }
+
+    if (job.off == 0) {
+      job.encryptor.init(job.key, job.nonce, job.data, job.dlen);
+    }
+
+    const size_t rem = job.mlen - job.off;
+    const size_t len = slice == 0 ? rem : std::min(slice, rem);
+
+    job.encryptor.update(job.msg + job.off, job.enc + job.off, len);
+    job.off += len;
+
+    if (job.off < job.mlen) {
+      return false;
+    }
+
+    job.encryptor.finalize(job.tag);
+    return true;
+  }
+
+  // Worker loop
+  inline void run()
+  {
+    while (job_t* const job = pick()) {
+      const size_t beg = job->off;
+      const bool fin = step(*job);
+
+      std::unique_lock<std::mutex> guard(lock);
+      class_stats_t& cs = st.cls[static_cast<uint32_t>(job->prio)];
+
+      cs.slices++;
+      cs.bytes += job->off - beg;
+
+      if (fin) {
+        // job may be destroyed by its owner as soon as it's marked completed,
+        // so it's not touched afterwards
+        cs.jobs++;
+        job->done.store(true, std::memory_order_release);
+        guard.unlock();
+
+        done_cv.notify_all();
+      } else {
+        // unfinished bulk job goes behind other bulk jobs
+        job->queued_ns = now_ns();
+        queues[static_cast<uint32_t>(prio_t::BULK)].push_back(job);
+        guard.unlock();
+
+        cv.notify_one();
+      }
+    }
+  }
+};
+
+}
@@ -0,0 +1,231 @@
+#pragma once
+#include "common.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Stage-pipelined encryption of an ordered stream of records ( say, messages
+// of a single connection ), all under same secret key, where phases of ISAP
+// encryption ( see include/common.hpp ) run as separate pipeline stages, each
+// on its own thread, so that a single stream can be spread over more than one
+// core, without ever reordering records. Stages are
+//
+// - ENC rekeying i.e. `enc_init`
+// - key stream squeezing & XOR-ing with plain text i.e. `enc_squeeze`
+// - suffix-MAC absorption of associated data & cipher text
+// - suffix-MAC finalization i.e. MAC rekeying & tag squeezing
+//
+// where MAC is split into two stages, as it's the most expensive phase.
+//
+// Records flow through a ring of preallocated slots, while each stage owns a
+// cursor, counting # -of records it has finished. A stage may process record i
+// only once preceding stage's cursor is past i, while producer may reuse a slot
+// only once last stage is done with it, so that each pair of adjacent stages is
+// connected by a lock-free single-producer single-consumer queue. As all stages
+// process records in order, records are finished in same order they're pushed.
+namespace isap_stage_pipeline {
+
+// # -of stages, excluding producer
+constexpr size_t STAGES = 4;
+
+// Default # -of slots in ring
+constexpr size_t DEFAULT_SLOTS = 64;
+
+// # -of times a stage polls its input cursor, before going to sleep
+constexpr size_t SPIN = 256;
+
+// A single record of stream, same as arguments taken by `isap::encrypt`. All
+// buffers must stay alive & untouched, until record is finished.
+struct record_t
+{
+  const uint8_t* nonce; // 16 -bytes public message nonce
+  const uint8_t* data;  // N ( >=0 ) -bytes associated data
+  size_t dlen;
+  const uint8_t* msg; // N ( >=0 ) -bytes plain text
+  uint8_t* enc;       // N -bytes cipher text
+  size_t mlen;
+  uint8_t* tag; // 16 -bytes authentication tag
+};
+
+// Cursor of a stage, on its own cache line, so that stages don't false share
+struct alignas(64) cursor_t
+{
+  std::atomic<uint64_t> v{ 0 };
+};
+
+// Waits until cursor reaches given value, first spinning for a while, then
+// sleeping on it
+static inline void
+await(const std::atomic<uint64_t>& c, const uint64_t want)
+{
+  for (size_t i = 0; i < SPIN; i++) {
+    if (c.load(std::memory_order_acquire) >= want) {
+      return;
+    }
+    std::this_thread::yield();
+  }
+
+  while (true) {
+    const uint64_t v = c.load(std::memory_order_acquire);
+    if (v >= want) {
+      return;
+    }
+    c.wait(v, std::memory_order_acquire);
+  }
+}
+
+// Publishes new cursor value, waking up sleeping successor ( if any )
+static inline void
+publish(std::atomic<uint64_t>& c, const uint64_t v)
+{
+  c.store(v, std::memory_order_release);
+  c.notify_all();
+}
+
+// Stage-pipelined encryptor of a stream of records, using ISAP instance (
+// chosen by template parameters ). Records must be pushed by a single thread,
+// while finished records can be observed by any thread.
+template<const isap_common::perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+struct stream_t
+{
+  using ctx_t = isap_common::key_context_t<p, s_b, s_k, s_e, s_h>;
+  using state_t = isap_common::state_t<p>;
+
+  // Slot of ring, holding a record & sponge states, handed from stage to stage
+  struct slot_t
+  {
+    record_t rec;
+    bool stop; // sentinel, asking stages to exit
+    state_t enc_state;
+    state_t mac_state;
+  };
+
+  const ctx_t ctx;
+  const size_t cap;
+  std::unique_ptr<slot_t[]> slots;
+  cursor_t pushed;       // # -of records pushed by producer
+  cursor_t done[STAGES]; // # -of records finished by each stage
+  std::vector<std::thread> workers;
+
+  // Given 16 -bytes secret key & # -of slots in ring, this routine starts one
+  // thread per stage
+  explicit stream_t(const uint8_t* const __restrict key,
+                    const size_t nslots = DEFAULT_SLOTS)
+    : ctx(key)
+    , cap(std::max<size_t>(nslots, 1))
+    , slots(new slot_t[cap])
+  {
+    for (size_t k = 0; k < STAGES; k++) {
+      workers.emplace_back([this, k]() { run(k); });
+    }
+  }
+
+  stream_t(const stream_t&) = delete;
+  stream_t& operator=(const stream_t&) = delete;
+
+  // Finishes all pushed records, before stopping stages
+  ~stream_t()
+  {
+    slot_t& s = acquire();
+    s.stop = true;
+    publish(pushed.v, pushed.v.load(std::memory_order_relaxed) + 1);
+
+    for (auto& w : workers) {
+      w.join();
+    }
+  }
+
+  // Pushes record at tail of stream, blocking while ring is full
+  inline void push(const record_t& rec)
+  {
+    slot_t& s = acquire();
+    s.rec = rec;
+    s.stop = false;
+    publish(pushed.v, pushed.v.load(std::memory_order_relaxed) + 1);
+  }
+
+  // # -of records finished so far. As records are finished in order, first
+  // these many pushed records have their cipher text & tag ready.
+  inline uint64_t finished() const
+  {
+    return done[STAGES - 1].v.load(std::memory_order_acquire);
+  }
+
+  // Blocks until all pushed records are finished. Must be called by producer.
+  inline void drain() const
+  {
+    await(done[STAGES - 1].v, pushed.v.load(std::memory_order_relaxed));
+  }
+
+  // Waits for next slot to be free, returning it
+  inline slot_t& acquire()
+  {
+    const uint64_t i = pushed.v.load(std::memory_order_relaxed);
+    if (i >= cap) {
+      await(done[STAGES - 1].v, i - cap + 1);
+    }
+    return slots[i % cap];
+  }
+
+  // Runs k -th stage over slot
+  inline void step(const size_t k, slot_t& s)
+  {
+    using namespace isap_common;
+
+    const record_t& r = s.rec;
+
+    switch (k) {
+      case 0:
+        // nothing to encrypt, so ENC rekeying is skipped, same as `enc`
+        if (r.mlen > 0) {
+          enc_init<p, s_b, s_k, s_e, s_h>(ctx, r.nonce, s.enc_state);
+        }
+        break;
+      case 1:
+        if (r.mlen > 0) {
+          enc_squeeze<p, s_b, s_k, s_e, s_h>(
+            s.enc_state, r.msg, r.enc, r.mlen);
+        }
+        break;
+      case 2:
+        mac_init<p, s_b, s_k, s_e, s_h>(r.nonce, s.mac_state);
+        mac_absorb<p, s_b, s_k, s_e, s_h>(s.mac_state, r.data, r.dlen);
+        mac_domain_separate<p, s_b, s_k, s_e, s_h>(s.mac_state);
+        mac_absorb<p, s_b, s_k, s_e, s_h>(s.mac_state, r.enc, r.mlen);
+        break;
+      default:
+        mac_finalize<p, s_b, s_k, s_e, s_h>(ctx, s.mac_state, r.tag);
+        break;
+    }
+  }
+
+  // Loop of k -th stage, which consumes records finished by preceding stage (
+  // or pushed by producer ), until it sees stop sentinel
+  inline void run(const size_t k)
+  {
+    const std::atomic<uint64_t>& in = k == 0 ? pushed.v : done[k - 1].v;
+    std::atomic<uint64_t>& out = done[k].v;
+
+    for (uint64_t i = 0;; i++) {
+      await(in, i + 1);
+
+      slot_t& s = slots[i % cap];
+      if (s.stop) {
+        publish(out, i + 1);
+        break;
+      }
+
+      step(k, s);
+      publish(out, i + 1);
+    }
+  }
+};
+
+}
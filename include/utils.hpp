@@ -162,7 +162,7 @@ copy_le_u64_to_bytes(const uint64_t* const __restrict words,
   } else {
     size_t boff = 0;
     while (boff < blen) {
-      const size_t elen = std::min(blen - boff, 8ul);
+      const size_t elen = std::min<size_t>(blen - boff, 8);
       const uint64_t v = bswap(words[boff / 8]);
 
       std::memcpy(bytes + boff, &v, elen);
@@ -184,7 +184,7 @@ copy_be_u64_to_bytes(const uint64_t* const __restrict words,
   if constexpr (std::endian::native == std::endian::little) {
     size_t boff = 0;
     while (boff < blen) {
-      const size_t elen = std::min(blen - boff, 8ul);
+      const size_t elen = std::min<size_t>(blen - boff, 8);
       const uint64_t v = bswap(words[boff / 8]);
 
       std::memcpy(bytes + boff, &v, elen);
@@ -211,7 +211,7 @@ copy_le_u16_to_bytes(const uint16_t* const __restrict words,
   } else {
     size_t boff = 0;
     while (boff < blen) {
-      const size_t elen = std::min(blen - boff, 2ul);
+      const size_t elen = std::min<size_t>(blen - boff, 2);
       const uint16_t v = bswap(words[boff / 2]);
 
       std::memcpy(bytes + boff, &v, elen);
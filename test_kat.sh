@@ -4,6 +4,8 @@
 
 # generate shared library object
 make lib
+# build command-line tool for chunked file encryption
+make tools/isap-file
 
 # ---
 
@@ -30,6 +32,48 @@ rm -rf tmp
 
 # ---
 
+# check permutation backends & Known Answer Tests using command-line checkers,
+# along with their 32 -bit or AArch64 builds, when asked for i.e.
+# `bash test_kat.sh 32` or `bash test_kat.sh aarch64`, where latter are run
+# under qemu-aarch64 ( override using QEMU_AARCH64 )
+make tools/isap-perm-check tools/isap-kat tools/isap-kat-instr
+make tools/isap-record-check tools/isap-key-cache-check tools/isap-key-store-check
+perm_tools=(./tools/isap-perm-check)
+check_tools=(./tools/isap-record-check ./tools/isap-key-cache-check
+  ./tools/isap-key-store-check)
+kat_tools=(./tools/isap-kat ./tools/isap-kat-instr)
+
+# hand-written assembly Ascon-p backend ( see asm/ascon_x86_64.S ) is only
+# built on x86-64 hosts
+if [ "$(uname -m)" == "x86_64" ]; then
+  make tools/isap-perm-check-asm tools/isap-kat-asm
+  perm_tools+=(./tools/isap-perm-check-asm)
+  kat_tools+=(./tools/isap-kat-asm)
+fi
+
+if [ "$1" == "32" ]; then
+  make tools/isap-perm-check32 tools/isap-kat32
+  perm_tools+=(./tools/isap-perm-check32)
+  kat_tools+=(./tools/isap-kat32)
+elif [ "$1" == "aarch64" ]; then
+  qemu=${QEMU_AARCH64:-qemu-aarch64}
+  make tools/isap-perm-check-aarch64 tools/isap-kat-aarch64
+  perm_tools+=("$qemu ./tools/isap-perm-check-aarch64")
+  kat_tools+=("$qemu ./tools/isap-kat-aarch64")
+fi
+
+for tool in "${perm_tools[@]}" "${check_tools[@]}"; do
+  $tool || exit 1
+done
+
+for tool in "${kat_tools[@]}"; do
+  for v in a-128a a-128 k-128a k-128; do
+    $tool $v LWC_AEAD_KAT_128_128.txt.isap_${v//-/_} || exit 1
+  done
+done
+
+# ---
+
 pushd wrapper/python
 
 # run tests
@@ -45,11 +89,23 @@ python3 -m pytest -k isap_k_128a_aead --cache-clear -v
 mv ../../LWC_AEAD_KAT_128_128.txt.isap_k_128 LWC_AEAD_KAT_128_128.txt
 python3 -m pytest -k isap_k_128_aead --cache-clear -v
 
+# chunked file encryption & in-place encryption tests, which don't need Known
+# Answer Tests
+python3 -m pytest -k "isap_file or in_place" --cache-clear -v
+
 # clean up
 rm LWC_AEAD_KAT_*.txt
 
 popd
 
+# instrumentation counters, as exposed through C ABI, need shared library
+# object built with instrumentation enabled
+make lib DFLAGS="-DISAP_INSTRUMENT -DISAP_INSTRUMENT_LATENCY"
+
+pushd wrapper/python
+python3 -m pytest -k instr --cache-clear -v
+popd
+
 make clean
 
 # ---
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdio>
+
+// Bookkeeping shared by standalone checkers under tools/, each of which runs a
+// group of checks per ISAP variant ( or per permutation backend ) & reports
+// how many of them passed
+namespace isap_check {
+
+// Outcome of a group of checks
+struct result_t
+{
+  size_t passed = 0;
+  size_t failed = 0;
+
+  inline void check(const bool ok) { ok ? passed++ : failed++; }
+};
+
+// Prints outcome of a group of checks, returning boolean truth value only when
+// all of them passed, given that at least one was run
+inline static bool
+report(const char* const name, const result_t& res)
+{
+  std::printf("%s: %zu passed, %zu failed\n", name, res.passed, res.failed);
+  return res.failed == 0 && res.passed > 0;
+}
+
+}
@@ -0,0 +1,530 @@
+#include "archive.hpp"
+#include "chunked.hpp"
+#include "pipeline.hpp"
+#include "isap.hpp"
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <random>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+// Command-line tool for encrypting/ decrypting files using chunked encryption
+// format ( see include/chunked.hpp ), processing chunks in parallel over all
+// available cores, while both input & output files are memory mapped. It can
+// also produce random-access archives ( see include/archive.hpp ), out of which
+// any byte range can be extracted, decrypting only chunks covering that range,
+// while non-seekable inputs ( say pipes ) can be encrypted using streaming I/O
+// pipeline ( see include/pipeline.hpp ).
+//
+// Build it with
+//
+// make tools/isap-file
+
+using isap_common::perm_t;
+
+// Signature of chunked encryption routine of some ISAP instance
+using encrypt_fn = void (*)(const uint8_t* const __restrict,
+                            const uint8_t* const __restrict,
+                            const uint32_t,
+                            const uint8_t* const __restrict,
+                            const size_t,
+                            uint8_t* const __restrict,
+                            const size_t);
+
+// Signature of chunked decryption routine of some ISAP instance
+using decrypt_fn = bool (*)(const uint8_t* const __restrict,
+                            const uint8_t* const __restrict,
+                            const size_t,
+                            uint8_t* const __restrict,
+                            const size_t);
+
+// Signature of range extraction routine of some ISAP instance, which decrypts
+// [offset, offset + length) -bytes out of archive
+using extract_fn = bool (*)(const uint8_t* const __restrict,
+                            const uint8_t* const __restrict,
+                            const size_t,
+                            const uint64_t,
+                            const size_t,
+                            uint8_t* const __restrict);
+
+// Signature of streaming encryption routine of some ISAP instance, which
+// encrypts everything read from input file descriptor
+using stream_fn = bool (*)(const uint8_t* const __restrict,
+                           const uint8_t* const __restrict,
+                           const uint32_t,
+                           const int,
+                           const int,
+                           const size_t,
+                           isap_pipeline::stats_t&);
+
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static bool
+extract(const uint8_t* const __restrict key,
+        const uint8_t* const __restrict in,
+        const size_t ilen,
+        const uint64_t off,
+        const size_t len,
+        uint8_t* const __restrict out)
+{
+  isap_archive::reader_t<p, s_b, s_k, s_e, s_h> reader;
+  return reader.open(key, in, ilen) && reader.read_range(off, len, out);
+}
+
+// ISAP instance, which can be chosen from command-line
+struct variant_t
+{
+  const char* name;
+  uint32_t id;
+  encrypt_fn enc;
+  decrypt_fn dec;
+  encrypt_fn arc;
+  extract_fn ext;
+  stream_fn str;
+};
+
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static constexpr variant_t
+make_variant(const char* const name)
+{
+  return { name,
+           isap_common::variant_id<p, s_b, s_k, s_e, s_h>(),
+           isap_chunked::encrypt<p, s_b, s_k, s_e, s_h>,
+           isap_chunked::decrypt<p, s_b, s_k, s_e, s_h>,
+           isap_archive::encrypt<p, s_b, s_k, s_e, s_h>,
+           extract<p, s_b, s_k, s_e, s_h>,
+           isap_pipeline::encrypt_fd<p, s_b, s_k, s_e, s_h> };
+}
+
+static const variant_t VARIANTS[]{
+  make_variant<perm_t::ASCON, 1, 12, 6, 12>("a-128a"),
+  make_variant<perm_t::ASCON, 12, 12, 12, 12>("a-128"),
+  make_variant<perm_t::KECCAK, 1, 8, 8, 16>("k-128a"),
+  make_variant<perm_t::KECCAK, 12, 12, 12, 20>("k-128"),
+};
+
+static void
+usage(const char* const prog)
+{
+  std::fprintf(
+    stderr,
+    "Usage: %s encrypt -k KEY [-v VARIANT] [-n NONCE] [-c CHUNK] [-t THREADS] "
+    "IN OUT\n"
+    "       %s decrypt -k KEY [-t THREADS] IN OUT\n"
+    "       %s archive -k KEY [-v VARIANT] [-n NONCE] [-c CHUNK] [-t THREADS] "
+    "IN OUT\n"
+    "       %s extract -k KEY -o OFFSET -l LENGTH IN OUT\n"
+    "       %s stream -k KEY [-v VARIANT] [-n NONCE] [-c CHUNK] [-b BUFFERS] "
+    "IN|- OUT|-\n\n"
+    "  -k KEY      16 -bytes secret key, as 32 hex characters\n"
+    "  -v VARIANT  one of a-128a ( default ), a-128, k-128a, k-128\n"
+    "  -n NONCE    16 -bytes file nonce, as 32 hex characters ( default: "
+    "random )\n"
+    "  -c CHUNK    chunk length in bytes ( default: %zu )\n"
+    "  -t THREADS  # -of threads ( default: 0 => all available cores )\n"
+    "  -o OFFSET   byte offset of range to be extracted from archive\n"
+    "  -l LENGTH   byte length of range to be extracted from archive\n"
+    "  -b BUFFERS  # -of buffers in streaming pipeline ( default: 8 )\n",
+    prog,
+    prog,
+    prog,
+    prog,
+    prog,
+    isap_chunked::DEFAULT_CHUNK_LEN);
+}
+
+// Parses 32 hex characters as 16 -bytes, returning boolean truth value only
+// when well-formed
+static bool
+parse_hex(const char* const str, uint8_t* const bytes)
+{
+  if (std::strlen(str) != isap_common::knt_len << 1) {
+    return false;
+  }
+
+  auto nibble = [](const char c) -> int {
+    if (c >= '0' && c <= '9') {
+      return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+      return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+      return c - 'A' + 10;
+    }
+    return -1;
+  };
+
+  for (size_t i = 0; i < isap_common::knt_len; i++) {
+    const int hi = nibble(str[i << 1]);
+    const int lo = nibble(str[(i << 1) + 1]);
+    if (hi < 0 || lo < 0) {
+      return false;
+    }
+    bytes[i] = static_cast<uint8_t>((hi << 4) | lo);
+  }
+
+  return true;
+}
+
+// Memory maps whole input file ( read-only ), returning nullptr for empty file
+static bool
+map_input(const char* const path, const uint8_t*& ptr, size_t& len)
+{
+  const int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    std::perror(path);
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    std::perror(path);
+    close(fd);
+    return false;
+  }
+
+  len = static_cast<size_t>(st.st_size);
+  ptr = nullptr;
+
+  if (len > 0) {
+    void* const mem = mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED) {
+      std::perror(path);
+      close(fd);
+      return false;
+    }
+
+    madvise(mem, len, MADV_SEQUENTIAL);
+    ptr = static_cast<const uint8_t*>(mem);
+  }
+
+  close(fd);
+  return true;
+}
+
+// Finds ISAP instance, identified by `isap_common::variant_id`
+static const variant_t*
+find_variant(const uint32_t id)
+{
+  for (const variant_t& v : VARIANTS) {
+    if (v.id == id) {
+      return &v;
+    }
+  }
+  return nullptr;
+}
+
+// Creates ( or truncates ) output file of given length & memory maps it
+static bool
+map_output(const char* const path, const size_t len, uint8_t*& ptr)
+{
+  const int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    std::perror(path);
+    return false;
+  }
+
+  if (ftruncate(fd, static_cast<off_t>(len)) != 0) {
+    std::perror(path);
+    close(fd);
+    return false;
+  }
+
+  ptr = nullptr;
+
+  if (len > 0) {
+    void* const mem =
+      mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mem == MAP_FAILED) {
+      std::perror(path);
+      close(fd);
+      return false;
+    }
+
+    ptr = static_cast<uint8_t*>(mem);
+  }
+
+  close(fd);
+  return true;
+}
+
+// Encrypts input file ( or stdin, if path is `-` ) to output file ( or stdout,
+// if path is `-` ) using streaming I/O pipeline, reporting per-stage statistics
+// on stderr
+static int
+stream(const variant_t& var,
+       const uint8_t* const key,
+       const uint8_t* const nonce,
+       const size_t clen,
+       const size_t nbufs,
+       const char* const ipath,
+       const char* const opath)
+{
+  const bool std_in = std::strcmp(ipath, "-") == 0;
+  const bool std_out = std::strcmp(opath, "-") == 0;
+
+  const int ifd = std_in ? STDIN_FILENO : open(ipath, O_RDONLY);
+  if (ifd < 0) {
+    std::perror(ipath);
+    return EXIT_FAILURE;
+  }
+
+  const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+  const int ofd = std_out ? STDOUT_FILENO : open(opath, flags, 0644);
+  if (ofd < 0) {
+    std::perror(opath);
+    return EXIT_FAILURE;
+  }
+
+  isap_pipeline::stats_t st;
+  const bool ok =
+    var.str(key, nonce, static_cast<uint32_t>(clen), ifd, ofd, nbufs, st);
+
+  if (!std_in) {
+    close(ifd);
+  }
+  if (!std_out) {
+    close(ofd);
+  }
+
+  if (!ok) {
+    std::fprintf(stderr, "%s: streaming encryption failed\n", ipath);
+    return EXIT_FAILURE;
+  }
+
+  const std::pair<const char*, const isap_pipeline::stage_stats_t*> stages[]{
+    { "read", &st.read }, { "crypto", &st.crypto }, { "write", &st.write }
+  };
+
+  for (const auto& [name, s] : stages) {
+    std::fprintf(stderr,
+                 "%-6s : %12" PRIu64 " bytes, %10.2f MB/s when busy, "
+                 "%5.1f%% busy\n",
+                 name,
+                 s->bytes,
+                 s->throughput() / 1e6,
+                 s->utilization(st.wall_ns) * 100.);
+  }
+
+  return EXIT_SUCCESS;
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  const std::string mode(argv[1]);
+  if (mode != "encrypt" && mode != "decrypt" && mode != "archive" &&
+      mode != "extract" && mode != "stream") {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  uint8_t key[isap_common::knt_len];
+  uint8_t nonce[isap_common::knt_len];
+  bool has_key = false;
+  bool has_nonce = false;
+  const variant_t* var = &VARIANTS[0];
+  size_t clen = isap_chunked::DEFAULT_CHUNK_LEN;
+  size_t nthreads = 0;
+  uint64_t roff = 0;
+  size_t rlen = 0;
+  size_t nbufs = 8;
+
+  int opt;
+  optind = 2;
+  while ((opt = getopt(argc, argv, "k:v:n:c:t:o:l:b:")) != -1) {
+    switch (opt) {
+      case 'k':
+        has_key = parse_hex(optarg, key);
+        if (!has_key) {
+          std::fprintf(stderr, "invalid key: %s\n", optarg);
+          return EXIT_FAILURE;
+        }
+        break;
+      case 'n':
+        has_nonce = parse_hex(optarg, nonce);
+        if (!has_nonce) {
+          std::fprintf(stderr, "invalid nonce: %s\n", optarg);
+          return EXIT_FAILURE;
+        }
+        break;
+      case 'v':
+        var = nullptr;
+        for (const variant_t& v : VARIANTS) {
+          if (std::strcmp(v.name, optarg) == 0) {
+            var = &v;
+          }
+        }
+        if (var == nullptr) {
+          std::fprintf(stderr, "unknown variant: %s\n", optarg);
+          return EXIT_FAILURE;
+        }
+        break;
+      case 'c':
+        clen = std::strtoull(optarg, nullptr, 10);
+        if (clen == 0 || clen > UINT32_MAX) {
+          std::fprintf(stderr, "invalid chunk length: %s\n", optarg);
+          return EXIT_FAILURE;
+        }
+        break;
+      case 't':
+        nthreads = std::strtoull(optarg, nullptr, 10);
+        break;
+      case 'o':
+        roff = std::strtoull(optarg, nullptr, 10);
+        break;
+      case 'l':
+        rlen = std::strtoull(optarg, nullptr, 10);
+        break;
+      case 'b':
+        nbufs = std::strtoull(optarg, nullptr, 10);
+        break;
+      default:
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+
+  if (!has_key || argc - optind != 2) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  const char* const ipath = argv[optind];
+  const char* const opath = argv[optind + 1];
+
+  if (!has_nonce && mode != "decrypt" && mode != "extract") {
+    // not using `isap_utils::random_data`, as it only has 32 -bit seed
+    std::random_device rd;
+    for (size_t i = 0; i < sizeof(nonce); i += sizeof(uint32_t)) {
+      const uint32_t v = rd();
+      std::memcpy(nonce + i, &v, sizeof(v));
+    }
+  }
+
+  if (mode == "stream") {
+    return stream(*var, key, nonce, clen, nbufs, ipath, opath);
+  }
+
+  const uint8_t* in;
+  size_t ilen;
+  if (!map_input(ipath, in, ilen)) {
+    return EXIT_FAILURE;
+  }
+
+  int status = EXIT_SUCCESS;
+
+  if (mode == "encrypt" || mode == "archive") {
+    const bool arc = mode == "archive";
+    const size_t olen = arc ? isap_archive::archive_len(ilen, clen)
+                            : isap_chunked::encrypted_len(ilen, clen);
+
+    uint8_t* out;
+    if (!map_output(opath, olen, out)) {
+      return EXIT_FAILURE;
+    }
+
+    const encrypt_fn fn = arc ? var->arc : var->enc;
+    fn(key, nonce, static_cast<uint32_t>(clen), in, ilen, out, nthreads);
+    munmap(out, olen);
+  } else if (mode == "extract") {
+    isap_chunked::header_t hdr;
+
+    constexpr size_t minlen =
+      isap_archive::HDR_LEN + isap_archive::TRAILER_LEN;
+
+    const bool valid = ilen >= minlen && isap_archive::decode_header(in, hdr);
+    if (!valid) {
+      std::fprintf(stderr, "%s: malformed archive\n", ipath);
+      return EXIT_FAILURE;
+    }
+
+    // message can't be longer than archive itself, so that a range beyond it
+    // is rejected, before output buffer is sized from it
+    const size_t maxlen = ilen - minlen;
+    if (roff > maxlen || rlen > maxlen - roff) {
+      std::fprintf(stderr, "%s: range out of bounds\n", ipath);
+      return EXIT_FAILURE;
+    }
+
+    var = find_variant(hdr.variant);
+    if (var == nullptr) {
+      std::fprintf(stderr, "%s: unknown variant %u\n", ipath, hdr.variant);
+      return EXIT_FAILURE;
+    }
+
+    std::vector<uint8_t> out(rlen);
+    if (!var->ext(key, in, ilen, roff, rlen, out.data())) {
+      std::fprintf(stderr, "%s: authentication failed\n", ipath);
+      status = EXIT_FAILURE;
+    } else {
+      FILE* const fd = std::fopen(opath, "wb");
+      if (fd == nullptr || std::fwrite(out.data(), 1, rlen, fd) != rlen) {
+        std::perror(opath);
+        status = EXIT_FAILURE;
+      }
+      if (fd != nullptr) {
+        std::fclose(fd);
+      }
+    }
+  } else {
+    isap_chunked::header_t hdr;
+    size_t olen;
+
+    const bool valid = ilen >= isap_chunked::HDR_LEN &&
+                       isap_chunked::decode_header(in, hdr) &&
+                       isap_chunked::plain_len(ilen, hdr.chunk_len, olen);
+    if (!valid) {
+      std::fprintf(stderr, "%s: malformed encrypted file\n", ipath);
+      return EXIT_FAILURE;
+    }
+
+    var = find_variant(hdr.variant);
+    if (var == nullptr) {
+      std::fprintf(stderr, "%s: unknown variant %u\n", ipath, hdr.variant);
+      return EXIT_FAILURE;
+    }
+
+    uint8_t* out;
+    if (!map_output(opath, olen, out)) {
+      return EXIT_FAILURE;
+    }
+
+    const bool ok = var->dec(key, in, ilen, out, nthreads);
+    if (olen > 0) {
+      munmap(out, olen);
+    }
+
+    if (!ok) {
+      std::fprintf(stderr, "%s: authentication failed\n", ipath);
+      unlink(opath);
+      status = EXIT_FAILURE;
+    }
+  }
+
+  if (ilen > 0) {
+    munmap(const_cast<uint8_t*>(in), ilen);
+  }
+
+  return status;
+}
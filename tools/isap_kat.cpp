@@ -0,0 +1,393 @@
+#include "cost.hpp"
+#include "isap.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Command-line Known Answer Test checker, which reads a NIST LWC formatted KAT
+// file ( i.e. LWC_AEAD_KAT_128_128.txt, see test_kat.sh ) & checks that, for
+// each test, chosen ISAP variant's encryption produces expected cipher text &
+// tag, while decryption recovers plain text & verify-only routine accepts tag.
+// Fan-out encryption, for a single recipient, must produce same output, while
+// for 3 & 9 recipients, it must match per-recipient encryption. Also checks
+// instrumentation counters ( see include/instrument.hpp ) against cost model (
+// see include/cost.hpp ), when built with `ISAP_INSTRUMENT`, i.e.
+//
+// make tools/isap-kat DFLAGS="-DISAP_INSTRUMENT -DISAP_INSTRUMENT_LATENCY"
+// Unlike Python tests, it doesn't load a shared library object, so it can also
+// be run when built for a target, whose ABI differs from host Python
+// interpreter's, say a 32 -bit build.
+//
+// Build it with
+//
+// make tools/isap-kat # or tools/isap-kat32, for 32 -bit build
+//
+// and run it as
+//
+// ./tools/isap-kat a-128a LWC_AEAD_KAT_128_128.txt
+
+using isap_common::perm_t;
+
+// A single Known Answer Test, where cipher text is followed by tag
+struct kat_t
+{
+  uint64_t count = 0;
+  std::vector<uint8_t> key;
+  std::vector<uint8_t> nonce;
+  std::vector<uint8_t> pt;
+  std::vector<uint8_t> ad;
+  std::vector<uint8_t> ct;
+};
+
+// Checks a Known Answer Test against some ISAP instance, returning boolean
+// truth value only when it passes
+using check_fn = bool (*)(const kat_t&);
+
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static bool
+check(const kat_t& kat)
+{
+  constexpr size_t tlen = isap_common::knt_len;
+
+  if (kat.key.size() != isap_common::knt_len ||
+      kat.nonce.size() != isap_common::knt_len ||
+      kat.ct.size() != kat.pt.size() + tlen) {
+    return false;
+  }
+
+  const size_t mlen = kat.pt.size();
+  const uint8_t* const tag = kat.ct.data() + mlen;
+
+  std::vector<uint8_t> enc(mlen);
+  std::vector<uint8_t> dec(mlen);
+  uint8_t etag[tlen];
+
+  isap::encrypt<p, s_b, s_k, s_e, s_h>(kat.key.data(),
+                                       kat.nonce.data(),
+                                       kat.ad.data(),
+                                       kat.ad.size(),
+                                       kat.pt.data(),
+                                       enc.data(),
+                                       mlen,
+                                       etag);
+
+  bool ok = std::memcmp(enc.data(), kat.ct.data(), mlen) == 0;
+  ok &= std::memcmp(etag, tag, tlen) == 0;
+
+  ok &= isap::decrypt<p, s_b, s_k, s_e, s_h>(kat.key.data(),
+                                             kat.nonce.data(),
+                                             tag,
+                                             kat.ad.data(),
+                                             kat.ad.size(),
+                                             kat.ct.data(),
+                                             dec.data(),
+                                             mlen);
+  ok &= dec == kat.pt;
+
+  ok &= isap::verify<p, s_b, s_k, s_e, s_h>(kat.key.data(),
+                                            kat.nonce.data(),
+                                            tag,
+                                            kat.ad.data(),
+                                            kat.ad.size(),
+                                            kat.ct.data(),
+                                            mlen);
+
+  std::fill(enc.begin(), enc.end(), 0);
+  std::memset(etag, 0, tlen);
+
+  isap_fanout::encrypt<p, s_b, s_k, s_e, s_h>(kat.key.data(),
+                                              kat.nonce.data(),
+                                              1,
+                                              kat.ad.data(),
+                                              kat.ad.size(),
+                                              kat.pt.data(),
+                                              mlen,
+                                              enc.data(),
+                                              etag);
+
+  ok &= std::memcmp(enc.data(), kat.ct.data(), mlen) == 0;
+  ok &= std::memcmp(etag, tag, tlen) == 0;
+
+  // fan-out encryption, for # -of recipients, which is not a multiple of
+  // group size, leaving lanes beyond last recipient, must match per-recipient
+  // encryption, where 0 -th recipient is the one of Known Answer Test
+  for (const size_t cnt : { size_t{ 3 }, size_t{ 9 } }) {
+    std::vector<uint8_t> keys(cnt * tlen);
+    std::vector<uint8_t> nonces(cnt * tlen);
+    std::vector<uint8_t> encs(cnt * mlen);
+    std::vector<uint8_t> tags(cnt * tlen);
+
+    for (size_t i = 0; i < cnt; i++) {
+      std::memcpy(keys.data() + i * tlen, kat.key.data(), tlen);
+      std::memcpy(nonces.data() + i * tlen, kat.nonce.data(), tlen);
+
+      keys[i * tlen] ^= static_cast<uint8_t>(i);
+      nonces[i * tlen + tlen - 1] ^= static_cast<uint8_t>(i);
+    }
+
+    isap_fanout::encrypt<p, s_b, s_k, s_e, s_h>(keys.data(),
+                                                nonces.data(),
+                                                cnt,
+                                                kat.ad.data(),
+                                                kat.ad.size(),
+                                                kat.pt.data(),
+                                                mlen,
+                                                encs.data(),
+                                                tags.data());
+
+    ok &= std::memcmp(encs.data(), kat.ct.data(), mlen) == 0;
+    ok &= std::memcmp(tags.data(), tag, tlen) == 0;
+
+    for (size_t i = 1; i < cnt; i++) {
+      isap::encrypt<p, s_b, s_k, s_e, s_h>(keys.data() + i * tlen,
+                                           nonces.data() + i * tlen,
+                                           kat.ad.data(),
+                                           kat.ad.size(),
+                                           kat.pt.data(),
+                                           enc.data(),
+                                           mlen,
+                                           etag);
+
+      ok &= std::memcmp(encs.data() + i * mlen, enc.data(), mlen) == 0;
+      ok &= std::memcmp(tags.data() + i * tlen, etag, tlen) == 0;
+    }
+  }
+
+  return ok;
+}
+
+// Checks that instrumentation counters of calling thread, after encrypting &
+// decrypting a few associated data & message lengths, match # -of permutation
+// rounds estimated by cost model, while resetting them zeroes every counter.
+// Without `ISAP_INSTRUMENT`, snapshots must stay zeroed. Returns boolean truth
+// value only when all counters match.
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static bool
+check_instr()
+{
+  using isap_instr::snapshot_t;
+
+  constexpr size_t LENS[]{ 0, 1, 8, 17, 18, 19, 64, 255 };
+  constexpr size_t pidx = static_cast<size_t>(p);
+  constexpr size_t tlen = isap_common::knt_len;
+
+  const snapshot_t zero{};
+
+  uint8_t key[tlen], nonce[tlen], tag[tlen];
+  std::memset(key, 0xa5, tlen);
+  std::memset(nonce, 0x5a, tlen);
+
+  std::vector<uint8_t> data(LENS[std::size(LENS) - 1], 0x0f);
+  std::vector<uint8_t> txt(data.size(), 0xf0);
+  std::vector<uint8_t> enc(txt.size());
+  std::vector<uint8_t> dec(txt.size());
+
+  bool ok = true;
+
+  for (const size_t dlen : LENS) {
+    for (const size_t mlen : LENS) {
+      const size_t rounds =
+        isap_instr::enabled
+          ? isap_cost::aead_rounds<p, s_b, s_k, s_e, s_h>(dlen, mlen)
+          : 0;
+
+      isap_instr::reset();
+
+      isap::encrypt<p, s_b, s_k, s_e, s_h>(
+        key, nonce, data.data(), dlen, txt.data(), enc.data(), mlen, tag);
+
+      snapshot_t snap = isap_instr::thread_snapshot();
+      ok &= snap.perm_rounds[pidx] == rounds;
+      ok &= snap.perm_rounds[pidx ^ 1] == 0;
+      ok &= snap.squeezed[1] == (isap_instr::enabled ? mlen : 0);
+
+      ok &= isap::decrypt<p, s_b, s_k, s_e, s_h>(
+        key, nonce, tag, data.data(), dlen, enc.data(), dec.data(), mlen);
+
+      snap = isap_instr::thread_snapshot();
+      ok &= snap.perm_rounds[pidx] == rounds * 2;
+
+      // single threaded, so that process-wide counters are same
+      const snapshot_t all = isap_instr::snapshot();
+      ok &= std::memcmp(&all, &snap, sizeof(snap)) == 0;
+
+      if constexpr (isap_instr::latency_enabled) {
+        for (size_t o = 0; o < 2; o++) {
+          uint64_t calls = 0;
+          for (size_t i = 0; i < isap_instr::HIST_BUCKETS; i++) {
+            calls += snap.latency[o][i];
+          }
+          ok &= calls == 1;
+        }
+      }
+
+      isap_instr::reset();
+      snap = isap_instr::thread_snapshot();
+      ok &= std::memcmp(&zero, &snap, sizeof(snap)) == 0;
+    }
+  }
+
+  return ok;
+}
+
+// ISAP instance, which can be chosen from command-line
+struct variant_t
+{
+  const char* name;
+  check_fn chk;
+  bool (*instr)();
+};
+
+static const variant_t VARIANTS[]{
+  { "a-128a",
+    check<perm_t::ASCON, 1, 12, 6, 12>,
+    check_instr<perm_t::ASCON, 1, 12, 6, 12> },
+  { "a-128",
+    check<perm_t::ASCON, 12, 12, 12, 12>,
+    check_instr<perm_t::ASCON, 12, 12, 12, 12> },
+  { "k-128a",
+    check<perm_t::KECCAK, 1, 8, 8, 16>,
+    check_instr<perm_t::KECCAK, 1, 8, 8, 16> },
+  { "k-128",
+    check<perm_t::KECCAK, 12, 12, 12, 20>,
+    check_instr<perm_t::KECCAK, 12, 12, 12, 20> },
+};
+
+// Parses N ( even ) hex characters as N / 2 -bytes, returning boolean truth
+// value only when well-formed
+static bool
+parse_hex(const char* const str, std::vector<uint8_t>& bytes)
+{
+  const size_t len = std::strlen(str);
+  if (len & 1) {
+    return false;
+  }
+
+  auto nibble = [](const char c) -> int {
+    if (c >= '0' && c <= '9') {
+      return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+      return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+      return c - 'A' + 10;
+    }
+    return -1;
+  };
+
+  bytes.resize(len >> 1);
+  for (size_t i = 0; i < bytes.size(); i++) {
+    const int hi = nibble(str[i << 1]);
+    const int lo = nibble(str[(i << 1) + 1]);
+    if (hi < 0 || lo < 0) {
+      return false;
+    }
+    bytes[i] = static_cast<uint8_t>((hi << 4) | lo);
+  }
+  return true;
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc != 3) {
+    std::fprintf(stderr, "Usage: %s a-128a|a-128|k-128a|k-128 KAT\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  const variant_t* var = nullptr;
+  for (const auto& v : VARIANTS) {
+    if (std::strcmp(v.name, argv[1]) == 0) {
+      var = &v;
+    }
+  }
+  if (var == nullptr) {
+    std::fprintf(stderr, "unknown variant: %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  FILE* const fd = std::fopen(argv[2], "r");
+  if (fd == nullptr) {
+    std::fprintf(stderr, "%s: can't open\n", argv[2]);
+    return EXIT_FAILURE;
+  }
+
+  kat_t kat;
+  size_t passed = 0, failed = 0;
+  bool ok = true;
+  char line[4096];
+
+  // each test is a run of `Name = value` lines, ending with cipher text
+  while (ok && std::fgets(line, sizeof(line), fd) != nullptr) {
+    line[std::strcspn(line, "\r\n")] = '\0';
+    if (line[0] == '\0') {
+      continue;
+    }
+
+    char* const eq = std::strchr(line, '=');
+    if (eq == nullptr) {
+      ok = false;
+      break;
+    }
+
+    const char* val = eq + 1;
+    while (*val == ' ') {
+      val++;
+    }
+
+    const size_t nlen = std::strcspn(line, " =");
+    auto is = [&](const char* const name) {
+      return nlen == std::strlen(name) && std::strncmp(line, name, nlen) == 0;
+    };
+
+    if (is("Count")) {
+      kat.count = std::strtoull(val, nullptr, 10);
+    } else if (is("Key")) {
+      ok = parse_hex(val, kat.key);
+    } else if (is("Nonce")) {
+      ok = parse_hex(val, kat.nonce);
+    } else if (is("PT")) {
+      ok = parse_hex(val, kat.pt);
+    } else if (is("AD")) {
+      ok = parse_hex(val, kat.ad);
+    } else if (is("CT")) {
+      ok = parse_hex(val, kat.ct);
+
+      if (ok && var->chk(kat)) {
+        passed++;
+      } else if (ok) {
+        std::fprintf(
+          stderr, "%s: Count = %" PRIu64 " failed\n", argv[1], kat.count);
+        failed++;
+      }
+    }
+  }
+
+  std::fclose(fd);
+
+  if (!ok) {
+    std::fprintf(stderr, "%s: malformed Known Answer Test file\n", argv[2]);
+    return EXIT_FAILURE;
+  }
+
+  std::printf("%s: %zu passed, %zu failed\n", argv[1], passed, failed);
+
+  const bool instr = var->instr();
+  const char* const res = isap_instr::enabled ? "match" : "disabled";
+  std::printf(
+    "%s: instrumentation counters %s\n", argv[1], instr ? res : "mismatch");
+
+  return (failed == 0 && passed > 0 && instr) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
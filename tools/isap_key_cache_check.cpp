@@ -0,0 +1,162 @@
+#include "check.hpp"
+#include "key_cache.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Command-line checker of key context cache ( see include/key_cache.hpp ),
+// which checks that cached key contexts match freshly derived ones, misses
+// load secret key only once, invalidation makes next lookup load rotated
+// secret key, even when invalidation races with a miss, which has already
+// loaded old secret key, while unknown tenants are never cached. That race is
+// staged deterministically, by rotating & invalidating from within key loader.
+//
+// Build it with
+//
+// make tools/isap-key-cache-check
+//
+// and run it as
+//
+// ./tools/isap-key-cache-check
+
+using isap_common::perm_t;
+using isap_check::report;
+using isap_check::result_t;
+
+// Checks key context cache of ISAP instance, chosen by template parameters
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+check(result_t& res)
+{
+  using cache_t = isap_key_cache::cache_t<p, s_b, s_k, s_e, s_h>;
+  using ctx_t = typename cache_t::ctx_t;
+
+  constexpr uint64_t TENANTS = 256;
+  constexpr uint64_t UNKNOWN = TENANTS;
+
+  // secret key of tenant depends on its version, bumped on rotation
+  uint64_t version[TENANTS]{};
+  size_t loads = 0;
+
+  auto key_of = [&](const uint64_t tenant, uint8_t* const key) {
+    const uint64_t w0 = isap_key_cache::mix(tenant);
+    const uint64_t w1 = isap_key_cache::mix(w0 ^ version[tenant]);
+
+    std::memcpy(key, &w0, 8);
+    std::memcpy(key + 8, &w1, 8);
+  };
+
+  auto load = [&](const uint64_t tenant, uint8_t* const key) {
+    loads++;
+    if (tenant >= TENANTS) {
+      return false;
+    }
+
+    key_of(tenant, key);
+    return true;
+  };
+
+  // checks that key context matches one freshly derived from current key
+  auto fresh = [&](const uint64_t tenant, const ctx_t& ctx) {
+    uint8_t key[isap_common::knt_len];
+    key_of(tenant, key);
+
+    const ctx_t want{ key };
+    return std::memcmp(&want, &ctx, sizeof(ctx)) == 0;
+  };
+
+  // spare capacity, so that few sets overflow
+  cache_t cache(TENANTS * 4);
+  ctx_t ctx;
+
+  // --- misses load secret key once, while hits return same key context ---
+  for (uint64_t t = 0; t < TENANTS; t++) {
+    loads = 0;
+    res.check(cache.get(t, ctx, load) && fresh(t, ctx) && loads == 1);
+  }
+
+  res.check(cache.stats().misses == TENANTS);
+
+  size_t hits = 0;
+  for (uint64_t t = 0; t < TENANTS; t++) {
+    loads = 0;
+    res.check(cache.get(t, ctx, load) && fresh(t, ctx));
+    hits += loads == 0;
+  }
+  res.check(hits > TENANTS * 3 / 4);
+  res.check(cache.stats().hits == hits);
+
+  // --- unknown tenants are never cached ---
+  for (size_t i = 0; i < 2; i++) {
+    loads = 0;
+    res.check(!cache.get(UNKNOWN, ctx, load) && loads == 1);
+  }
+
+  // --- invalidation, after rotating secret key, makes next lookup load it ---
+  {
+    const uint64_t t = 7;
+
+    loads = 0;
+    res.check(cache.get(t, ctx, load) && loads <= 1);
+
+    version[t]++;
+    cache.invalidate(t);
+
+    loads = 0;
+    res.check(cache.get(t, ctx, load) && fresh(t, ctx) && loads == 1);
+
+    loads = 0;
+    res.check(cache.get(t, ctx, load) && fresh(t, ctx) && loads == 0);
+  }
+
+  // --- invalidation, racing with a miss which has already loaded old secret
+  // key, keeps stale key context from being inserted ---
+  {
+    const uint64_t t = 11;
+
+    version[t]++;
+    cache.invalidate(t);
+
+    // key is rotated & invalidated, right after miss loaded old one
+    auto racing = [&](const uint64_t tenant, uint8_t* const key) {
+      const bool ok = load(tenant, key);
+
+      version[tenant]++;
+      cache.invalidate(tenant);
+      return ok;
+    };
+
+    loads = 0;
+    res.check(cache.get(t, ctx, racing) && loads == 1);
+    res.check(!fresh(t, ctx)); // derived from old key, but not inserted
+
+    loads = 0;
+    res.check(cache.get(t, ctx, load) && fresh(t, ctx) && loads == 1);
+
+    loads = 0;
+    res.check(cache.get(t, ctx, load) && fresh(t, ctx) && loads == 0);
+  }
+}
+
+int
+main()
+{
+  result_t a_128a, a_128, k_128a, k_128;
+
+  check<perm_t::ASCON, 1, 12, 6, 12>(a_128a);
+  check<perm_t::ASCON, 12, 12, 12, 12>(a_128);
+  check<perm_t::KECCAK, 1, 8, 8, 16>(k_128a);
+  check<perm_t::KECCAK, 12, 12, 12, 20>(k_128);
+
+  bool ok = true;
+  ok &= report("a-128a key cache", a_128a);
+  ok &= report("a-128 key cache", a_128);
+  ok &= report("k-128a key cache", k_128a);
+  ok &= report("k-128 key cache", k_128);
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,238 @@
+#include "check.hpp"
+#include "key_store.hpp"
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+// Command-line checker of key context store ( see include/key_store.hpp ),
+// which writes stores for each ISAP variant & checks that opened store holds
+// key contexts matching freshly derived ones, while store file is readable
+// only by its owner, no matter what umask is, & concurrent writers of same
+// path never leave a torn store or temporary files behind. Stores written by a
+// build keeping key contexts in another layout must be rejected.
+//
+// Build it with
+//
+// make tools/isap-key-store-check
+//
+// and run it as
+//
+// ./tools/isap-key-store-check [directory]
+//
+// where stores are written to given directory ( defaults to /tmp ).
+
+using isap_common::perm_t;
+using isap_check::report;
+using isap_check::result_t;
+
+// # -of directory entries, whose name starts with given prefix
+static size_t
+count_prefixed(const std::string& dir, const std::string& prefix)
+{
+  DIR* const d = opendir(dir.c_str());
+  if (d == nullptr) {
+    return 0;
+  }
+
+  size_t n = 0;
+  for (dirent* e = readdir(d); e != nullptr; e = readdir(d)) {
+    n += std::strncmp(e->d_name, prefix.c_str(), prefix.size()) == 0;
+  }
+
+  closedir(d);
+  return n;
+}
+
+// Checks key context store of ISAP instance, chosen by template parameters
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+check(result_t& res, const std::string& dir, const char* const name)
+{
+  using store_t = isap_key_store::store_t<p, s_b, s_k, s_e, s_h>;
+  using ctx_t = typename store_t::ctx_t;
+
+  constexpr size_t N = 64;
+  constexpr size_t WRITERS = 8;
+
+  const std::string file = std::string("isap_key_store_check_") + name;
+  const std::string path = dir + "/" + file;
+
+  std::vector<uint64_t> tenants(N);
+  std::vector<uint8_t> keys(N * isap_common::knt_len);
+
+  for (size_t i = 0; i < N; i++) {
+    tenants[i] = (N - i) * 0x9e3779b97f4a7c15ul;
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    keys[i] = static_cast<uint8_t>(i * 31 + 7);
+  }
+
+  // checks that store at path holds key contexts of all tenants
+  auto holds_all = [&]() {
+    store_t store;
+    if (!store.open(path.c_str()) || store.size() != N || !store.verify_all()) {
+      return false;
+    }
+
+    for (size_t i = 0; i < N; i++) {
+      const ctx_t want{ keys.data() + i * isap_common::knt_len };
+      const ctx_t* const got = store.find(tenants[i]);
+
+      if (got == nullptr || std::memcmp(got, &want, sizeof(want)) != 0) {
+        return false;
+      }
+    }
+    return store.find(0) == nullptr;
+  };
+
+  std::remove(path.c_str());
+
+  // --- store holds all key contexts, readable only by owner, even under
+  // permissive umask ---
+  {
+    const mode_t mask = umask(0);
+    const bool ok =
+      store_t::write(path.c_str(), tenants.data(), keys.data(), N);
+    umask(mask);
+
+    res.check(ok);
+    res.check(holds_all());
+
+    struct stat sb;
+    res.check(stat(path.c_str(), &sb) == 0 && (sb.st_mode & 0777) == 0600);
+    res.check(count_prefixed(dir, file) == 1);
+  }
+
+  // --- duplicate tenants are rejected, leaving existing store untouched ---
+  {
+    std::vector<uint64_t> dup = tenants;
+    dup[N - 1] = dup[0];
+
+    res.check(!store_t::write(path.c_str(), dup.data(), keys.data(), N));
+    res.check(holds_all());
+  }
+
+  // --- stores written by a build of another context layout ( say,
+  // bit-interleaved Ascon-p state ) or of older version are rejected ---
+  {
+    const std::string forged = path + "_forged";
+
+    // copies store, overwriting 32 -bit header field at given offset, while
+    // keeping header checksum intact, so that only that field mismatches
+    auto forge = [&](const size_t off, const uint32_t v) {
+      std::vector<uint8_t> buf;
+      {
+        FILE* const fd = std::fopen(path.c_str(), "rb");
+        if (fd == nullptr) {
+          return false;
+        }
+
+        uint8_t chunk[4096];
+        size_t n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), fd)) > 0) {
+          buf.insert(buf.end(), chunk, chunk + n);
+        }
+        std::fclose(fd);
+      }
+
+      if (buf.size() < isap_key_store::HDR_LEN) {
+        return false;
+      }
+
+      constexpr size_t sum_off = offsetof(isap_key_store::header_t, checksum);
+
+      std::memcpy(buf.data() + off, &v, sizeof(v));
+      const uint64_t sum = isap_key_store::checksum(buf.data(), sum_off);
+      std::memcpy(buf.data() + sum_off, &sum, sizeof(sum));
+
+      FILE* const fd = std::fopen(forged.c_str(), "wb");
+      if (fd == nullptr) {
+        return false;
+      }
+
+      bool ok = std::fwrite(buf.data(), 1, buf.size(), fd) == buf.size();
+      ok &= std::fclose(fd) == 0;
+      return ok;
+    };
+
+    constexpr size_t layout_off = offsetof(isap_key_store::header_t, layout);
+    constexpr size_t version_off = offsetof(isap_key_store::header_t, version);
+    constexpr uint32_t layout = isap_key_store::ctx_layout<p>();
+
+    store_t store;
+
+    // unchanged header is still accepted
+    res.check(forge(layout_off, layout) && store.open(forged.c_str()));
+
+    res.check(forge(layout_off, layout ^ 1) && !store.open(forged.c_str()));
+    res.check(forge(version_off, 1) && !store.open(forged.c_str()));
+
+    std::remove(forged.c_str());
+  }
+
+  // --- unwritable directory fails cleanly ---
+  {
+    const std::string bad = dir + "/isap_key_store_check_missing/" + file;
+    res.check(!store_t::write(bad.c_str(), tenants.data(), keys.data(), N));
+  }
+
+  // --- concurrent writers of same path all succeed, leaving an intact store
+  // & no temporary files ---
+  {
+    bool oks[WRITERS]{};
+    std::vector<std::thread> writers;
+
+    for (size_t i = 0; i < WRITERS; i++) {
+      writers.emplace_back([&, i]() {
+        for (size_t j = 0; j < 8; j++) {
+          oks[i] = store_t::write(path.c_str(), tenants.data(), keys.data(), N);
+          if (!oks[i]) {
+            break;
+          }
+        }
+      });
+    }
+    for (auto& w : writers) {
+      w.join();
+    }
+
+    for (size_t i = 0; i < WRITERS; i++) {
+      res.check(oks[i]);
+    }
+    res.check(holds_all());
+    res.check(count_prefixed(dir, file) == 1);
+  }
+
+  std::remove(path.c_str());
+}
+
+int
+main(int argc, char** argv)
+{
+  const std::string dir = argc > 1 ? argv[1] : "/tmp";
+
+  result_t a_128a, a_128, k_128a, k_128;
+
+  check<perm_t::ASCON, 1, 12, 6, 12>(a_128a, dir, "a_128a");
+  check<perm_t::ASCON, 12, 12, 12, 12>(a_128, dir, "a_128");
+  check<perm_t::KECCAK, 1, 8, 8, 16>(k_128a, dir, "k_128a");
+  check<perm_t::KECCAK, 12, 12, 12, 20>(k_128, dir, "k_128");
+
+  bool ok = true;
+  ok &= report("a-128a key store", a_128a);
+  ok &= report("a-128 key store", a_128);
+  ok &= report("k-128a key store", k_128a);
+  ok &= report("k-128 key store", k_128);
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,234 @@
+#include "ascon.hpp"
+#include "check.hpp"
+#include "keccak.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <utility>
+
+// Command-line differential checker of permutation backends, which applies
+// each backend built in ( see include/ascon.hpp & include/keccak.hpp ), for
+// every # -of rounds ( >= 1 ), on random states & checks that result matches
+// reference implementation, reporting a pass/ fail count per backend. Being a
+// plain executable, it's also how backends of a cross-compiled target get
+// checked, say NEON ones under qemu-aarch64. When assembly Ascon-p backend is
+// linked in, both of its entry points are checked.
+//
+// Build it with
+//
+// make tools/isap-perm-check # or tools/isap-perm-check-aarch64, under qemu
+// make tools/isap-perm-check-asm # with assembly Ascon-p backend, on x86-64
+//
+// and run it as
+//
+// ./tools/isap-perm-check
+
+using isap_check::report;
+using isap_check::result_t;
+
+// # -of random states, each backend is checked on, for each # -of rounds
+constexpr size_t STATES = 256;
+
+// Fixed seed, so that a failure can be reproduced on any host
+static std::mt19937_64 gen(0x15a9);
+
+// Random Ascon-p state, as 64 -bit words
+static ascon::state
+random_ascon()
+{
+  ascon::state s;
+  for (size_t i = 0; i < 5; i++) {
+    s[i] = gen();
+  }
+  return s;
+}
+
+// Random Keccak-p[400] state
+static keccak::state400
+random_keccak()
+{
+  keccak::state400 s;
+  for (size_t i = 0; i < 25; i++) {
+    s[i] = static_cast<uint16_t>(gen());
+  }
+  return s;
+}
+
+// Checks Ascon-p backends, for ROUNDS -many rounds, against `ascon::permute`
+template<const size_t ROUNDS>
+static void
+check_ascon(result_t& bi, result_t& sel, result_t& x2)
+{
+  for (size_t k = 0; k < STATES; k++) {
+    ascon::state st[ascon::state_x2::LANES];
+    ascon::state ref[ascon::state_x2::LANES];
+    for (size_t j = 0; j < ascon::state_x2::LANES; j++) {
+      st[j] = random_ascon();
+      ref[j] = st[j];
+      ascon::permute<ROUNDS>(ref[j].w);
+    }
+
+    // bit-interleaved backend, no matter whether it's selected
+    uint64_t w[5];
+    for (size_t i = 0; i < 5; i++) {
+      w[i] = ascon::interleave(st[0][i]);
+    }
+    ascon::permute_bi<ROUNDS>(w);
+
+    bool ok = true;
+    for (size_t i = 0; i < 5; i++) {
+      ok &= ascon::deinterleave(w[i]) == ref[0][i];
+    }
+    bi.check(ok);
+
+    // selected backend, working on state as kept in sponge
+    ascon::state s;
+    for (size_t i = 0; i < 5; i++) {
+      s[i] = ascon::state::pack(st[0][i]);
+    }
+    s.permute<ROUNDS>();
+
+    ok = true;
+    for (size_t i = 0; i < 5; i++) {
+      ok &= ascon::state::unpack(s[i]) == ref[0][i];
+    }
+    sel.check(ok);
+
+    // multi-state backend
+    ascon::state_x2 m;
+    for (size_t j = 0; j < ascon::state_x2::LANES; j++) {
+      for (size_t i = 0; i < 5; i++) {
+        s[i] = ascon::state::pack(st[j][i]);
+      }
+      m.insert(j, s);
+    }
+    m.permute<ROUNDS>();
+
+    ok = true;
+    for (size_t j = 0; j < ascon::state_x2::LANES; j++) {
+      s = m.extract(j);
+      for (size_t i = 0; i < 5; i++) {
+        ok &= ascon::state::unpack(s[i]) == ref[j][i];
+      }
+    }
+    x2.check(ok);
+  }
+}
+
+#if ISAP_ASCON_ASM
+
+// Checks both baseline & BMI2 entry points of assembly Ascon-p backend, for
+// ROUNDS -many rounds, against `ascon::permute`, no matter which one is
+// selected at runtime. BMI2 one is checked only when CPU supports it.
+template<const size_t ROUNDS>
+static void
+check_ascon_asm(result_t& base, result_t& bmi2, const bool has_bmi2)
+{
+  constexpr size_t blen = sizeof(ascon::state);
+
+  for (size_t k = 0; k < STATES; k++) {
+    const ascon::state st = random_ascon();
+
+    ascon::state ref = st;
+    ascon::permute<ROUNDS>(ref.w);
+
+    ascon::state s = st;
+    ascon::isap_ascon_permute_x86_64(s.w, ROUNDS);
+    base.check(std::memcmp(s.w, ref.w, blen) == 0);
+
+    if (has_bmi2) {
+      s = st;
+      ascon::isap_ascon_permute_x86_64_bmi2(s.w, ROUNDS);
+      bmi2.check(std::memcmp(s.w, ref.w, blen) == 0);
+    }
+  }
+}
+
+#endif
+
+// Checks Keccak-p[400] backends, for ROUNDS -many rounds, against
+// `keccak::permute_ref`
+template<const size_t ROUNDS>
+static void
+check_keccak(result_t& wide, result_t& sel, result_t& x8)
+{
+  constexpr size_t lanes = keccak::state400_x8::LANES;
+  constexpr size_t blen = sizeof(keccak::state400);
+
+  for (size_t k = 0; k < STATES; k++) {
+    keccak::state400 st[lanes];
+    keccak::state400 ref[lanes];
+    for (size_t j = 0; j < lanes; j++) {
+      st[j] = random_keccak();
+      ref[j] = st[j];
+      keccak::permute_ref<ROUNDS>(ref[j].w);
+    }
+
+    // widened lanes backend, no matter whether it's selected
+    keccak::state400 s = st[0];
+    keccak::permute_wide<ROUNDS>(s.w);
+    wide.check(std::memcmp(s.w, ref[0].w, blen) == 0);
+
+    // selected backend
+    s = st[0];
+    s.permute<ROUNDS>();
+    sel.check(std::memcmp(s.w, ref[0].w, blen) == 0);
+
+    // multi-state backend
+    keccak::state400_x8 m;
+    for (size_t j = 0; j < lanes; j++) {
+      m.insert(j, st[j]);
+    }
+    m.permute<ROUNDS>();
+
+    bool ok = true;
+    for (size_t j = 0; j < lanes; j++) {
+      s = m.extract(j);
+      ok &= std::memcmp(s.w, ref[j].w, blen) == 0;
+    }
+    x8.check(ok);
+  }
+}
+
+int
+main()
+{
+  result_t a_bi, a_sel, a_x2;
+  [&]<size_t... R>(std::index_sequence<R...>) {
+    (check_ascon<R + 1>(a_bi, a_sel, a_x2), ...);
+  }(std::make_index_sequence<ascon::MAX_ROUNDS>{});
+
+#if ISAP_ASCON_ASM
+  const bool has_bmi2 =
+    ascon::select_permute_asm() == ascon::isap_ascon_permute_x86_64_bmi2;
+
+  result_t a_asm, a_bmi2;
+  [&]<size_t... R>(std::index_sequence<R...>) {
+    (check_ascon_asm<R + 1>(a_asm, a_bmi2, has_bmi2), ...);
+  }(std::make_index_sequence<ascon::MAX_ROUNDS>{});
+#endif
+
+  result_t k_wide, k_sel, k_x8;
+  [&]<size_t... R>(std::index_sequence<R...>) {
+    (check_keccak<R + 1>(k_wide, k_sel, k_x8), ...);
+  }(std::make_index_sequence<keccak::MAX_ROUNDS>{});
+
+  bool ok = true;
+  ok &= report("ascon-p bit-interleaved", a_bi);
+  ok &= report("ascon-p selected", a_sel);
+  ok &= report("ascon-p multi-state", a_x2);
+#if ISAP_ASCON_ASM
+  ok &= report("ascon-p assembly", a_asm);
+  if (has_bmi2) {
+    ok &= report("ascon-p assembly ( BMI2 )", a_bmi2);
+  } else {
+    std::printf("ascon-p assembly ( BMI2 ): skipped, CPU lacks BMI1/ BMI2\n");
+  }
+#endif
+  ok &= report("keccak-p[400] wide", k_wide);
+  ok &= report("keccak-p[400] selected", k_sel);
+  ok &= report("keccak-p[400] multi-state", k_x8);
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,247 @@
+#include "check.hpp"
+#include "record.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Command-line checker of zero-copy record layer ( see include/record.hpp ),
+// which seals records using each ISAP variant & checks that opener recovers
+// payload & type, while rejecting duplicate, too old or tampered records,
+// along with records sealed under another key or IV. Out of order records,
+// within replay window, must be accepted exactly once. Payloads & shuffles are
+// drawn from a fixed seed, so that a failing run can be replayed as is.
+//
+// Build it with
+//
+// make tools/isap-record-check
+//
+// and run it as
+//
+// ./tools/isap-record-check
+
+using isap_common::perm_t;
+using isap_check::report;
+using isap_check::result_t;
+
+// Fixed seed, so that a failure can be reproduced on any host
+static std::mt19937_64 gen(0x5ea1);
+
+// Fills buffer with random bytes
+static void
+random_bytes(uint8_t* const bytes, const size_t len)
+{
+  for (size_t i = 0; i < len; i++) {
+    bytes[i] = static_cast<uint8_t>(gen());
+  }
+}
+
+// Checks sealer & opener of ISAP instance, chosen by template parameters
+template<const perm_t p,
+         const size_t s_b,
+         const size_t s_k,
+         const size_t s_e,
+         const size_t s_h>
+static void
+check(result_t& res)
+{
+  using namespace isap_record;
+  using sealer = sealer_t<p, s_b, s_k, s_e, s_h>;
+  using opener = opener_t<p, s_b, s_k, s_e, s_h>;
+  using record = std::vector<uint8_t>;
+
+  constexpr size_t LENS[]{ 0, 1, 7, 8, 17, 18, 19, 255, 1500, MAX_PAYLOAD };
+
+  uint8_t key[TAG_LEN], iv[TAG_LEN];
+  random_bytes(key, sizeof(key));
+  random_bytes(iv, sizeof(iv));
+
+  sealer tx;
+  tx.init(key, iv);
+
+  // seals N -bytes random payload of given type, as next record
+  std::vector<uint8_t> txt;
+  auto seal = [&](const size_t plen, const uint8_t type) {
+    record rec(plen + OVERHEAD);
+    txt.resize(plen);
+    random_bytes(txt.data(), plen);
+
+    std::memcpy(rec.data() + HDR_LEN, txt.data(), plen);
+    res.check(tx.seal(rec.data(), plen, type) == rec.size());
+    return rec;
+  };
+
+  // opens copy of record, returning boolean truth value only when accepted
+  auto open = [](opener& rx, const record& rec, record* const out = nullptr) {
+    record buf = rec;
+    size_t plen = 0;
+    uint8_t type = 0;
+
+    const bool ok = rx.open(buf.data(), buf.size(), plen, type);
+    if (ok && out != nullptr) {
+      out->assign(buf.begin() + HDR_LEN, buf.begin() + HDR_LEN + plen);
+      out->push_back(type);
+    }
+    return ok;
+  };
+
+  // --- in order records recover payload & type, while duplicates are
+  // rejected ---
+  {
+    opener rx;
+    rx.init(key, iv);
+
+    for (const size_t plen : LENS) {
+      const uint8_t type = static_cast<uint8_t>(plen);
+      const record rec = seal(plen, type);
+
+      record out;
+      res.check(open(rx, rec, &out));
+
+      txt.push_back(type);
+      res.check(out == txt);
+      res.check(!open(rx, rec));
+    }
+  }
+
+  // --- too long payload isn't sealed, leaving buffer untouched ---
+  {
+    record rec(MAX_PAYLOAD + 1 + OVERHEAD, 0xa5);
+    const uint64_t seq = tx.seq;
+
+    res.check(tx.seal(rec.data(), MAX_PAYLOAD + 1, 0) == 0);
+    res.check(std::all_of(
+      rec.begin(), rec.end(), [](const uint8_t b) { return b == 0xa5; }));
+    res.check(tx.seq == seq);
+  }
+
+  // --- out of order records within replay window are accepted once, while
+  // records older than window are rejected ---
+  {
+    tx.init(key, iv);
+
+    std::vector<record> recs;
+    for (size_t i = 0; i < 2 * REPLAY_WINDOW; i++) {
+      recs.push_back(seal(i % 32, 0x17));
+    }
+
+    opener rx;
+    rx.init(key, iv);
+
+    // shuffled first window
+    std::vector<size_t> order(REPLAY_WINDOW);
+    for (size_t i = 0; i < order.size(); i++) {
+      order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), gen);
+
+    for (const size_t i : order) {
+      res.check(open(rx, recs[i]));
+    }
+    for (const size_t i : order) {
+      res.check(!open(rx, recs[i]));
+    }
+
+    // jump ahead on a fresh opener, leaving a gap, which can still be filled
+    // within window, while never seen records older than window are rejected
+    const size_t last = 2 * REPLAY_WINDOW - 1;
+    const size_t oldest = last - (REPLAY_WINDOW - 1);
+
+    rx.init(key, iv);
+    res.check(open(rx, recs[last]));
+
+    res.check(!open(rx, recs[oldest - 1])); // too old
+    res.check(!open(rx, recs[0]));          // too old
+    res.check(open(rx, recs[oldest]));      // oldest tracked
+    res.check(open(rx, recs[last - 1]));
+    res.check(!open(rx, recs[oldest]));
+    res.check(!open(rx, recs[last - 1]));
+    res.check(!open(rx, recs[last]));
+  }
+
+  // --- tampered records are rejected, without sliding replay window ---
+  {
+    tx.init(key, iv);
+    const record rec = seal(33, 0x17);
+
+    opener rx;
+    rx.init(key, iv);
+
+    // type, version, payload length, sequence number, payload & tag
+    for (size_t off = 0; off < rec.size(); off++) {
+      for (const uint8_t bit : { 0x01, 0x80 }) {
+        record bad = rec;
+        bad[off] ^= bit;
+        res.check(!open(rx, bad));
+      }
+    }
+
+    // truncated or extended records
+    res.check(!open(rx, record(rec.begin(), rec.end() - 1)));
+    res.check(!open(rx, record(rec.begin(), rec.begin() + OVERHEAD - 1)));
+
+    record ext = rec;
+    ext.push_back(0);
+    res.check(!open(rx, ext));
+
+    // none of them touched replay window
+    res.check(rx.top == 0 && rx.bitmap == 0);
+    res.check(open(rx, rec));
+  }
+
+  // --- records sealed under another key or IV are rejected ---
+  {
+    tx.init(key, iv);
+    const record rec = seal(64, 0x17);
+
+    uint8_t key_[TAG_LEN], iv_[TAG_LEN];
+    std::memcpy(key_, key, sizeof(key));
+    std::memcpy(iv_, iv, sizeof(iv));
+    key_[0] ^= 1;
+    iv_[TAG_LEN - 1] ^= 1;
+
+    opener rx;
+
+    rx.init(key_, iv);
+    res.check(!open(rx, rec));
+
+    rx.init(key, iv_);
+    res.check(!open(rx, rec));
+  }
+
+  // --- sequence numbers are never reused, once exhausted ---
+  {
+    tx.init(key, iv);
+    tx.seq = UINT64_MAX - 1;
+    const record rec = seal(16, 0x17);
+
+    record full(16 + OVERHEAD);
+    res.check(tx.seal(full.data(), 16, 0x17) == 0);
+
+    opener rx;
+    rx.init(key, iv);
+    res.check(open(rx, rec));
+    res.check(!open(rx, rec));
+  }
+}
+
+int
+main()
+{
+  result_t a_128a, a_128, k_128a, k_128;
+
+  check<perm_t::ASCON, 1, 12, 6, 12>(a_128a);
+  check<perm_t::ASCON, 12, 12, 12, 12>(a_128);
+  check<perm_t::KECCAK, 1, 8, 8, 16>(k_128a);
+  check<perm_t::KECCAK, 12, 12, 12, 20>(k_128);
+
+  bool ok = true;
+  ok &= report("a-128a record layer", a_128a);
+  ok &= report("a-128 record layer", a_128);
+  ok &= report("k-128a record layer", k_128a);
+  ok &= report("k-128 record layer", k_128);
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -2,6 +2,7 @@
 #include "isap_a_128a.hpp"
 #include "isap_k_128.hpp"
 #include "isap_k_128a.hpp"
+#include "instrument.hpp"
 
 // Thin C wrapper on top of underlying C++ implementation of ISAP authenticated
 // encryption with associated data ( AEAD ) functions, which can be used for
@@ -15,8 +16,8 @@ extern "C"
                            const uint8_t* const __restrict,
                            const uint8_t* const __restrict,
                            const size_t,
-                           const uint8_t* const __restrict,
-                           uint8_t* const __restrict,
+                           const uint8_t* const,
+                           uint8_t* const,
                            const size_t,
                            uint8_t* const __restrict);
 
@@ -25,16 +26,16 @@ extern "C"
                            const uint8_t* const __restrict,
                            const uint8_t* const __restrict,
                            const size_t,
-                           const uint8_t* const __restrict,
-                           uint8_t* const __restrict,
+                           const uint8_t* const,
+                           uint8_t* const,
                            const size_t);
 
   void isap_a_128_encrypt(const uint8_t* const __restrict,
                           const uint8_t* const __restrict,
                           const uint8_t* const __restrict,
                           const size_t,
-                          const uint8_t* const __restrict,
-                          uint8_t* const __restrict,
+                          const uint8_t* const,
+                          uint8_t* const,
                           const size_t,
                           uint8_t* const __restrict);
 
@@ -43,16 +44,16 @@ extern "C"
                           const uint8_t* const __restrict,
                           const uint8_t* const __restrict,
                           const size_t,
-                          const uint8_t* const __restrict,
-                          uint8_t* const __restrict,
+                          const uint8_t* const,
+                          uint8_t* const,
                           const size_t);
 
   void isap_k_128a_encrypt(const uint8_t* const __restrict,
                            const uint8_t* const __restrict,
                            const uint8_t* const __restrict,
                            const size_t,
-                           const uint8_t* const __restrict,
-                           uint8_t* const __restrict,
+                           const uint8_t* const,
+                           uint8_t* const,
                            const size_t,
                            uint8_t* const __restrict);
 
@@ -61,27 +62,107 @@ extern "C"
                            const uint8_t* const __restrict,
                            const uint8_t* const __restrict,
                            const size_t,
-                           const uint8_t* const __restrict,
-                           uint8_t* const __restrict,
+                           const uint8_t* const,
+                           uint8_t* const,
                            const size_t);
 
   void isap_k_128_encrypt(const uint8_t* const __restrict,
                           const uint8_t* const __restrict,
                           const uint8_t* const __restrict,
                           const size_t,
-                          const uint8_t* const __restrict,
-                          uint8_t* const __restrict,
+                          const uint8_t* const,
+                          uint8_t* const,
                           const size_t,
                           uint8_t* const __restrict);
 
   bool isap_k_128_decrypt(const uint8_t* const __restrict,
+                          const uint8_t* const __restrict,
+                          const uint8_t* const __restrict,
+                          const uint8_t* const __restrict,
+                          const size_t,
+                          const uint8_t* const,
+                          uint8_t* const,
+                          const size_t);
+
+  bool isap_a_128a_verify(const uint8_t* const __restrict,
                           const uint8_t* const __restrict,
                           const uint8_t* const __restrict,
                           const uint8_t* const __restrict,
                           const size_t,
                           const uint8_t* const __restrict,
-                          uint8_t* const __restrict,
                           const size_t);
+
+  size_t isap_a_128a_verify_batch(const uint8_t* const __restrict,
+                                  const uint8_t* const __restrict,
+                                  const uint8_t* const __restrict,
+                                  const uint8_t* const __restrict,
+                                  const size_t* const __restrict,
+                                  const uint8_t* const __restrict,
+                                  const size_t* const __restrict,
+                                  const size_t,
+                                  bool* const __restrict);
+
+  bool isap_a_128_verify(const uint8_t* const __restrict,
+                         const uint8_t* const __restrict,
+                         const uint8_t* const __restrict,
+                         const uint8_t* const __restrict,
+                         const size_t,
+                         const uint8_t* const __restrict,
+                         const size_t);
+
+  size_t isap_a_128_verify_batch(const uint8_t* const __restrict,
+                                 const uint8_t* const __restrict,
+                                 const uint8_t* const __restrict,
+                                 const uint8_t* const __restrict,
+                                 const size_t* const __restrict,
+                                 const uint8_t* const __restrict,
+                                 const size_t* const __restrict,
+                                 const size_t,
+                                 bool* const __restrict);
+
+  bool isap_k_128a_verify(const uint8_t* const __restrict,
+                          const uint8_t* const __restrict,
+                          const uint8_t* const __restrict,
+                          const uint8_t* const __restrict,
+                          const size_t,
+                          const uint8_t* const __restrict,
+                          const size_t);
+
+  size_t isap_k_128a_verify_batch(const uint8_t* const __restrict,
+                                  const uint8_t* const __restrict,
+                                  const uint8_t* const __restrict,
+                                  const uint8_t* const __restrict,
+                                  const size_t* const __restrict,
+                                  const uint8_t* const __restrict,
+                                  const size_t* const __restrict,
+                                  const size_t,
+                                  bool* const __restrict);
+
+  bool isap_k_128_verify(const uint8_t* const __restrict,
+                         const uint8_t* const __restrict,
+                         const uint8_t* const __restrict,
+                         const uint8_t* const __restrict,
+                         const size_t,
+                         const uint8_t* const __restrict,
+                         const size_t);
+
+  size_t isap_k_128_verify_batch(const uint8_t* const __restrict,
+                                 const uint8_t* const __restrict,
+                                 const uint8_t* const __restrict,
+                                 const uint8_t* const __restrict,
+                                 const size_t* const __restrict,
+                                 const uint8_t* const __restrict,
+                                 const size_t* const __restrict,
+                                 const size_t,
+                                 bool* const __restrict);
+
+  bool isap_instr_enabled();
+
+  void isap_instr_snapshot(isap_instr::snapshot_t* const);
+
+  void isap_instr_thread_snapshot(isap_instr::snapshot_t* const);
+
+  void isap_instr_reset();
 }
 
 // Function implementation
@@ -94,8 +175,8 @@ extern "C"
                            const uint8_t* const __restrict nonce,
                            const uint8_t* const __restrict data,
                            const size_t d_len,
-                           const uint8_t* const __restrict txt,
-                           uint8_t* const __restrict enc,
+                           const uint8_t* const txt,
+                           uint8_t* const enc,
                            const size_t ct_len,
                            uint8_t* const __restrict tag)
   {
@@ -114,8 +195,8 @@ extern "C"
                            const uint8_t* const __restrict tag,
                            const uint8_t* const __restrict data,
                            const size_t d_len,
-                           const uint8_t* const __restrict enc,
-                           uint8_t* const __restrict dec,
+                           const uint8_t* const enc,
+                           uint8_t* const dec,
                            const size_t ct_len)
   {
     using namespace isap_a_128a;
@@ -129,8 +210,8 @@ extern "C"
                           const uint8_t* const __restrict nonce,
                           const uint8_t* const __restrict data,
                           const size_t d_len,
-                          const uint8_t* const __restrict txt,
-                          uint8_t* const __restrict enc,
+                          const uint8_t* const txt,
+                          uint8_t* const enc,
                           const size_t ct_len,
                           uint8_t* const __restrict tag)
   {
@@ -149,8 +230,8 @@ extern "C"
                           const uint8_t* const __restrict tag,
                           const uint8_t* const __restrict data,
                           const size_t d_len,
-                          const uint8_t* const __restrict enc,
-                          uint8_t* const __restrict dec,
+                          const uint8_t* const enc,
+                          uint8_t* const dec,
                           const size_t ct_len)
   {
     using namespace isap_a_128;
@@ -164,8 +245,8 @@ extern "C"
                            const uint8_t* const __restrict nonce,
                            const uint8_t* const __restrict data,
                            const size_t d_len,
-                           const uint8_t* const __restrict txt,
-                           uint8_t* const __restrict enc,
+                           const uint8_t* const txt,
+                           uint8_t* const enc,
                            const size_t ct_len,
                            uint8_t* const __restrict tag)
   {
@@ -184,8 +265,8 @@ extern "C"
                            const uint8_t* const __restrict tag,
                            const uint8_t* const __restrict data,
                            const size_t d_len,
-                           const uint8_t* const __restrict enc,
-                           uint8_t* const __restrict dec,
+                           const uint8_t* const enc,
+                           uint8_t* const dec,
                            const size_t ct_len)
   {
     using namespace isap_k_128a;
@@ -199,8 +280,8 @@ extern "C"
                           const uint8_t* const __restrict nonce,
                           const uint8_t* const __restrict data,
                           const size_t d_len,
-                          const uint8_t* const __restrict txt,
-                          uint8_t* const __restrict enc,
+                          const uint8_t* const txt,
+                          uint8_t* const enc,
                           const size_t ct_len,
                           uint8_t* const __restrict tag)
   {
@@ -219,11 +300,179 @@ extern "C"
                           const uint8_t* const __restrict tag,
                           const uint8_t* const __restrict data,
                           const size_t d_len,
-                          const uint8_t* const __restrict enc,
-                          uint8_t* const __restrict dec,
+                          const uint8_t* const enc,
+                          uint8_t* const dec,
                           const size_t ct_len)
   {
     using namespace isap_k_128;
     return decrypt(key, nonce, tag, data, d_len, enc, dec, ct_len);
   }
+
+  // Given 16 -bytes secret key, 16 -bytes nonce, 16 -bytes authentication tag,
+  // N -bytes cipher text & M -bytes associated data, this routine computes a
+  // boolean verification flag, without decrypting cipher text, using
+  // ISAP-A-128A algorithm | N, M >= 0
+  bool isap_a_128a_verify(const uint8_t* const __restrict key,
+                          const uint8_t* const __restrict nonce,
+                          const uint8_t* const __restrict tag,
+                          const uint8_t* const __restrict data,
+                          const size_t d_len,
+                          const uint8_t* const __restrict enc,
+                          const size_t ct_len)
+  {
+    return isap_a_128a::verify(key, nonce, tag, data, d_len, enc, ct_len);
+  }
+
+  // Given 16 -bytes secret key & K -many messages, whose 16 -bytes nonces, 16
+  // -bytes tags, associated data & cipher text are each concatenated ( with
+  // lengths of associated data & cipher text in `d_lens` & `ct_lens` ), this
+  // routine computes K boolean verification flags, returning # -of valid
+  // messages, using ISAP-A-128A algorithm | K >= 0
+  size_t isap_a_128a_verify_batch(const uint8_t* const __restrict key,
+                                  const uint8_t* const __restrict nonces,
+                                  const uint8_t* const __restrict tags,
+                                  const uint8_t* const __restrict data,
+                                  const size_t* const __restrict d_lens,
+                                  const uint8_t* const __restrict enc,
+                                  const size_t* const __restrict ct_lens,
+                                  const size_t cnt,
+                                  bool* const __restrict flags)
+  {
+    using namespace isap_a_128a;
+    return verify_batch(
+      key, nonces, tags, data, d_lens, enc, ct_lens, cnt, flags);
+  }
+
+  // Given 16 -bytes secret key, 16 -bytes nonce, 16 -bytes authentication tag,
+  // N -bytes cipher text & M -bytes associated data, this routine computes a
+  // boolean verification flag, without decrypting cipher text, using
+  // ISAP-A-128 algorithm | N, M >= 0
+  bool isap_a_128_verify(const uint8_t* const __restrict key,
+                         const uint8_t* const __restrict nonce,
+                         const uint8_t* const __restrict tag,
+                         const uint8_t* const __restrict data,
+                         const size_t d_len,
+                         const uint8_t* const __restrict enc,
+                         const size_t ct_len)
+  {
+    return isap_a_128::verify(key, nonce, tag, data, d_len, enc, ct_len);
+  }
+
+  // Given 16 -bytes secret key & K -many messages, whose 16 -bytes nonces, 16
+  // -bytes tags, associated data & cipher text are each concatenated ( with
+  // lengths of associated data & cipher text in `d_lens` & `ct_lens` ), this
+  // routine computes K boolean verification flags, returning # -of valid
+  // messages, using ISAP-A-128 algorithm | K >= 0
+  size_t isap_a_128_verify_batch(const uint8_t* const __restrict key,
+                                 const uint8_t* const __restrict nonces,
+                                 const uint8_t* const __restrict tags,
+                                 const uint8_t* const __restrict data,
+                                 const size_t* const __restrict d_lens,
+                                 const uint8_t* const __restrict enc,
+                                 const size_t* const __restrict ct_lens,
+                                 const size_t cnt,
+                                 bool* const __restrict flags)
+  {
+    using namespace isap_a_128;
+    return verify_batch(
+      key, nonces, tags, data, d_lens, enc, ct_lens, cnt, flags);
+  }
+
+  // Given 16 -bytes secret key, 16 -bytes nonce, 16 -bytes authentication tag,
+  // N -bytes cipher text & M -bytes associated data, this routine computes a
+  // boolean verification flag, without decrypting cipher text, using
+  // ISAP-K-128A algorithm | N, M >= 0
+  bool isap_k_128a_verify(const uint8_t* const __restrict key,
+                          const uint8_t* const __restrict nonce,
+                          const uint8_t* const __restrict tag,
+                          const uint8_t* const __restrict data,
+                          const size_t d_len,
+                          const uint8_t* const __restrict enc,
+                          const size_t ct_len)
+  {
+    return isap_k_128a::verify(key, nonce, tag, data, d_len, enc, ct_len);
+  }
+
+  // Given 16 -bytes secret key & K -many messages, whose 16 -bytes nonces, 16
+  // -bytes tags, associated data & cipher text are each concatenated ( with
+  // lengths of associated data & cipher text in `d_lens` & `ct_lens` ), this
+  // routine computes K boolean verification flags, returning # -of valid
+  // messages, using ISAP-K-128A algorithm | K >= 0
+  size_t isap_k_128a_verify_batch(const uint8_t* const __restrict key,
+                                  const uint8_t* const __restrict nonces,
+                                  const uint8_t* const __restrict tags,
+                                  const uint8_t* const __restrict data,
+                                  const size_t* const __restrict d_lens,
+                                  const uint8_t* const __restrict enc,
+                                  const size_t* const __restrict ct_lens,
+                                  const size_t cnt,
+                                  bool* const __restrict flags)
+  {
+    using namespace isap_k_128a;
+    return verify_batch(
+      key, nonces, tags, data, d_lens, enc, ct_lens, cnt, flags);
+  }
+
+  // Given 16 -bytes secret key, 16 -bytes nonce, 16 -bytes authentication tag,
+  // N -bytes cipher text & M -bytes associated data, this routine computes a
+  // boolean verification flag, without decrypting cipher text, using
+  // ISAP-K-128 algorithm | N, M >= 0
+  bool isap_k_128_verify(const uint8_t* const __restrict key,
+                         const uint8_t* const __restrict nonce,
+                         const uint8_t* const __restrict tag,
+                         const uint8_t* const __restrict data,
+                         const size_t d_len,
+                         const uint8_t* const __restrict enc,
+                         const size_t ct_len)
+  {
+    return isap_k_128::verify(key, nonce, tag, data, d_len, enc, ct_len);
+  }
+
+  // Given 16 -bytes secret key & K -many messages, whose 16 -bytes nonces, 16
+  // -bytes tags, associated data & cipher text are each concatenated ( with
+  // lengths of associated data & cipher text in `d_lens` & `ct_lens` ), this
+  // routine computes K boolean verification flags, returning # -of valid
+  // messages, using ISAP-K-128 algorithm | K >= 0
+  size_t isap_k_128_verify_batch(const uint8_t* const __restrict key,
+                                 const uint8_t* const __restrict nonces,
+                                 const uint8_t* const __restrict tags,
+                                 const uint8_t* const __restrict data,
+                                 const size_t* const __restrict d_lens,
+                                 const uint8_t* const __restrict enc,
+                                 const size_t* const __restrict ct_lens,
+                                 const size_t cnt,
+                                 bool* const __restrict flags)
+  {
+    using namespace isap_k_128;
+    return verify_batch(
+      key, nonces, tags, data, d_lens, enc, ct_lens, cnt, flags);
+  }
+
+  // Returns truth value, if shared library object was compiled with
+  // instrumentation enabled ( i.e. with `ISAP_INSTRUMENT` defined ), otherwise
+  // all snapshots are zeroed
+  bool isap_instr_enabled() { return isap_instr::enabled; }
+
+  // Fills instrumentation counters, aggregated over all threads of process,
+  // into snapshot, which is laid out as following ( all fields are uint64_t )
+  //
+  // perm_calls[2]  : permutation invocations, indexed by {Ascon-p, Keccak-p}
+  // perm_rounds[2] : permutation rounds executed, indexed by {Ascon-p, Keccak-p}
+  // absorbed[3]    : bytes absorbed, indexed by {rekeying, enc, mac} sponges
+  // squeezed[3]    : bytes squeezed, indexed by {rekeying, enc, mac} sponges
+  // latency[2][64] : log2 ns latency histogram, indexed by {encrypt, decrypt}
+  void isap_instr_snapshot(isap_instr::snapshot_t* const snap)
+  {
+    *snap = isap_instr::snapshot();
+  }
+
+  // Fills instrumentation counters of calling thread into snapshot, which is
+  // laid out same as above
+  void isap_instr_thread_snapshot(isap_instr::snapshot_t* const snap)
+  {
+    *snap = isap_instr::thread_snapshot();
+  }
+
+  // Resets instrumentation counters of calling thread to zero
+  void isap_instr_reset() { isap_instr::reset(); }
 }
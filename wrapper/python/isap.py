@@ -11,7 +11,7 @@
   Project: https://github.com/itzmeanjan/isap
 '''
 
-from typing import Tuple
+from typing import List, Tuple
 import ctypes as ct
 import numpy as np
 from posixpath import exists, abspath
@@ -25,6 +25,8 @@ u8 = np.uint8
 len_t = ct.c_size_t
 uint8_tp = np.ctypeslib.ndpointer(dtype=u8, ndim=1, flags='CONTIGUOUS')
 bool_t = ct.c_bool
+len_tp = np.ctypeslib.ndpointer(dtype=np.uintp, ndim=1, flags='CONTIGUOUS')
+bool_tp = np.ctypeslib.ndpointer(dtype=np.bool_, ndim=1, flags='CONTIGUOUS')
 
 
 def isap_a_128a_encrypt(
@@ -98,6 +100,73 @@ def isap_a_128a_decrypt(
     return f, dec_
 
 
+def isap_a_128a_verify(
+    key: bytes, nonce: bytes, tag: bytes, data: bytes, enc: bytes
+) -> bool:
+    """
+    Verifies M ( >=0 ) -many cipher text bytes, consuming 16 -bytes secret key,
+    16 -bytes public message nonce, 16 -bytes authentication tag & N ( >=0 ) -bytes
+    associated data, without decrypting them, while producing boolean flag denoting
+    verification status
+    """
+    assert len(key) == 16, "ISAP-A-128A takes 16 -bytes secret key !"
+    assert len(nonce) == 16, "ISAP-A-128A takes 16 -bytes nonce !"
+    assert len(tag) == 16, "ISAP-A-128A takes 16 -bytes authentication tag !"
+
+    ad_len = len(data)
+    ct_len = len(enc)
+
+    key_ = np.frombuffer(key, dtype=u8)
+    nonce_ = np.frombuffer(nonce, dtype=u8)
+    tag_ = np.frombuffer(tag, dtype=u8)
+    data_ = np.frombuffer(data, dtype=u8)
+    enc_ = np.frombuffer(enc, dtype=u8)
+
+    args = [uint8_tp, uint8_tp, uint8_tp, uint8_tp, len_t, uint8_tp, len_t]
+    SO_LIB.isap_a_128a_verify.argtypes = args
+    SO_LIB.isap_a_128a_verify.restype = bool_t
+
+    f = SO_LIB.isap_a_128a_verify(key_, nonce_, tag_, data_, ad_len, enc_, ct_len)
+
+    return f
+
+
+def isap_a_128a_verify_batch(
+    key: bytes, msgs: List[Tuple[bytes, bytes, bytes, bytes]]
+) -> List[bool]:
+    """
+    Verifies K ( >=0 ) -many messages, each given as ( 16 -bytes nonce, 16 -bytes
+    authentication tag, associated data, cipher text ), all under same 16 -bytes
+    secret key, without decrypting them, while producing K boolean flags denoting
+    verification status of respective message
+    """
+    assert len(key) == 16, "ISAP-A-128A takes 16 -bytes secret key !"
+    for nonce, tag, _, _ in msgs:
+        assert len(nonce) == 16, "ISAP-A-128A takes 16 -bytes nonce !"
+        assert len(tag) == 16, "ISAP-A-128A takes 16 -bytes authentication tag !"
+
+    cnt = len(msgs)
+
+    key_ = np.frombuffer(key, dtype=u8)
+    nonces = np.frombuffer(b"".join(m[0] for m in msgs), dtype=u8)
+    tags = np.frombuffer(b"".join(m[1] for m in msgs), dtype=u8)
+    data = np.frombuffer(b"".join(m[2] for m in msgs), dtype=u8)
+    ad_lens = np.array([len(m[2]) for m in msgs], dtype=np.uintp)
+    enc = np.frombuffer(b"".join(m[3] for m in msgs), dtype=u8)
+    ct_lens = np.array([len(m[3]) for m in msgs], dtype=np.uintp)
+    flags = np.zeros(cnt, dtype=np.bool_)
+
+    args = [uint8_tp, uint8_tp, uint8_tp, uint8_tp,
+            len_tp, uint8_tp, len_tp, len_t, bool_tp]
+    SO_LIB.isap_a_128a_verify_batch.argtypes = args
+    SO_LIB.isap_a_128a_verify_batch.restype = len_t
+
+    SO_LIB.isap_a_128a_verify_batch(key_, nonces, tags, data,
+                                    ad_lens, enc, ct_lens, cnt, flags)
+
+    return [bool(f) for f in flags]
+
+
 def isap_a_128_encrypt(
     key: bytes, nonce: bytes, data: bytes, text: bytes
 ) -> Tuple[bytes, bytes]:
@@ -169,6 +238,73 @@ def isap_a_128_decrypt(
     return f, dec_
 
 
+def isap_a_128_verify(
+    key: bytes, nonce: bytes, tag: bytes, data: bytes, enc: bytes
+) -> bool:
+    """
+    Verifies M ( >=0 ) -many cipher text bytes, consuming 16 -bytes secret key,
+    16 -bytes public message nonce, 16 -bytes authentication tag & N ( >=0 ) -bytes
+    associated data, without decrypting them, while producing boolean flag denoting
+    verification status
+    """
+    assert len(key) == 16, "ISAP-A-128 takes 16 -bytes secret key !"
+    assert len(nonce) == 16, "ISAP-A-128 takes 16 -bytes nonce !"
+    assert len(tag) == 16, "ISAP-A-128 takes 16 -bytes authentication tag !"
+
+    ad_len = len(data)
+    ct_len = len(enc)
+
+    key_ = np.frombuffer(key, dtype=u8)
+    nonce_ = np.frombuffer(nonce, dtype=u8)
+    tag_ = np.frombuffer(tag, dtype=u8)
+    data_ = np.frombuffer(data, dtype=u8)
+    enc_ = np.frombuffer(enc, dtype=u8)
+
+    args = [uint8_tp, uint8_tp, uint8_tp, uint8_tp, len_t, uint8_tp, len_t]
+    SO_LIB.isap_a_128_verify.argtypes = args
+    SO_LIB.isap_a_128_verify.restype = bool_t
+
+    f = SO_LIB.isap_a_128_verify(key_, nonce_, tag_, data_, ad_len, enc_, ct_len)
+
+    return f
+
+
+def isap_a_128_verify_batch(
+    key: bytes, msgs: List[Tuple[bytes, bytes, bytes, bytes]]
+) -> List[bool]:
+    """
+    Verifies K ( >=0 ) -many messages, each given as ( 16 -bytes nonce, 16 -bytes
+    authentication tag, associated data, cipher text ), all under same 16 -bytes
+    secret key, without decrypting them, while producing K boolean flags denoting
+    verification status of respective message
+    """
+    assert len(key) == 16, "ISAP-A-128 takes 16 -bytes secret key !"
+    for nonce, tag, _, _ in msgs:
+        assert len(nonce) == 16, "ISAP-A-128 takes 16 -bytes nonce !"
+        assert len(tag) == 16, "ISAP-A-128 takes 16 -bytes authentication tag !"
+
+    cnt = len(msgs)
+
+    key_ = np.frombuffer(key, dtype=u8)
+    nonces = np.frombuffer(b"".join(m[0] for m in msgs), dtype=u8)
+    tags = np.frombuffer(b"".join(m[1] for m in msgs), dtype=u8)
+    data = np.frombuffer(b"".join(m[2] for m in msgs), dtype=u8)
+    ad_lens = np.array([len(m[2]) for m in msgs], dtype=np.uintp)
+    enc = np.frombuffer(b"".join(m[3] for m in msgs), dtype=u8)
+    ct_lens = np.array([len(m[3]) for m in msgs], dtype=np.uintp)
+    flags = np.zeros(cnt, dtype=np.bool_)
+
+    args = [uint8_tp, uint8_tp, uint8_tp, uint8_tp,
+            len_tp, uint8_tp, len_tp, len_t, bool_tp]
+    SO_LIB.isap_a_128_verify_batch.argtypes = args
+    SO_LIB.isap_a_128_verify_batch.restype = len_t
+
+    SO_LIB.isap_a_128_verify_batch(key_, nonces, tags, data,
+                                   ad_lens, enc, ct_lens, cnt, flags)
+
+    return [bool(f) for f in flags]
+
+
 def isap_k_128a_encrypt(
     key: bytes, nonce: bytes, data: bytes, text: bytes
 ) -> Tuple[bytes, bytes]:
@@ -240,6 +376,73 @@ def isap_k_128a_decrypt(
     return f, dec_
 
 
+def isap_k_128a_verify(
+    key: bytes, nonce: bytes, tag: bytes, data: bytes, enc: bytes
+) -> bool:
+    """
+    Verifies M ( >=0 ) -many cipher text bytes, consuming 16 -bytes secret key,
+    16 -bytes public message nonce, 16 -bytes authentication tag & N ( >=0 ) -bytes
+    associated data, without decrypting them, while producing boolean flag denoting
+    verification status
+    """
+    assert len(key) == 16, "ISAP-K-128A takes 16 -bytes secret key !"
+    assert len(nonce) == 16, "ISAP-K-128A takes 16 -bytes nonce !"
+    assert len(tag) == 16, "ISAP-K-128A takes 16 -bytes authentication tag !"
+
+    ad_len = len(data)
+    ct_len = len(enc)
+
+    key_ = np.frombuffer(key, dtype=u8)
+    nonce_ = np.frombuffer(nonce, dtype=u8)
+    tag_ = np.frombuffer(tag, dtype=u8)
+    data_ = np.frombuffer(data, dtype=u8)
+    enc_ = np.frombuffer(enc, dtype=u8)
+
+    args = [uint8_tp, uint8_tp, uint8_tp, uint8_tp, len_t, uint8_tp, len_t]
+    SO_LIB.isap_k_128a_verify.argtypes = args
+    SO_LIB.isap_k_128a_verify.restype = bool_t
+
+    f = SO_LIB.isap_k_128a_verify(key_, nonce_, tag_, data_, ad_len, enc_, ct_len)
+
+    return f
+
+
+def isap_k_128a_verify_batch(
+    key: bytes, msgs: List[Tuple[bytes, bytes, bytes, bytes]]
+) -> List[bool]:
+    """
+    Verifies K ( >=0 ) -many messages, each given as ( 16 -bytes nonce, 16 -bytes
+    authentication tag, associated data, cipher text ), all under same 16 -bytes
+    secret key, without decrypting them, while producing K boolean flags denoting
+    verification status of respective message
+    """
+    assert len(key) == 16, "ISAP-K-128A takes 16 -bytes secret key !"
+    for nonce, tag, _, _ in msgs:
+        assert len(nonce) == 16, "ISAP-K-128A takes 16 -bytes nonce !"
+        assert len(tag) == 16, "ISAP-K-128A takes 16 -bytes authentication tag !"
+
+    cnt = len(msgs)
+
+    key_ = np.frombuffer(key, dtype=u8)
+    nonces = np.frombuffer(b"".join(m[0] for m in msgs), dtype=u8)
+    tags = np.frombuffer(b"".join(m[1] for m in msgs), dtype=u8)
+    data = np.frombuffer(b"".join(m[2] for m in msgs), dtype=u8)
+    ad_lens = np.array([len(m[2]) for m in msgs], dtype=np.uintp)
+    enc = np.frombuffer(b"".join(m[3] for m in msgs), dtype=u8)
+    ct_lens = np.array([len(m[3]) for m in msgs], dtype=np.uintp)
+    flags = np.zeros(cnt, dtype=np.bool_)
+
+    args = [uint8_tp, uint8_tp, uint8_tp, uint8_tp,
+            len_tp, uint8_tp, len_tp, len_t, bool_tp]
+    SO_LIB.isap_k_128a_verify_batch.argtypes = args
+    SO_LIB.isap_k_128a_verify_batch.restype = len_t
+
+    SO_LIB.isap_k_128a_verify_batch(key_, nonces, tags, data,
+                                    ad_lens, enc, ct_lens, cnt, flags)
+
+    return [bool(f) for f in flags]
+
+
 def isap_k_128_encrypt(
     key: bytes, nonce: bytes, data: bytes, text: bytes
 ) -> Tuple[bytes, bytes]:
@@ -311,5 +514,118 @@ def isap_k_128_decrypt(
     return f, dec_
 
 
+def isap_k_128_verify(
+    key: bytes, nonce: bytes, tag: bytes, data: bytes, enc: bytes
+) -> bool:
+    """
+    Verifies M ( >=0 ) -many cipher text bytes, consuming 16 -bytes secret key,
+    16 -bytes public message nonce, 16 -bytes authentication tag & N ( >=0 ) -bytes
+    associated data, without decrypting them, while producing boolean flag denoting
+    verification status
+    """
+    assert len(key) == 16, "ISAP-K-128 takes 16 -bytes secret key !"
+    assert len(nonce) == 16, "ISAP-K-128 takes 16 -bytes nonce !"
+    assert len(tag) == 16, "ISAP-K-128 takes 16 -bytes authentication tag !"
+
+    ad_len = len(data)
+    ct_len = len(enc)
+
+    key_ = np.frombuffer(key, dtype=u8)
+    nonce_ = np.frombuffer(nonce, dtype=u8)
+    tag_ = np.frombuffer(tag, dtype=u8)
+    data_ = np.frombuffer(data, dtype=u8)
+    enc_ = np.frombuffer(enc, dtype=u8)
+
+    args = [uint8_tp, uint8_tp, uint8_tp, uint8_tp, len_t, uint8_tp, len_t]
+    SO_LIB.isap_k_128_verify.argtypes = args
+    SO_LIB.isap_k_128_verify.restype = bool_t
+
+    f = SO_LIB.isap_k_128_verify(key_, nonce_, tag_, data_, ad_len, enc_, ct_len)
+
+    return f
+
+
+def isap_k_128_verify_batch(
+    key: bytes, msgs: List[Tuple[bytes, bytes, bytes, bytes]]
+) -> List[bool]:
+    """
+    Verifies K ( >=0 ) -many messages, each given as ( 16 -bytes nonce, 16 -bytes
+    authentication tag, associated data, cipher text ), all under same 16 -bytes
+    secret key, without decrypting them, while producing K boolean flags denoting
+    verification status of respective message
+    """
+    assert len(key) == 16, "ISAP-K-128 takes 16 -bytes secret key !"
+    for nonce, tag, _, _ in msgs:
+        assert len(nonce) == 16, "ISAP-K-128 takes 16 -bytes nonce !"
+        assert len(tag) == 16, "ISAP-K-128 takes 16 -bytes authentication tag !"
+
+    cnt = len(msgs)
+
+    key_ = np.frombuffer(key, dtype=u8)
+    nonces = np.frombuffer(b"".join(m[0] for m in msgs), dtype=u8)
+    tags = np.frombuffer(b"".join(m[1] for m in msgs), dtype=u8)
+    data = np.frombuffer(b"".join(m[2] for m in msgs), dtype=u8)
+    ad_lens = np.array([len(m[2]) for m in msgs], dtype=np.uintp)
+    enc = np.frombuffer(b"".join(m[3] for m in msgs), dtype=u8)
+    ct_lens = np.array([len(m[3]) for m in msgs], dtype=np.uintp)
+    flags = np.zeros(cnt, dtype=np.bool_)
+
+    args = [uint8_tp, uint8_tp, uint8_tp, uint8_tp,
+            len_tp, uint8_tp, len_tp, len_t, bool_tp]
+    SO_LIB.isap_k_128_verify_batch.argtypes = args
+    SO_LIB.isap_k_128_verify_batch.restype = len_t
+
+    SO_LIB.isap_k_128_verify_batch(key_, nonces, tags, data,
+                                   ad_lens, enc, ct_lens, cnt, flags)
+
+    return [bool(f) for f in flags]
+
+
+class instr_snapshot_t(ct.Structure):
+    """
+    Snapshot of instrumentation counters, laid out same as
+    `isap_instr::snapshot_t`, see include/instrument.hpp
+    """
+    _fields_ = [('perm_calls', ct.c_uint64 * 2),
+                ('perm_rounds', ct.c_uint64 * 2),
+                ('absorbed', ct.c_uint64 * 3),
+                ('squeezed', ct.c_uint64 * 3),
+                ('latency', (ct.c_uint64 * 64) * 2)]
+
+
+def isap_instr_enabled() -> bool:
+    """
+    Returns truth value, if shared library object was compiled with
+    instrumentation enabled, otherwise all snapshots are zeroed
+    """
+    SO_LIB.isap_instr_enabled.restype = bool_t
+    return bool(SO_LIB.isap_instr_enabled())
+
+
+def isap_instr_snapshot() -> instr_snapshot_t:
+    """
+    Returns instrumentation counters, aggregated over all threads of process
+    """
+    snap = instr_snapshot_t()
+    SO_LIB.isap_instr_snapshot(ct.byref(snap))
+    return snap
+
+
+def isap_instr_thread_snapshot() -> instr_snapshot_t:
+    """
+    Returns instrumentation counters of calling thread
+    """
+    snap = instr_snapshot_t()
+    SO_LIB.isap_instr_thread_snapshot(ct.byref(snap))
+    return snap
+
+
+def isap_instr_reset():
+    """
+    Resets instrumentation counters of calling thread to zero
+    """
+    SO_LIB.isap_instr_reset()
+
+
 if __name__ == '__main__':
     print("Use `isap` as library module !")
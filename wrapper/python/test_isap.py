@@ -1,5 +1,6 @@
 #!/usr/bin/python3
 
+import ctypes as ct
 import isap
 import numpy as np
 
@@ -266,5 +267,222 @@ def test_isap_k_128_aead_kat():
             fd.readline()
 
 
+def read_kats():
+    """
+    Reads Known Answer Tests from `LWC_AEAD_KAT_128_128.txt`, yielding count,
+    secret key, nonce, plain text, associated data & cipher text ( followed by
+    authentication tag ) of each, in order
+    """
+    with open("LWC_AEAD_KAT_128_128.txt", "r") as fd:
+        kat = {}
+        for line in fd:
+            if "=" not in line:
+                continue
+
+            name, val = [i.strip() for i in line.split("=")]
+            kat[name] = val
+
+            if name == "CT":
+                yield (
+                    int(kat["Count"]),
+                    bytes.fromhex(kat["Key"]),
+                    bytes.fromhex(kat["Nonce"]),
+                    bytes.fromhex(kat["PT"]),
+                    bytes.fromhex(kat["AD"]),
+                    bytes.fromhex(kat["CT"]),
+                )
+                kat = {}
+
+
+def check_verify_kat(name, verify, verify_batch):
+    """
+    Checks that verify-only routine accepts cipher text & tag of each Known
+    Answer Test, while rejecting it when either tag, cipher text or associated
+    data is tampered with. Then all Known Answer Tests sharing first one's secret
+    key are verified as a single batch, with every other one tampered with.
+    """
+    kats = list(read_kats())
+    assert len(kats) > 0, f"[{name}] no Known Answer Test found !"
+
+    for cnt, key, nonce, _, ad, ct in kats:
+        cipher, tag = ct[:-16], ct[-16:]
+
+        assert verify(key, nonce, tag, ad, cipher), \
+            f"[{name} KAT {cnt}] expected tag to be verified !"
+
+        tag_ = bytes([tag[0] ^ 1]) + tag[1:]
+        assert not verify(key, nonce, tag_, ad, cipher), \
+            f"[{name} KAT {cnt}] expected tampered tag to be rejected !"
+
+        if len(cipher) > 0:
+            cipher_ = cipher[:-1] + bytes([cipher[-1] ^ 0x80])
+            assert not verify(key, nonce, tag, ad, cipher_), \
+                f"[{name} KAT {cnt}] expected tampered cipher to be rejected !"
+
+        if len(ad) > 0:
+            ad_ = bytes([ad[0] ^ 0x10]) + ad[1:]
+            assert not verify(key, nonce, tag, ad_, cipher), \
+                f"[{name} KAT {cnt}] expected tampered data to be rejected !"
+
+    key = kats[0][1]
+    msgs = []
+    expected = []
+    for i, (_, key_, nonce, _, ad, ct) in enumerate(kats):
+        if key_ != key:
+            continue
+
+        tag = ct[-16:]
+        if i & 1:
+            tag = bytes([tag[0] ^ 0x40]) + tag[1:]
+
+        msgs.append((nonce, tag, ad, ct[:-16]))
+        expected.append(not (i & 1))
+
+    assert verify_batch(key, msgs) == expected, \
+        f"[{name}] batch verification differs from expected flags !"
+    assert verify_batch(key, []) == []
+
+
+def test_isap_a_128a_aead_verify_kat():
+    """
+    Tests verify-only routine of ISAP-A-128A, using Known Answer Tests
+    """
+    check_verify_kat("ISAP-A-128A", isap.isap_a_128a_verify,
+                     isap.isap_a_128a_verify_batch)
+
+
+def test_isap_a_128_aead_verify_kat():
+    """
+    Tests verify-only routine of ISAP-A-128, using Known Answer Tests
+    """
+    check_verify_kat("ISAP-A-128", isap.isap_a_128_verify,
+                     isap.isap_a_128_verify_batch)
+
+
+def test_isap_k_128a_aead_verify_kat():
+    """
+    Tests verify-only routine of ISAP-K-128A, using Known Answer Tests
+    """
+    check_verify_kat("ISAP-K-128A", isap.isap_k_128a_verify,
+                     isap.isap_k_128a_verify_batch)
+
+
+def test_isap_k_128_aead_verify_kat():
+    """
+    Tests verify-only routine of ISAP-K-128, using Known Answer Tests
+    """
+    check_verify_kat("ISAP-K-128", isap.isap_k_128_verify,
+                     isap.isap_k_128_verify_batch)
+
+
+def test_isap_in_place():
+    """
+    Tests that encryption/ decryption can be performed in-place i.e. when same
+    buffer is passed as both plain text & cipher text, for all four variants,
+    while result must be same as out-of-place encryption
+    """
+    import os
+
+    variants = [
+        ("isap_a_128a", isap.isap_a_128a_encrypt),
+        ("isap_a_128", isap.isap_a_128_encrypt),
+        ("isap_k_128a", isap.isap_k_128a_encrypt),
+        ("isap_k_128", isap.isap_k_128_encrypt),
+    ]
+
+    for name, encrypt in variants:
+        enc_fn = getattr(isap.SO_LIB, f"{name}_encrypt")
+        dec_fn = getattr(isap.SO_LIB, f"{name}_decrypt")
+
+        enc_fn.argtypes = [isap.uint8_tp, isap.uint8_tp, isap.uint8_tp, isap.len_t,
+                           isap.uint8_tp, isap.uint8_tp, isap.len_t, isap.uint8_tp]
+        dec_fn.argtypes = [isap.uint8_tp, isap.uint8_tp, isap.uint8_tp, isap.uint8_tp,
+                           isap.len_t, isap.uint8_tp, isap.uint8_tp, isap.len_t]
+        dec_fn.restype = isap.bool_t
+
+        for mlen in [0, 1, 7, 8, 17, 18, 19, 64, 257]:
+            key = os.urandom(16)
+            nonce = os.urandom(16)
+            data = os.urandom(13)
+            text = os.urandom(mlen)
+
+            cipher, tag = encrypt(key, nonce, data, text)
+
+            key_ = np.frombuffer(key, dtype=u8)
+            nonce_ = np.frombuffer(nonce, dtype=u8)
+            data_ = np.frombuffer(data, dtype=u8)
+            buf = np.frombuffer(bytearray(text), dtype=u8)
+            tag_ = np.empty(16, dtype=u8)
+
+            enc_fn(key_, nonce_, data_, len(data), buf, buf, mlen, tag_)
+            assert buf.tobytes() == cipher and tag_.tobytes() == tag, \
+                f"[{name}] in-place encryption differs for {mlen} -bytes"
+
+            flag = dec_fn(key_, nonce_, tag_, data_, len(data), buf, buf, mlen)
+            assert flag and buf.tobytes() == text, \
+                f"[{name}] in-place decryption differs for {mlen} -bytes"
+
+
+def test_isap_instr():
+    """
+    Tests instrumentation counters, exposed through C ABI, i.e. # -of
+    permutation rounds executed by encrypt/ decrypt routines of all four
+    variants must match cost model ( see include/cost.hpp ), while reset must
+    zero them. When shared library object is built without instrumentation,
+    snapshots must stay zeroed.
+    """
+    import os
+
+    # name, permutation index, rate, s_b, s_k, s_e, s_h
+    variants = [
+        ("isap_a_128a", 0, 8, 1, 12, 6, 12),
+        ("isap_a_128", 0, 8, 12, 12, 12, 12),
+        ("isap_k_128a", 1, 18, 1, 8, 8, 16),
+        ("isap_k_128", 1, 18, 12, 12, 12, 20),
+    ]
+
+    enabled = isap.isap_instr_enabled()
+
+    def zeroed(snap):
+        return bytes(snap) == bytes(ct.sizeof(snap))
+
+    for name, perm, rate, s_b, s_k, s_e, s_h in variants:
+        encrypt = getattr(isap, f"{name}_encrypt")
+        decrypt = getattr(isap, f"{name}_decrypt")
+
+        rk = s_k + 127 * s_b + s_k
+
+        for dlen, mlen in [(0, 0), (0, 1), (16, 32), (37, 19), (64, 255)]:
+            key = os.urandom(16)
+            nonce = os.urandom(16)
+            data = os.urandom(dlen)
+            text = os.urandom(mlen)
+
+            enc = rk + -(-mlen // rate) * s_e if mlen > 0 else 0
+            mac = s_h + (dlen // rate + 1 + mlen // rate + 1) * s_h + rk + s_h
+            rounds = enc + mac if enabled else 0
+
+            isap.isap_instr_reset()
+            cipher, tag = encrypt(key, nonce, data, text)
+
+            snap = isap.isap_instr_thread_snapshot()
+            assert snap.perm_rounds[perm] == rounds, \
+                f"[{name}] encrypt rounds differ for {dlen}/{mlen} -bytes"
+            assert snap.perm_rounds[perm ^ 1] == 0
+
+            flag, _ = decrypt(key, nonce, tag, data, cipher)
+            assert flag
+
+            snap = isap.isap_instr_snapshot()
+            assert snap.perm_rounds[perm] >= rounds * 2, \
+                f"[{name}] process-wide rounds differ for {dlen}/{mlen} -bytes"
+
+            isap.isap_instr_reset()
+            assert zeroed(isap.isap_instr_thread_snapshot())
+
+            if not enabled:
+                assert zeroed(isap.isap_instr_snapshot())
+
+
 if __name__ == '__main__':
     print("Execute ISAP Known Answer Tests using `pytest` !")
@@ -0,0 +1,320 @@
+#!/usr/bin/python3
+
+import isap
+import os
+import subprocess
+import pytest
+from posixpath import exists, abspath
+
+BIN_PATH: str = abspath('../../tools/isap-file')
+
+KEY = bytes(range(16))
+NONCE = bytes(range(16, 32))
+
+HDR_LEN = 32
+TAG_LEN = 16
+
+VARIANTS = {
+    "a-128a": (1, isap.isap_a_128a_encrypt),
+    "a-128": (2, isap.isap_a_128_encrypt),
+    "k-128a": (3, isap.isap_k_128a_encrypt),
+    "k-128": (4, isap.isap_k_128_encrypt),
+}
+
+
+def run(*args) -> subprocess.CompletedProcess:
+    """
+    Invokes `isap-file` command-line tool with given arguments
+    """
+    assert exists(BIN_PATH), 'Use `make tools/isap-file` to build command-line tool !'
+    return subprocess.run([BIN_PATH, *map(str, args)], capture_output=True)
+
+
+def encrypt_file(tmp_path, text: bytes, variant: str, chunk: int, threads: int = 0) -> bytes:
+    """
+    Encrypts given bytes using chunked encryption format, returning encrypted bytes
+    """
+    src = tmp_path / "plain.bin"
+    dst = tmp_path / "enc.bin"
+    src.write_bytes(text)
+
+    res = run("encrypt", "-k", KEY.hex(), "-n", NONCE.hex(), "-v", variant,
+              "-c", chunk, "-t", threads, src, dst)
+    assert res.returncode == 0, res.stderr
+    return dst.read_bytes()
+
+
+def decrypt_file(tmp_path, enc: bytes, threads: int = 0):
+    """
+    Decrypts given bytes using chunked encryption format, returning boolean
+    verification flag along with decrypted bytes ( if verified )
+    """
+    src = tmp_path / "enc.bin"
+    dst = tmp_path / "dec.bin"
+    src.write_bytes(enc)
+
+    res = run("decrypt", "-k", KEY.hex(), "-t", threads, src, dst)
+    if res.returncode != 0:
+        assert not exists(dst), "unverified plain text must not be released !"
+        return False, b""
+    return True, dst.read_bytes()
+
+
+def chunk_nonce(idx: int) -> bytes:
+    """
+    Derives nonce of chunk i.e. file nonce ^ ( 64 -bit big-endian chunk index )
+    """
+    tail = int.from_bytes(NONCE[8:], "big") ^ idx
+    return NONCE[:8] + tail.to_bytes(8, "big")
+
+
+@pytest.mark.parametrize("variant", VARIANTS.keys())
+@pytest.mark.parametrize("mlen", [0, 1, 63, 64, 65, 1000])
+def test_isap_file_bit_exact(tmp_path, variant, mlen):
+    """
+    Tests that each chunk of encrypted file is bit-exactly same as what's
+    computed by ISAP AEAD, using derived nonce & associated data
+    """
+    chunk = 64
+    vid, encrypt = VARIANTS[variant]
+    text = os.urandom(mlen)
+    enc = encrypt_file(tmp_path, text, variant, chunk)
+
+    hdr = b"ISAPCHK1" + bytes([vid, 0, 0, 0]) + \
+        chunk.to_bytes(4, "little") + NONCE
+    cnt = max(1, (mlen + chunk - 1) // chunk)
+
+    expected = hdr
+    for i in range(cnt):
+        ad = hdr + i.to_bytes(8, "little") + bytes([i == cnt - 1])
+        cipher, tag = encrypt(
+            KEY, chunk_nonce(i), ad, text[i * chunk: (i + 1) * chunk])
+        expected += cipher + tag
+
+    assert enc == expected, f"[{variant}] encrypted file differs for {mlen} -bytes"
+
+    flag, dec = decrypt_file(tmp_path, enc)
+    assert flag and dec == text
+
+
+@pytest.mark.parametrize("threads", [1, 4])
+def test_isap_file_roundtrip(tmp_path, threads):
+    """
+    Tests that decrypting encrypted file gives back original bytes, for
+    different file lengths around chunk boundaries
+    """
+    chunk = 4096
+    for mlen in [0, 1, chunk - 1, chunk, chunk + 1, 7 * chunk + 5]:
+        text = os.urandom(mlen)
+        enc = encrypt_file(tmp_path, text, "a-128a", chunk, threads)
+
+        assert len(enc) == HDR_LEN + mlen + \
+            max(1, (mlen + chunk - 1) // chunk) * TAG_LEN
+
+        flag, dec = decrypt_file(tmp_path, enc, threads)
+        assert flag and dec == text
+
+
+def test_isap_file_truncation(tmp_path):
+    """
+    Tests that truncated encrypted files are rejected, both when truncated at
+    chunk boundary and in middle of chunk
+    """
+    chunk = 256
+    rlen = chunk + TAG_LEN
+    enc = encrypt_file(tmp_path, os.urandom(4 * chunk), "k-128a", chunk)
+
+    # drop last chunk(s), at chunk boundary
+    for cnt in [1, 2, 3]:
+        assert not decrypt_file(tmp_path, enc[:HDR_LEN + cnt * rlen])[0]
+
+    # drop few trailing bytes
+    for drop in [1, TAG_LEN, rlen - 1]:
+        assert not decrypt_file(tmp_path, enc[:-drop])[0]
+
+    # drop everything but header
+    assert not decrypt_file(tmp_path, enc[:HDR_LEN])[0]
+
+
+def test_isap_file_extension(tmp_path):
+    """
+    Tests that encrypted files with appended bytes are rejected, including
+    when a lone tag-sized trailer is appended to a file, whose plain text
+    length is a multiple of chunk length
+    """
+    chunk = 4096
+    for mlen in [2 * chunk, 2 * chunk + 1, chunk, 0]:
+        enc = encrypt_file(tmp_path, os.urandom(mlen), "a-128a", chunk)
+        assert decrypt_file(tmp_path, enc)[0]
+        (tmp_path / "dec.bin").unlink()
+
+        for extra in [1, TAG_LEN - 1, TAG_LEN, TAG_LEN + 1, chunk + TAG_LEN]:
+            assert not decrypt_file(tmp_path, enc + os.urandom(extra))[0], \
+                f"{extra} -bytes appended to {mlen} -bytes file accepted"
+
+
+def test_isap_file_reorder(tmp_path):
+    """
+    Tests that encrypted files with reordered or duplicated chunks are rejected
+    """
+    chunk = 256
+    rlen = chunk + TAG_LEN
+    enc = encrypt_file(tmp_path, os.urandom(4 * chunk), "a-128", chunk)
+
+    hdr = enc[:HDR_LEN]
+    recs = [enc[HDR_LEN + i * rlen: HDR_LEN + (i + 1) * rlen]
+            for i in range(4)]
+
+    assert decrypt_file(tmp_path, hdr + b"".join(recs))[0]
+    assert not decrypt_file(tmp_path, hdr + b"".join(
+        [recs[1], recs[0], recs[2], recs[3]]))[0]
+    assert not decrypt_file(tmp_path, hdr + b"".join(
+        [recs[0], recs[1], recs[3], recs[2]]))[0]
+    assert not decrypt_file(tmp_path, hdr + b"".join(
+        [recs[0], recs[0], recs[2], recs[3]]))[0]
+
+
+def test_isap_file_tamper(tmp_path):
+    """
+    Tests that flipping any bit of header, cipher text or tag is detected
+    """
+    chunk = 64
+    enc = encrypt_file(tmp_path, os.urandom(3 * chunk), "k-128", chunk)
+
+    for off in [0, 8, 12, 20, HDR_LEN, HDR_LEN + chunk, len(enc) - 1]:
+        bad = bytearray(enc)
+        bad[off] ^= 1
+        assert not decrypt_file(tmp_path, bytes(bad))[0], f"flipped byte {off}"
+
+
+def archive_file(tmp_path, text: bytes, variant: str, chunk: int) -> bytes:
+    """
+    Encrypts given bytes as random-access archive, returning archive bytes
+    """
+    src = tmp_path / "plain.bin"
+    dst = tmp_path / "archive.bin"
+    src.write_bytes(text)
+
+    res = run("archive", "-k", KEY.hex(), "-n", NONCE.hex(), "-v", variant,
+              "-c", chunk, src, dst)
+    assert res.returncode == 0, res.stderr
+    return dst.read_bytes()
+
+
+def extract_range(tmp_path, arc: bytes, off: int, length: int):
+    """
+    Extracts given byte range out of archive, returning boolean verification
+    flag along with extracted bytes ( if verified )
+    """
+    src = tmp_path / "archive.bin"
+    dst = tmp_path / "range.bin"
+    src.write_bytes(arc)
+    if exists(dst):
+        os.remove(dst)
+
+    res = run("extract", "-k", KEY.hex(), "-o", off, "-l", length, src, dst)
+    if res.returncode != 0:
+        assert not exists(dst), "unverified plain text must not be released !"
+        return False, b""
+    return True, dst.read_bytes()
+
+
+@pytest.mark.parametrize("variant", VARIANTS.keys())
+def test_isap_file_archive_range(tmp_path, variant):
+    """
+    Tests that any byte range, extracted out of random-access archive, matches
+    respective range of original bytes
+    """
+    chunk = 100
+    text = os.urandom(10 * chunk + 37)
+    arc = archive_file(tmp_path, text, variant, chunk)
+
+    ranges = [(0, 0), (0, 1), (0, len(text)), (chunk - 1, 2), (chunk, chunk),
+              (250, 333), (len(text) - 1, 1), (len(text), 0)]
+    for off, length in ranges:
+        flag, dec = extract_range(tmp_path, arc, off, length)
+        assert flag and dec == text[off: off + length], f"range {off}+{length}"
+
+    # ranges beyond end of message are rejected
+    assert not extract_range(tmp_path, arc, len(text), 1)[0]
+    assert not extract_range(tmp_path, arc, 10, len(text))[0]
+
+    # ranges beyond end of archive are rejected, before any allocation
+    for off, length in [(0, 1 << 62), (1 << 62, 1), (len(arc), 1),
+                        ((1 << 64) - 1, 1), (1, (1 << 64) - 1)]:
+        res = run("extract", "-k", KEY.hex(), "-o", off, "-l", length,
+                  tmp_path / "archive.bin", tmp_path / "range.bin")
+        assert res.returncode != 0 and b"range out of bounds" in res.stderr, \
+            f"range {off}+{length}"
+        assert not exists(tmp_path / "range.bin")
+
+
+def test_isap_file_archive_tamper(tmp_path):
+    """
+    Tests that tampering with chunk covering requested range, footer index or
+    trailer is detected, while ranges not covering tampered chunk are still
+    readable, as only covering chunks are authenticated
+    """
+    chunk = 128
+    text = os.urandom(8 * chunk)
+    arc = archive_file(tmp_path, text, "a-128a", chunk)
+
+    # flip a bit of cipher text of chunk 5
+    bad = bytearray(arc)
+    bad[HDR_LEN + 5 * chunk + 7] ^= 1
+    bad = bytes(bad)
+
+    assert not extract_range(tmp_path, bad, 5 * chunk, 1)[0]
+    assert not extract_range(tmp_path, bad, 4 * chunk, 2 * chunk)[0]
+    assert extract_range(tmp_path, bad, 0, 5 * chunk) == (
+        True, text[:5 * chunk])
+
+    # flip a bit of each index entry & trailer
+    idx = HDR_LEN + len(text)
+    for off in [0, 8, 12, 27, 7 * 28 + 20]:
+        bad = bytearray(arc)
+        bad[idx + off] ^= 1
+        assert not extract_range(tmp_path, bytes(bad), 0, 1)[0]
+    for off in range(1, 33):
+        bad = bytearray(arc)
+        bad[-off] ^= 1
+        assert not extract_range(tmp_path, bytes(bad), 0, 1)[0]
+
+    # truncate archive
+    assert not extract_range(tmp_path, arc[:-1], 0, 1)[0]
+    assert not extract_range(tmp_path, arc[:HDR_LEN + len(text)], 0, 1)[0]
+
+
+@pytest.mark.parametrize("mlen", [0, 1, 4096, 3 * 4096, 3 * 4096 + 1])
+def test_isap_file_stream(tmp_path, mlen):
+    """
+    Tests that streaming I/O pipeline, reading plain text from a pipe, produces
+    bit-exactly same encrypted bytes as memory mapped chunked encryption
+    """
+    chunk = 4096
+    text = os.urandom(mlen)
+    enc = encrypt_file(tmp_path, text, "k-128a", chunk)
+
+    for bufs in [3, 8]:
+        res = subprocess.run([BIN_PATH, "stream", "-k", KEY.hex(), "-n", NONCE.hex(),
+                              "-v", "k-128a", "-c", str(chunk), "-b", str(bufs), "-", "-"],
+                             input=text, capture_output=True)
+        assert res.returncode == 0, res.stderr
+        assert res.stdout == enc, f"streamed encryption differs for {mlen} -bytes"
+
+
+def test_isap_file_stream_abort():
+    """
+    Tests that streaming I/O pipeline stops reading & fails, as soon as writes
+    start failing, even when input never ends
+    """
+    with open("/dev/zero", "rb") as src, open("/dev/full", "wb") as dst:
+        res = subprocess.run([BIN_PATH, "stream", "-k", KEY.hex(), "-n", NONCE.hex(),
+                              "-c", "4096", "-", "-"],
+                             stdin=src, stdout=dst, stderr=subprocess.PIPE, timeout=60)
+    assert res.returncode != 0
+    assert b"streaming encryption failed" in res.stderr
+
+
+if __name__ == "__main__":
+    print("Execute chunked file encryption tests using `pytest` !")